@@ -1,7 +1,25 @@
 ﻿#include "ThermoForge.h"
+#include "ThermoForgeStats.h"
 
 IMPLEMENT_MODULE(FThermoForgeModule, ThermoForge)
 
+DEFINE_LOG_CATEGORY(LogThermoForge);
+
+DEFINE_STAT(STAT_ThermoForge_Queries);
+DEFINE_STAT(STAT_ThermoForge_SourceEvals);
+DEFINE_STAT(STAT_ThermoForge_OcclusionTraces);
+DEFINE_STAT(STAT_ThermoForge_DensityCacheHits);
+DEFINE_STAT(STAT_ThermoForge_DensityCacheMisses);
+DEFINE_STAT(STAT_ThermoForge_ComposedCells);
+DEFINE_STAT(STAT_ThermoForge_BakeCellsPerSec);
+DEFINE_STAT(STAT_ThermoForge_LoadedChunks);
+DEFINE_STAT(STAT_ThermoForge_Watches);
+DEFINE_STAT(STAT_ThermoForge_FieldMemory);
+DEFINE_STAT(STAT_ThermoForge_Bake);
+DEFINE_STAT(STAT_ThermoForge_Query);
+DEFINE_STAT(STAT_ThermoForge_Composition);
+DEFINE_STAT(STAT_ThermoForge_Preview);
+
 // Called when the module is loaded into memory
 void FThermoForgeModule::StartupModule()
 {
@@ -0,0 +1,74 @@
+﻿#include "ThermoForgeClimateProfile.h"
+#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeDeterministicMath.h"
+
+FThermoForgeClimate FThermoForgeClimate::FromSettings(const UThermoForgeProjectSettings* S)
+{
+    FThermoForgeClimate C;
+    if (!S) return C;
+
+    C.WinterAverageC       = S->WinterAverageC;
+    C.SummerAverageC       = S->SummerAverageC;
+    C.WinterDayNightDeltaC = S->WinterDayNightDeltaC;
+    C.SummerDayNightDeltaC = S->SummerDayNightDeltaC;
+    C.SolarGainScaleC      = S->SolarGainScaleC;
+    C.LapseRateCPerKm      = S->bEnableAltitudeLapse ? S->LapseRateCPerKm : 0.f;
+    C.SeaLevelZcm          = S->SeaLevelZcm;
+    return C;
+}
+
+FThermoForgeClimate FThermoForgeClimate::Lerp(const FThermoForgeClimate& A, const FThermoForgeClimate& B, float Alpha)
+{
+    FThermoForgeClimate C;
+    C.WinterAverageC       = FMath::Lerp(A.WinterAverageC,       B.WinterAverageC,       Alpha);
+    C.SummerAverageC       = FMath::Lerp(A.SummerAverageC,       B.SummerAverageC,       Alpha);
+    C.WinterDayNightDeltaC = FMath::Lerp(A.WinterDayNightDeltaC, B.WinterDayNightDeltaC, Alpha);
+    C.SummerDayNightDeltaC = FMath::Lerp(A.SummerDayNightDeltaC, B.SummerDayNightDeltaC, Alpha);
+    C.SolarGainScaleC      = FMath::Lerp(A.SolarGainScaleC,      B.SolarGainScaleC,      Alpha);
+    C.LapseRateCPerKm      = FMath::Lerp(A.LapseRateCPerKm,      B.LapseRateCPerKm,      Alpha);
+    C.SeaLevelZcm          = FMath::Lerp(A.SeaLevelZcm,          B.SeaLevelZcm,          Alpha);
+    return C;
+}
+
+uint32 FThermoForgeClimate::PackBlend(uint8 A, uint8 B, float WeightB01)
+{
+    const uint32 W = (uint32)FMath::Clamp(FMath::RoundToInt(WeightB01 * 65535.f), 0, 65535);
+    return uint32(A) | (uint32(B) << 8) | (W << 16);
+}
+
+FThermoForgeClimate FThermoForgeClimate::UnpackBlend(uint32 Packed, TConstArrayView<FThermoForgeClimate> Palette)
+{
+    if (Palette.IsEmpty()) return FThermoForgeClimate();
+
+    const int32 A = FMath::Min<int32>(Packed & 0xFF, Palette.Num() - 1);
+    const int32 B = FMath::Min<int32>((Packed >> 8) & 0xFF, Palette.Num() - 1);
+    const uint32 W = Packed >> 16;
+    if (W == 0 || A == B) return Palette[A];
+    return Lerp(Palette[A], Palette[B], W / 65535.f);
+}
+
+float FThermoForgeClimate::GetAmbientCelsius(bool bWinter, float TimeOfDayHours, bool bDeterministic) const
+{
+    // Cosine curve: warmest ~15:00, coolest ~03:00
+    const float ClampedH = FMath::Clamp(TimeOfDayHours, 0.0f, 24.0f);
+    const float Phase    = (ClampedH - 15.0f) / 24.0f;   // shift so peak at 15:00
+    const float Osc      = bDeterministic ? FThermoForgeDeterministicMath::Cos(2.0f * PI * Phase)
+                                          : FMath::Cos(2.0f * PI * Phase); // -1..+1
+
+    const float Avg   = bWinter ? WinterAverageC       : SummerAverageC;
+    const float Delta = bWinter ? WinterDayNightDeltaC : SummerDayNightDeltaC;
+    return Avg + 0.5f * Delta * Osc;
+}
+
+FThermoForgeClimate UThermoForgeClimateProfile::MakeClimate(const UThermoForgeProjectSettings* S) const
+{
+    FThermoForgeClimate C;
+    C.WinterAverageC       = WinterAverageC;
+    C.SummerAverageC       = SummerAverageC;
+    C.WinterDayNightDeltaC = WinterDayNightDeltaC;
+    C.SummerDayNightDeltaC = SummerDayNightDeltaC;
+    C.SolarGainScaleC      = SolarGainScaleC;
+    C.LapseRateCPerKm      = bEnableAltitudeLapse ? LapseRateCPerKm : 0.f;
+    C.SeaLevelZcm          = S ? S->SeaLevelZcm : 0.f;
+    return C;
+}
@@ -0,0 +1,79 @@
+﻿#include "ThermoForgeDeterministicMath.h"
+
+namespace
+{
+    constexpr int32  TF_CosTableSize   = 4096;          // entries per turn
+    constexpr int32  TF_ExpTableSize   = 4096;
+    constexpr double TF_ExpTableRange  = 16.0;          // exp(-x), x in [0, 16]
+
+    // Series with only + and *, so the tables do not depend on the platform's libm
+    double TF_SeriesCos(double x) // |x| <= pi
+    {
+        const double x2 = x * x;
+        double Term = 1.0, Sum = 1.0;
+        for (int32 n = 1; n <= 20; ++n)
+        {
+            Term *= -x2 / double((2 * n - 1) * (2 * n));
+            Sum  += Term;
+        }
+        return Sum;
+    }
+
+    double TF_SeriesExpNeg(double x) // x >= 0; exp(-x) = exp(-x/32)^32
+    {
+        const double y = -x / 32.0;
+        double Term = 1.0, Sum = 1.0;
+        for (int32 n = 1; n <= 16; ++n)
+        {
+            Term *= y / double(n);
+            Sum  += Term;
+        }
+        for (int32 i = 0; i < 5; ++i) Sum *= Sum;
+        return Sum;
+    }
+
+    struct FTables
+    {
+        float Cos[TF_CosTableSize + 1];
+        float Exp[TF_ExpTableSize + 1];
+
+        FTables()
+        {
+            for (int32 i = 0; i <= TF_CosTableSize; ++i)
+                Cos[i] = float(TF_SeriesCos(2.0 * UE_DOUBLE_PI * double(i) / TF_CosTableSize - UE_DOUBLE_PI) * -1.0); // cos(t - pi) = -cos(t)
+
+            for (int32 i = 0; i <= TF_ExpTableSize; ++i)
+                Exp[i] = float(TF_SeriesExpNeg(TF_ExpTableRange * double(i) / TF_ExpTableSize));
+        }
+    };
+
+    const FTables& TF_GetTables()
+    {
+        static const FTables Tables;
+        return Tables;
+    }
+}
+
+float FThermoForgeDeterministicMath::Cos(float Radians)
+{
+    const FTables& T = TF_GetTables();
+
+    // Turns in [0,1): floor and multiplies are exact IEEE operations
+    const float Turns = Radians * (1.f / (2.f * UE_PI));
+    const float Frac  = Turns - FMath::FloorToFloat(Turns);
+    const float Pos   = Frac * TF_CosTableSize;
+    const int32 i     = FMath::Clamp(int32(Pos), 0, TF_CosTableSize - 1);
+    const float t     = Pos - float(i);
+    return T.Cos[i] + (T.Cos[i + 1] - T.Cos[i]) * t;
+}
+
+float FThermoForgeDeterministicMath::ExpNeg(float X)
+{
+    const FTables& T = TF_GetTables();
+
+    const float x = FMath::Clamp(-X, 0.f, float(TF_ExpTableRange));
+    const float Pos = x * float(TF_ExpTableSize / TF_ExpTableRange);
+    const int32 i   = FMath::Clamp(int32(Pos), 0, TF_ExpTableSize - 1);
+    const float t   = Pos - float(i);
+    return T.Exp[i] + (T.Exp[i + 1] - T.Exp[i]) * t;
+}
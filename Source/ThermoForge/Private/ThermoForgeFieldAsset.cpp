@@ -1,10 +1,39 @@
 ﻿#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeStats.h"
+
+#include "Engine/VolumeTexture.h"
+#include "TextureResource.h"
 
 UThermoForgeFieldAsset::UThermoForgeFieldAsset()
 {
     GridFrameWS = FTransform::Identity;
 }
 
+void UThermoForgeFieldAsset::PostLoad()
+{
+    Super::PostLoad();
+    UpdateMemoryStat();
+}
+
+void UThermoForgeFieldAsset::BeginDestroy()
+{
+    DEC_MEMORY_STAT_BY(STAT_ThermoForge_FieldMemory, ReportedMemoryBytes);
+    ReportedMemoryBytes = 0;
+    Super::BeginDestroy();
+}
+
+void UThermoForgeFieldAsset::UpdateMemoryStat()
+{
+    int64 Bytes = SkyView01.GetAllocatedSize() + WallPermeability01.GetAllocatedSize() + Indoorness01.GetAllocatedSize()
+                + SunVisibilityL1.GetAllocatedSize() + ClimateBlend.GetAllocatedSize();
+    for (const FThermoForgeFieldMip& Mip : Mips)
+        Bytes += Mip.SkyView01.GetAllocatedSize() + Mip.WallPermeability01.GetAllocatedSize();
+
+    DEC_MEMORY_STAT_BY(STAT_ThermoForge_FieldMemory, ReportedMemoryBytes);
+    INC_MEMORY_STAT_BY(STAT_ThermoForge_FieldMemory, Bytes);
+    ReportedMemoryBytes = Bytes;
+}
+
 bool UThermoForgeFieldAsset::WorldToCellTrilinear(const FVector& P, int32& ix, int32& iy, int32& iz, FVector& Alpha) const
 {
     if (Dim.X <= 1 || Dim.Y <= 1 || Dim.Z <= 1 || CellSizeCm <= 0.f) return false;
@@ -56,6 +85,51 @@ static float TF_TrilinearFetch(
     return FMath::Lerp(cxy0, cxy1, A.Z);
 }
 
+/** TF_TrilinearFetch plus d/dAlpha (per cell, grid axes). */
+static float TF_TrilinearFetchGradient(
+    const TArray<float>& Arr, const FIntVector& Dim,
+    int32 x0,int32 y0,int32 z0, const FVector& A, FVector& OutGradient)
+{
+    auto C = [&](int32 x,int32 y,int32 z){ const int32 i = (z*Dim.Y + y)*Dim.X + x; return Arr.IsValidIndex(i) ? Arr[i] : 0.f; };
+
+    const int32 x1=x0+1, y1=y0+1, z1=z0+1;
+    const float c000 = C(x0,y0,z0), c100 = C(x1,y0,z0), c010 = C(x0,y1,z0), c110 = C(x1,y1,z0);
+    const float c001 = C(x0,y0,z1), c101 = C(x1,y0,z1), c011 = C(x0,y1,z1), c111 = C(x1,y1,z1);
+
+    const float cx00 = FMath::Lerp(c000, c100, A.X);
+    const float cx10 = FMath::Lerp(c010, c110, A.X);
+    const float cx01 = FMath::Lerp(c001, c101, A.X);
+    const float cx11 = FMath::Lerp(c011, c111, A.X);
+    const float cxy0 = FMath::Lerp(cx00, cx10, A.Y);
+    const float cxy1 = FMath::Lerp(cx01, cx11, A.Y);
+
+    // Partial along one axis = the other two lerps applied to the edge differences
+    const float dx0 = FMath::Lerp(c100 - c000, c110 - c010, A.Y);
+    const float dx1 = FMath::Lerp(c101 - c001, c111 - c011, A.Y);
+    OutGradient.X = FMath::Lerp(dx0, dx1, A.Z);
+    OutGradient.Y = FMath::Lerp(cx10 - cx00, cx11 - cx01, A.Z);
+    OutGradient.Z = cxy1 - cxy0;
+
+    return FMath::Lerp(cxy0, cxy1, A.Z);
+}
+
+bool UThermoForgeFieldAsset::SampleSkyWallWithGradient(const FVector& WorldPos, float& OutSky, FVector& OutSkyGradient,
+                                                       float& OutWall, FVector& OutWallGradient) const
+{
+    int32 ix,iy,iz; FVector A;
+    if (!WorldToCellTrilinear(WorldPos, ix,iy,iz, A)) return false;
+
+    FVector GSky, GWall;
+    OutSky  = TF_TrilinearFetchGradient(SkyView01, Dim, ix,iy,iz, A, GSky);
+    OutWall = TF_TrilinearFetchGradient(WallPermeability01, Dim, ix,iy,iz, A, GWall);
+
+    // Per cell along grid axes -> per cm in world space
+    const FTransform Frame = GetGridFrame();
+    OutSkyGradient  = Frame.TransformVector(GSky / CellSizeCm);
+    OutWallGradient = Frame.TransformVector(GWall / CellSizeCm);
+    return true;
+}
+
 float UThermoForgeFieldAsset::SampleSkyView01(const FVector& WorldPos) const
 {
     int32 ix,iy,iz; FVector A;
@@ -97,3 +171,176 @@ float UThermoForgeFieldAsset::GetIndoorByLinearIdx(int32 Linear) const
     if (Linear < 0 || Linear >= Expect) return 0.f;
     return Indoorness01.IsValidIndex(Linear) ? Indoorness01[Linear] : 0.f;
 }
+
+float UThermoForgeFieldAsset::GetSolarExposureByLinearIdx(int32 Linear, const FVector& SunDir) const
+{
+    if (!SunVisibilityL1.IsValidIndex(Linear)) return FMath::Clamp(GetSkyViewByLinearIdx(Linear), 0.f, 1.f);
+    return FThermoForgeSunVisibility::Exposure(SunVisibilityL1[Linear], SunDir);
+}
+
+// ---- climate blend ----
+void UThermoForgeFieldAsset::ResolveClimatePalette(const UThermoForgeProjectSettings* S, TArray<FThermoForgeClimate>& OutPalette) const
+{
+    const FThermoForgeClimate Project = FThermoForgeClimate::FromSettings(S);
+
+    OutPalette.Reset(FMath::Max(1, ClimatePalette.Num()));
+    OutPalette.Add(Project);
+    for (int32 i = 1; i < ClimatePalette.Num(); ++i)
+        OutPalette.Add(ClimatePalette[i] ? ClimatePalette[i]->MakeClimate(S) : Project);
+}
+
+FThermoForgeClimate UThermoForgeFieldAsset::GetClimateByLinearIdx(int32 Linear, const UThermoForgeProjectSettings* S) const
+{
+    if (!ClimateBlend.IsValidIndex(Linear)) return FThermoForgeClimate::FromSettings(S);
+
+    // Only the (at most two) referenced entries are resolved
+    const uint32 Packed = ClimateBlend[Linear];
+    auto Resolve = [this, S](int32 Slot)
+    {
+        const UThermoForgeClimateProfile* P = ClimatePalette.IsValidIndex(Slot) ? ClimatePalette[Slot].Get() : nullptr;
+        return P ? P->MakeClimate(S) : FThermoForgeClimate::FromSettings(S);
+    };
+
+    const int32 A = Packed & 0xFF, B = (Packed >> 8) & 0xFF;
+    const uint32 W = Packed >> 16;
+    if (W == 0 || A == B) return Resolve(A);
+    return FThermoForgeClimate::Lerp(Resolve(A), Resolve(B), W / 65535.f);
+}
+
+// ---- mip chain (preview LOD) ----
+void UThermoForgeFieldAsset::InvalidateDerivedData()
+{
+    Mips.Reset();
+    bMipsBuilt = false;
+    ChannelTextures.Reset();
+    ++DataRevision;
+    UpdateMemoryStat();
+}
+
+int32 UThermoForgeFieldAsset::GetNumMips()
+{
+    if (!bMipsBuilt) BuildMips();
+    return Mips.Num();
+}
+
+const FThermoForgeFieldMip* UThermoForgeFieldAsset::GetMip(int32 Level)
+{
+    if (Level <= 0) return nullptr;
+    if (!bMipsBuilt) BuildMips();
+    return Mips.IsValidIndex(Level - 1) ? &Mips[Level - 1] : nullptr;
+}
+
+void UThermoForgeFieldAsset::BuildMips()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::BuildFieldMips);
+
+    Mips.Reset();
+    bMipsBuilt = true;
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    if (Dim.X <= 0 || Dim.Y <= 0 || Dim.Z <= 0 || SkyView01.Num() != N || WallPermeability01.Num() != N) return;
+
+    // Level 0 view over the asset's own arrays
+    FIntVector SrcDim = Dim;
+    const TArray<float>* SrcSky  = &SkyView01;
+    const TArray<float>* SrcWall = &WallPermeability01;
+
+    while (SrcDim.GetMax() > 1)
+    {
+        FThermoForgeFieldMip Mip;
+        Mip.Dim = FIntVector(
+            FMath::DivideAndRoundUp(SrcDim.X, 2),
+            FMath::DivideAndRoundUp(SrcDim.Y, 2),
+            FMath::DivideAndRoundUp(SrcDim.Z, 2));
+
+        const int32 M = Mip.Dim.X * Mip.Dim.Y * Mip.Dim.Z;
+        Mip.SkyView01.SetNumUninitialized(M);
+        Mip.WallPermeability01.SetNumUninitialized(M);
+
+        auto SrcIndex = [&SrcDim](int32 x, int32 y, int32 z){ return (z * SrcDim.Y + y) * SrcDim.X + x; };
+
+        for (int32 z = 0; z < Mip.Dim.Z; ++z)
+        for (int32 y = 0; y < Mip.Dim.Y; ++y)
+        for (int32 x = 0; x < Mip.Dim.X; ++x)
+        {
+            float SumSky = 0.f, SumWall = 0.f; int32 Cnt = 0;
+            for (int32 dz = 0; dz < 2; ++dz)
+            for (int32 dy = 0; dy < 2; ++dy)
+            for (int32 dx = 0; dx < 2; ++dx)
+            {
+                const int32 sx = 2*x + dx, sy = 2*y + dy, sz = 2*z + dz;
+                if (sx >= SrcDim.X || sy >= SrcDim.Y || sz >= SrcDim.Z) continue;
+                const int32 si = SrcIndex(sx, sy, sz);
+                SumSky  += (*SrcSky)[si];
+                SumWall += (*SrcWall)[si];
+                ++Cnt;
+            }
+            const int32 di = Mip.Index(x, y, z);
+            Mip.SkyView01[di]          = SumSky  / FMath::Max(1, Cnt);
+            Mip.WallPermeability01[di] = SumWall / FMath::Max(1, Cnt);
+        }
+
+        Mips.Add(MoveTemp(Mip));
+        SrcDim  = Mips.Last().Dim;
+        SrcSky  = &Mips.Last().SkyView01;
+        SrcWall = &Mips.Last().WallPermeability01;
+    }
+
+    UpdateMemoryStat();
+}
+
+// ---- volume texture upload ----
+UVolumeTexture* UThermoForgeFieldAsset::CreateVolumeTexture01(TConstArrayView<float> Values01,
+    const FIntVector& InDim, EThermoFieldTextureFormat Format, FName Name)
+{
+    const int32 N = InDim.X * InDim.Y * InDim.Z;
+    if (InDim.X <= 0 || InDim.Y <= 0 || InDim.Z <= 0 || Values01.Num() != N) return nullptr;
+
+    const bool bR16 = (Format == EThermoFieldTextureFormat::R16);
+    UVolumeTexture* Tex = UVolumeTexture::CreateTransient(InDim.X, InDim.Y, InDim.Z, bR16 ? PF_G16 : PF_G8, Name);
+    if (!Tex) return nullptr;
+
+    Tex->SRGB   = false;
+    Tex->Filter = TF_Bilinear;
+
+    FTexturePlatformData* PD = Tex->GetPlatformData();
+    if (!PD || PD->Mips.Num() == 0) return nullptr;
+
+    FTexture2DMipMap& Mip = PD->Mips[0];
+    void* Dst = Mip.BulkData.Lock(LOCK_READ_WRITE);
+    if (bR16)
+    {
+        uint16* Out = static_cast<uint16*>(Dst);
+        for (int32 i = 0; i < N; ++i)
+            Out[i] = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Values01[i], 0.f, 1.f) * 65535.f));
+    }
+    else
+    {
+        uint8* Out = static_cast<uint8*>(Dst);
+        for (int32 i = 0; i < N; ++i)
+            Out[i] = static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(Values01[i], 0.f, 1.f) * 255.f));
+    }
+    Mip.BulkData.Unlock();
+
+    Tex->UpdateResource();
+    return Tex;
+}
+
+UVolumeTexture* UThermoForgeFieldAsset::GetChannelTexture(EThermoFieldChannel Channel, EThermoFieldTextureFormat Format)
+{
+    const int32 Slot = static_cast<int32>(Channel) * 2 + static_cast<int32>(Format);
+    if (ChannelTextures.Num() <= Slot) ChannelTextures.SetNum(Slot + 1);
+    if (ChannelTextures[Slot]) return ChannelTextures[Slot];
+
+    const TArray<float>* Src = nullptr;
+    switch (Channel)
+    {
+        case EThermoFieldChannel::SkyView:          Src = &SkyView01;          break;
+        case EThermoFieldChannel::WallPermeability: Src = &WallPermeability01; break;
+        case EThermoFieldChannel::Indoorness:       Src = &Indoorness01;       break;
+    }
+    if (!Src) return nullptr;
+
+    ChannelTextures[Slot] = CreateVolumeTexture01(*Src, Dim, Format);
+    return ChannelTextures[Slot];
+}
@@ -0,0 +1,74 @@
+﻿#include "ThermoForgeFieldChunk.h"
+
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeSubsystem.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+
+AThermoForgeFieldChunk::AThermoForgeFieldChunk()
+{
+    PrimaryActorTick.bCanEverTick = false;
+    SetCanBeDamaged(false);
+
+    USceneComponent* Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+    Root->SetMobility(EComponentMobility::Static);
+    SetRootComponent(Root);
+
+#if WITH_EDITORONLY_DATA
+    bIsSpatiallyLoaded = true;
+#endif
+}
+
+FBox AThermoForgeFieldChunk::GetChunkBounds() const
+{
+    if (!Field) return FBox(ForceInit);
+
+    const FVector SizeLS = FVector(Field->Dim) * Field->CellSizeCm;
+    return FBox(FVector::ZeroVector, SizeLS).TransformBy(Field->GetGridFrame());
+}
+
+void AThermoForgeFieldChunk::UpdateRegistration()
+{
+    UWorld* W = GetWorld();
+    UThermoForgeSubsystem* Sub = W ? W->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!Sub) return;
+
+    if (bRegistered)
+    {
+        Sub->UnregisterFieldChunk(this);
+        bRegistered = false;
+    }
+    if (Field && HasActorRegisteredAllComponents())
+    {
+        Sub->RegisterFieldChunk(this);
+        bRegistered = true;
+    }
+}
+
+void AThermoForgeFieldChunk::PostRegisterAllComponents()
+{
+    Super::PostRegisterAllComponents();
+    UpdateRegistration();
+}
+
+void AThermoForgeFieldChunk::PostUnregisterAllComponents()
+{
+    if (bRegistered)
+    {
+        if (UWorld* W = GetWorld())
+            if (UThermoForgeSubsystem* Sub = W->GetSubsystem<UThermoForgeSubsystem>())
+                Sub->UnregisterFieldChunk(this);
+        bRegistered = false;
+    }
+
+    Super::PostUnregisterAllComponents();
+}
+
+#if WITH_EDITOR
+FBox AThermoForgeFieldChunk::GetStreamingBounds() const
+{
+    const FBox Box = GetChunkBounds();
+    return Box.IsValid ? Box : Super::GetStreamingBounds();
+}
+#endif
@@ -0,0 +1,33 @@
+﻿#include "ThermoForgeNavAreas.h"
+
+UThermoForgeNavArea_Hot::UThermoForgeNavArea_Hot()
+{
+    DefaultCost = 4.f;
+    DrawColor   = FColor(255, 80, 40);
+}
+
+UThermoForgeNavArea_Cold::UThermoForgeNavArea_Cold()
+{
+    DefaultCost = 1.f;
+    DrawColor   = FColor(60, 140, 255);
+}
+
+static void TF_AddAreaCost(TArray<FNavigationFilterArea>& Areas, TSubclassOf<UNavArea> AreaClass, float Cost)
+{
+    FNavigationFilterArea& Area = Areas.AddDefaulted_GetRef();
+    Area.AreaClass           = AreaClass;
+    Area.bOverrideTravelCost = true;
+    Area.TravelCostOverride  = Cost;
+}
+
+UThermoForgeNavFilter_AvoidHeat::UThermoForgeNavFilter_AvoidHeat()
+{
+    TF_AddAreaCost(Areas, UThermoForgeNavArea_Hot::StaticClass(),  10.f);
+    TF_AddAreaCost(Areas, UThermoForgeNavArea_Cold::StaticClass(), 1.f);
+}
+
+UThermoForgeNavFilter_SeekWarmth::UThermoForgeNavFilter_SeekWarmth()
+{
+    TF_AddAreaCost(Areas, UThermoForgeNavArea_Hot::StaticClass(),  1.f);
+    TF_AddAreaCost(Areas, UThermoForgeNavArea_Cold::StaticClass(), 10.f);
+}
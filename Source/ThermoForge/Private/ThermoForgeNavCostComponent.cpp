@@ -0,0 +1,408 @@
+﻿#include "ThermoForgeNavCostComponent.h"
+
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeNavAreas.h"
+#include "ThermoForgeStats.h"
+#include "ThermoForgeSubsystem.h"
+#include "ThermoForgeVolume.h"
+
+#include "Engine/World.h"
+#include "NavigationSystemTypes.h"
+
+// ---- tile ----
+UThermoForgeNavCostTileComponent::UThermoForgeNavCostTileComponent()
+{
+    // Own bounds: the tile's columns, not the owner's root
+    bAttachToOwnersRoot = false;
+}
+
+void UThermoForgeNavCostTileComponent::CalcAndCacheBounds() const
+{
+    Bounds = TileBounds;
+}
+
+void UThermoForgeNavCostTileComponent::GetNavigationData(FNavigationRelevantData& Data) const
+{
+    for (const FAreaNavModifier& Modifier : Modifiers)
+        Data.Modifiers.Add(Modifier);
+}
+
+// ---- projector ----
+UThermoForgeNavCostComponent::UThermoForgeNavCostComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = true;
+
+    // The tiles carry the modifiers; this component only drives them
+    bNavigationRelevant = false;
+
+    HotArea  = UThermoForgeNavArea_Hot::StaticClass();
+    ColdArea = UThermoForgeNavArea_Cold::StaticClass();
+}
+
+void UThermoForgeNavCostComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    RebuildAll();
+}
+
+void UThermoForgeNavCostComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    DestroyTiles();
+    Super::EndPlay(EndPlayReason);
+}
+
+int32 UThermoForgeNavCostComponent::GetNumModifiers() const
+{
+    int32 Num = 0;
+    for (const UThermoForgeNavCostTileComponent* Tile : Tiles)
+        if (Tile) Num += Tile->Modifiers.Num();
+    return Num;
+}
+
+static bool TF_SameSourceState(const FThermoForgeSourceState& A, const FThermoForgeSourceState& B)
+{
+    return A.Shape == B.Shape && A.Falloff == B.Falloff && A.IntensityCelsius == B.IntensityCelsius && A.RadiusCm == B.RadiusCm
+        && A.BoxExtent == B.BoxExtent && A.Transform.Equals(B.Transform, 0.1);
+}
+
+bool UThermoForgeNavCostComponent::BindField()
+{
+    if (!Volume)
+        Volume = Cast<AThermoForgeVolume>(GetOwner());
+
+    const UThermoForgeFieldAsset* Field = Volume ? Volume->BakedField.Get() : nullptr;
+    const FIntVector D = Field ? Field->Dim : FIntVector::ZeroValue;
+    if (!Field || D.X <= 0 || D.Y <= 0 || D.Z <= 0)
+    {
+        BoundField.Reset();
+        Bands.Reset();
+        return false;
+    }
+
+    if (BoundField.Get() != Field || BoundRevision != Field->GetDataRevision() || Bands.Num() != D.X * D.Y * D.Z)
+    {
+        BoundField    = Field;
+        BoundRevision = Field->GetDataRevision();
+        Bands.Init(EBand::Neutral, D.X * D.Y * D.Z);
+        LastSources.Reset();
+    }
+    return true;
+}
+
+void UThermoForgeNavCostComponent::RebuildAll()
+{
+    if (!BindField())
+    {
+        DestroyTiles();
+        return;
+    }
+
+    // Baseline for the incremental passes
+    TArray<FBox> Ignored;
+    CollectSourceChanges(Ignored);
+
+    SyncTiles();
+    RecomposeCells({});
+    RefreshDirtyTiles();
+}
+
+void UThermoForgeNavCostComponent::SetClimate(bool bInWinter, float InTimeHours, float InWeatherAlpha01)
+{
+    if (bWinter == bInWinter && FMath::IsNearlyEqual(TimeHours, InTimeHours) && FMath::IsNearlyEqual(WeatherAlpha01, InWeatherAlpha01))
+        return;
+
+    bWinter        = bInWinter;
+    TimeHours      = InTimeHours;
+    WeatherAlpha01 = InWeatherAlpha01;
+    RebuildAll();
+}
+
+void UThermoForgeNavCostComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    TimeSinceRefresh += DeltaTime;
+    if (TimeSinceRefresh < RefreshIntervalSeconds) return;
+    TimeSinceRefresh = 0.f;
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::NavCostRefresh);
+
+    // A rebake or a swapped field invalidates every cell
+    const UThermoForgeFieldAsset* Before = BoundField.Get();
+    const uint32 BeforeRevision = BoundRevision;
+    if (!BindField() || BoundField.Get() != Before || BoundRevision != BeforeRevision)
+    {
+        RebuildAll();
+        return;
+    }
+
+    TArray<FBox> Dirty;
+    CollectSourceChanges(Dirty);
+    if (Dirty.Num() == 0) return;
+
+    TArray<int32> Cells;
+    GatherCellsInBoxes(Dirty, Cells);
+    if (Cells.Num() > 0)
+    {
+        RecomposeCells(Cells);
+        RefreshDirtyTiles();
+    }
+}
+
+void UThermoForgeNavCostComponent::CollectSourceChanges(TArray<FBox>& OutDirty)
+{
+    OutDirty.Reset();
+
+    const UWorld* World = GetWorld();
+    const UThermoForgeSubsystem* Sub = World ? World->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!Sub) return;
+
+    TArray<UThermoForgeSourceComponent*> Sources;
+    Sub->GetAllSources(Sources);
+
+    TMap<TWeakObjectPtr<UThermoForgeSourceComponent>, FThermoForgeSourceState> Current;
+    Current.Reserve(Sources.Num());
+    for (UThermoForgeSourceComponent* Source : Sources)
+    {
+        const FThermoForgeSourceState State = Source->MakeState();
+        Current.Add(Source, State);
+
+        const FThermoForgeSourceState* Last = LastSources.Find(Source);
+        if (!Last)
+        {
+            if (State.IntensityCelsius != 0.f)
+                OutDirty.Add(State.GetBoundsWS());
+        }
+        else if (!TF_SameSourceState(*Last, State))
+        {
+            OutDirty.Add(Last->GetBoundsWS());
+            OutDirty.Add(State.GetBoundsWS());
+        }
+    }
+
+    // Removed (or destroyed) sources leave their old footprint behind
+    for (const TPair<TWeakObjectPtr<UThermoForgeSourceComponent>, FThermoForgeSourceState>& Last : LastSources)
+        if (!Current.Contains(Last.Key) && Last.Value.IntensityCelsius != 0.f)
+            OutDirty.Add(Last.Value.GetBoundsWS());
+
+    LastSources = MoveTemp(Current);
+}
+
+void UThermoForgeNavCostComponent::GatherCellsInBoxes(TConstArrayView<FBox> Boxes, TArray<int32>& OutCells) const
+{
+    OutCells.Reset();
+    const UThermoForgeFieldAsset* Field = BoundField.Get();
+    if (!Field) return;
+
+    const FIntVector D = Field->Dim;
+    const float Cell = Field->CellSizeCm;
+    const FTransform Frame = Field->GetGridFrame();
+
+    TBitArray<> Seen(false, D.X * D.Y * D.Z);
+    for (const FBox& WorldBox : Boxes)
+    {
+        // Grid-space index range of the box, then an exact center test (the grid may be rotated)
+        const FBox GridBox = WorldBox.InverseTransformBy(Frame);
+        const FIntVector Min(FMath::Max(0, FMath::FloorToInt(GridBox.Min.X / Cell)),
+                             FMath::Max(0, FMath::FloorToInt(GridBox.Min.Y / Cell)),
+                             FMath::Max(0, FMath::FloorToInt(GridBox.Min.Z / Cell)));
+        const FIntVector Max(FMath::Min(D.X - 1, FMath::FloorToInt(GridBox.Max.X / Cell)),
+                             FMath::Min(D.Y - 1, FMath::FloorToInt(GridBox.Max.Y / Cell)),
+                             FMath::Min(D.Z - 1, FMath::FloorToInt(GridBox.Max.Z / Cell)));
+
+        for (int32 z = Min.Z; z <= Max.Z; ++z)
+            for (int32 y = Min.Y; y <= Max.Y; ++y)
+                for (int32 x = Min.X; x <= Max.X; ++x)
+                {
+                    const int32 i = Field->Index(x, y, z);
+                    if (Seen[i]) continue;
+
+                    const FVector Center = Frame.TransformPosition(FVector((x + 0.5f) * Cell, (y + 0.5f) * Cell, (z + 0.5f) * Cell));
+                    if (!WorldBox.IsInsideOrOn(Center)) continue;
+
+                    Seen[i] = true;
+                    OutCells.Add(i);
+                }
+    }
+}
+
+void UThermoForgeNavCostComponent::RecomposeCells(TConstArrayView<int32> Cells)
+{
+    const UThermoForgeFieldAsset* Field = BoundField.Get();
+    const UWorld* World = GetWorld();
+    const UThermoForgeSubsystem* Sub = World ? World->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!Field || !Sub) return;
+
+    auto ToBand = [this](float TempC)
+    {
+        return TempC > HotThresholdC ? EBand::Hot : (TempC < ColdThresholdC ? EBand::Cold : EBand::Neutral);
+    };
+    auto Store = [&](int32 i, float TempC)
+    {
+        const EBand Band = ToBand(TempC);
+        if (Bands[i] == Band) return;
+        Bands[i] = Band;
+        const int32 Tile = TileOfCell(i);
+        if (DirtyTiles.IsValidIndex(Tile)) DirtyTiles[Tile] = true;
+    };
+
+    TArray<float> TempC;
+    if (Cells.IsEmpty())
+    {
+        Sub->ComputeFieldTemperatures(Field, Bands.Num(), bWinter, TimeHours, WeatherAlpha01, TempC);
+        for (int32 i = 0; i < TempC.Num(); ++i)
+            Store(i, TempC[i]);
+        return;
+    }
+
+    Sub->ComputeFieldCellTemperatures(Field, Cells, bWinter, TimeHours, WeatherAlpha01, TempC);
+    for (int32 k = 0; k < TempC.Num(); ++k)
+        Store(Cells[k], TempC[k]);
+}
+
+int32 UThermoForgeNavCostComponent::TileOfCell(int32 CellIndex) const
+{
+    const FIntVector D = BoundField->Dim;
+    const int32 x = CellIndex % D.X;
+    const int32 y = (CellIndex / D.X) % D.Y;
+    return (y / BoundTileCells) * NumTiles.X + x / BoundTileCells;
+}
+
+void UThermoForgeNavCostComponent::SyncTiles()
+{
+    const UThermoForgeFieldAsset* Field = BoundField.Get();
+    if (!Field) return;
+
+    BoundTileCells = FMath::Max(1, TileCells);
+    const FIntVector D = Field->Dim;
+    const FIntPoint Wanted(FMath::DivideAndRoundUp(D.X, BoundTileCells), FMath::DivideAndRoundUp(D.Y, BoundTileCells));
+    if (Wanted != NumTiles || Tiles.Num() != Wanted.X * Wanted.Y)
+    {
+        DestroyTiles();
+        NumTiles = Wanted;
+        Tiles.Reserve(NumTiles.X * NumTiles.Y);
+        for (int32 t = 0; t < NumTiles.X * NumTiles.Y; ++t)
+        {
+            UThermoForgeNavCostTileComponent* Tile = NewObject<UThermoForgeNavCostTileComponent>(GetOwner(), NAME_None, RF_Transient);
+            Tile->RegisterComponent();
+            Tiles.Add(Tile);
+        }
+    }
+
+    // Bounds follow the field (a rebake may move or rotate it)
+    const float Cell = Field->CellSizeCm;
+    const FTransform Frame = Field->GetGridFrame();
+    for (int32 t = 0; t < Tiles.Num(); ++t)
+    {
+        const int32 x0 = (t % NumTiles.X) * BoundTileCells, y0 = (t / NumTiles.X) * BoundTileCells;
+        const int32 x1 = FMath::Min(x0 + BoundTileCells, D.X), y1 = FMath::Min(y0 + BoundTileCells, D.Y);
+        Tiles[t]->TileBounds = FBox(FVector(x0, y0, 0) * Cell, FVector(x1, y1, D.Z) * Cell).TransformBy(Frame);
+    }
+    DirtyTiles.Init(true, Tiles.Num());
+}
+
+void UThermoForgeNavCostComponent::DestroyTiles()
+{
+    for (UThermoForgeNavCostTileComponent* Tile : Tiles)
+        if (Tile) Tile->DestroyComponent();
+    Tiles.Reset();
+    DirtyTiles.Reset();
+    NumTiles = FIntPoint::ZeroValue;
+}
+
+void UThermoForgeNavCostComponent::RefreshDirtyTiles()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::NavCostModifiers);
+    for (TConstSetBitIterator<> It(DirtyTiles); It; ++It)
+    {
+        UThermoForgeNavCostTileComponent* Tile = Tiles.IsValidIndex(It.GetIndex()) ? Tiles[It.GetIndex()].Get() : nullptr;
+        if (!Tile) continue;
+
+        BuildTileModifiers(It.GetIndex(), Tile->Modifiers);
+        Tile->RefreshNavigationModifiers();
+    }
+    DirtyTiles.Init(false, Tiles.Num());
+}
+
+namespace
+{
+    struct FTFNavRect
+    {
+        int32 X0 = 0, X1 = 0, Y0 = 0, Y1 = 0;
+        uint8 Band = 0;
+
+        bool operator==(const FTFNavRect& O) const { return X0 == O.X0 && X1 == O.X1 && Y0 == O.Y0 && Y1 == O.Y1 && Band == O.Band; }
+        friend uint32 GetTypeHash(const FTFNavRect& R)
+        {
+            return HashCombineFast(HashCombineFast(GetTypeHash(R.X0), GetTypeHash(R.X1)),
+                                   HashCombineFast(GetTypeHash(R.Y0), GetTypeHash(R.Y1 * 4 + R.Band)));
+        }
+    };
+}
+
+void UThermoForgeNavCostComponent::BuildTileModifiers(int32 Tile, TArray<FAreaNavModifier>& OutModifiers) const
+{
+    OutModifiers.Reset();
+
+    const UThermoForgeFieldAsset* Field = BoundField.Get();
+    if (!Field) return;
+
+    const FIntVector D = Field->Dim;
+    const float Cell = Field->CellSizeCm;
+    const FTransform Frame = Field->GetGridFrame();
+    const int32 tx0 = (Tile % NumTiles.X) * BoundTileCells, ty0 = (Tile / NumTiles.X) * BoundTileCells;
+    const int32 tx1 = FMath::Min(tx0 + BoundTileCells, D.X), ty1 = FMath::Min(ty0 + BoundTileCells, D.Y);
+    const int32 W = tx1 - tx0;
+
+    auto Emit = [&](const FTFNavRect& R, int32 z0, int32 z1)
+    {
+        const FBox GridBox(FVector(R.X0, R.Y0, z0) * Cell, FVector(R.X1, R.Y1, z1) * Cell);
+        OutModifiers.Emplace(GridBox, Frame, (EBand)R.Band == EBand::Hot ? HotArea : ColdArea);
+    };
+
+    // Rectangles still open from the slice below, with the slice they started in
+    TMap<FTFNavRect, int32> Open, Next;
+    TBitArray<> Used;
+    for (int32 z = 0; z < D.Z; ++z)
+    {
+        // Greedy equal-band rectangles in this slice: grow along X, then along Y while whole rows match
+        Used.Init(false, W * (ty1 - ty0));
+        Next.Reset();
+        for (int32 y = ty0; y < ty1; ++y)
+            for (int32 x = tx0; x < tx1; ++x)
+            {
+                const EBand Band = Bands[Field->Index(x, y, z)];
+                if (Band == EBand::Neutral || Used[(y - ty0) * W + (x - tx0)]) continue;
+
+                auto Free = [&](int32 xx, int32 yy) { return !Used[(yy - ty0) * W + (xx - tx0)] && Bands[Field->Index(xx, yy, z)] == Band; };
+
+                int32 x1 = x + 1;
+                while (x1 < tx1 && Free(x1, y)) ++x1;
+
+                int32 y1 = y + 1;
+                for (; y1 < ty1; ++y1)
+                {
+                    bool bRow = true;
+                    for (int32 xx = x; xx < x1 && bRow; ++xx) bRow = Free(xx, y1);
+                    if (!bRow) break;
+                }
+
+                for (int32 yy = y; yy < y1; ++yy)
+                    for (int32 xx = x; xx < x1; ++xx)
+                        Used[(yy - ty0) * W + (xx - tx0)] = true;
+
+                // The same rectangle in the slice below continues as one column
+                const FTFNavRect R{ x, x1, y, y1, (uint8)Band };
+                int32 StartZ = z;
+                Open.RemoveAndCopyValue(R, StartZ);
+                Next.Add(R, StartZ);
+            }
+
+        for (const TPair<FTFNavRect, int32>& Ended : Open)
+            Emit(Ended.Key, Ended.Value, z);
+        Swap(Open, Next);
+    }
+    for (const TPair<FTFNavRect, int32>& Ended : Open)
+        Emit(Ended.Key, Ended.Value, D.Z);
+}
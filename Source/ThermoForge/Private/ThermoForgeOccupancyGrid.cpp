@@ -0,0 +1,272 @@
+﻿#include "ThermoForgeOccupancyGrid.h"
+#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeSubsystem.h"
+
+#include "Engine/World.h"
+#include "Engine/OverlapResult.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Async/ParallelFor.h"
+
+void FThermoForgeOccupancyGrid::Init(const FTransform& InFrame, const FVector& InOriginLS, float InVoxelSize, const FIntVector& InDim, float InCellSizeCm)
+{
+    Frame      = InFrame;
+    OriginLS   = InOriginLS;
+    VoxelSize  = FMath::Max(1.f, InVoxelSize);
+    Dim        = InDim;
+    CellSizeCm = FMath::Max(1.f, InCellSizeCm);
+
+    Occupancy.Reset();
+    Occupancy.SetNumZeroed(Dim.X * Dim.Y * Dim.Z);
+    DensityPalette.Reset();
+}
+
+uint8 FThermoForgeOccupancyGrid::FindOrAddDensity(float DensityKgM3)
+{
+    for (int32 i = 0; i < DensityPalette.Num(); ++i)
+        if (FMath::IsNearlyEqual(DensityPalette[i], DensityKgM3, 0.5f))
+            return (uint8)(i + 1);
+
+    if (DensityPalette.Num() >= 255)
+    {
+        // Palette full: snap to the closest entry
+        int32 Best = 0;
+        for (int32 i = 1; i < DensityPalette.Num(); ++i)
+            if (FMath::Abs(DensityPalette[i] - DensityKgM3) < FMath::Abs(DensityPalette[Best] - DensityKgM3))
+                Best = i;
+        return (uint8)(Best + 1);
+    }
+
+    DensityPalette.Add(DensityKgM3);
+    return (uint8)DensityPalette.Num();
+}
+
+int32 FThermoForgeOccupancyGrid::NumOccupied() const
+{
+    int32 Count = 0;
+    for (uint8 Slot : Occupancy)
+        Count += (Slot != 0);
+    return Count;
+}
+
+// ---- rasterization ----
+void FThermoForgeOccupancyGrid::Rasterize(const UWorld* World, const UThermoForgeProjectSettings* S)
+{
+    if (!World || !S || Occupancy.Num() == 0) return;
+
+    const ECollisionChannel Channel = static_cast<ECollisionChannel>(S->TraceChannel.GetValue());
+    FCollisionQueryParams Q(SCENE_QUERY_STAT(ThermoVoxelize), /*bTraceComplex*/true);
+
+    const FVector SizeLS   = FVector(Dim) * VoxelSize;
+    const FVector CenterWS = Frame.TransformPosition(OriginLS + 0.5f * SizeLS);
+
+    TArray<FOverlapResult> Overlaps;
+    World->OverlapMultiByChannel(Overlaps, CenterWS, Frame.GetRotation(), Channel, FCollisionShape::MakeBox(0.5f * SizeLS), Q);
+
+    TSet<const UPrimitiveComponent*> Seen;
+    for (const FOverlapResult& O : Overlaps)
+    {
+        const UPrimitiveComponent* PC = O.bBlockingHit ? O.GetComponent() : nullptr;
+        if (!PC || Seen.Contains(PC)) continue;
+        Seen.Add(PC);
+
+        const uint8 Slot = FindOrAddDensity(UThermoForgeSubsystem::GetComponentDensityKgM3(PC, S));
+
+        // Voxel range covered by the component's bounds
+        const FBox BoxLS = PC->Bounds.GetBox().TransformBy(Frame.Inverse());
+        const FIntVector Lo(
+            FMath::Clamp(FMath::FloorToInt((BoxLS.Min.X - OriginLS.X) / VoxelSize), 0, Dim.X),
+            FMath::Clamp(FMath::FloorToInt((BoxLS.Min.Y - OriginLS.Y) / VoxelSize), 0, Dim.Y),
+            FMath::Clamp(FMath::FloorToInt((BoxLS.Min.Z - OriginLS.Z) / VoxelSize), 0, Dim.Z));
+        const FIntVector Hi(
+            FMath::Clamp(FMath::CeilToInt((BoxLS.Max.X - OriginLS.X) / VoxelSize), 0, Dim.X),
+            FMath::Clamp(FMath::CeilToInt((BoxLS.Max.Y - OriginLS.Y) / VoxelSize), 0, Dim.Y),
+            FMath::Clamp(FMath::CeilToInt((BoxLS.Max.Z - OriginLS.Z) / VoxelSize), 0, Dim.Z));
+        if (Lo.X >= Hi.X || Lo.Y >= Hi.Y || Lo.Z >= Hi.Z) continue;
+
+        auto VoxelCenterWS = [&](int32 x, int32 y, int32 z)
+        {
+            return Frame.TransformPosition(OriginLS + FVector(x + 0.5f, y + 0.5f, z + 0.5f) * VoxelSize);
+        };
+
+        const UBodySetup* BS = const_cast<UPrimitiveComponent*>(PC)->GetBodySetup();
+        if (BS && BS->AggGeom.GetElementCount() > 0)
+        {
+            // Simple shapes: point-in-shape at voxel centers, one z-layer per task
+            const FKAggregateGeom& Agg = BS->AggGeom;
+            const FTransform Xf = PC->GetComponentTransform();
+
+            ParallelFor(Hi.Z - Lo.Z, [&](int32 dz)
+            {
+                const int32 z = Lo.Z + dz;
+                for (int32 y = Lo.Y; y < Hi.Y; ++y)
+                for (int32 x = Lo.X; x < Hi.X; ++x)
+                {
+                    uint8& Voxel = Occupancy[Index(x, y, z)];
+                    if (Voxel) continue;
+
+                    const FVector P = VoxelCenterWS(x, y, z);
+                    bool bInside = false;
+                    for (const FKBoxElem& E : Agg.BoxElems)       { if (E.GetShortestDistanceToPoint(P, Xf) <= 0.f) { bInside = true; break; } }
+                    if (!bInside) for (const FKSphereElem& E : Agg.SphereElems) { if (E.GetShortestDistanceToPoint(P, Xf) <= 0.f) { bInside = true; break; } }
+                    if (!bInside) for (const FKSphylElem& E : Agg.SphylElems)   { if (E.GetShortestDistanceToPoint(P, Xf) <= 0.f) { bInside = true; break; } }
+                    if (!bInside) for (const FKConvexElem& E : Agg.ConvexElems) { if (E.GetShortestDistanceToPoint(P, Xf) <= 0.f) { bInside = true; break; } }
+
+                    if (bInside) Voxel = Slot;
+                }
+            });
+        }
+        else
+        {
+            // Complex-only collision (landscape, complex-as-simple meshes): voxelize the triangles as a surface shell,
+            // which is what the trace backend hits. Rows of voxel centers are cast along each grid axis and every
+            // surface crossing marks its voxel; a surface missed by one axis is crossed by another. Interiors stay empty.
+            for (int32 a = 0; a < 3; ++a)
+            {
+                const int32 u = (a + 1) % 3, v = (a + 2) % 3;
+                const int32 NumU = Hi[u] - Lo[u], NumV = Hi[v] - Lo[v];
+                const int32 MaxCrossings = Hi[a] - Lo[a] + 1;
+
+                FVector AxisLS(0.0); AxisLS[a] = 1.0;
+                const FVector AxisWS = Frame.TransformVectorNoScale(AxisLS);
+
+                // Each row writes only its own (u, v) voxels, so rows run in parallel
+                ParallelFor(NumU * NumV, [&](int32 r)
+                {
+                    FIntVector Vox;
+                    Vox[u] = Lo[u] + r % NumU;
+                    Vox[v] = Lo[v] + r / NumU;
+
+                    FVector StartLS;
+                    StartLS[u] = OriginLS[u] + (Vox[u] + 0.5f) * VoxelSize;
+                    StartLS[v] = OriginLS[v] + (Vox[v] + 0.5f) * VoxelSize;
+                    StartLS[a] = OriginLS[a] + Lo[a] * VoxelSize;
+                    FVector Start = Frame.TransformPosition(StartLS);
+                    const FVector End = Start + AxisWS * ((Hi[a] - Lo[a]) * VoxelSize);
+
+                    FHitResult Hit;
+                    FCollisionQueryParams RowQ(SCENE_QUERY_STAT(ThermoVoxelShell), /*bTraceComplex*/true);
+                    for (int32 i = 0; i < MaxCrossings; ++i)
+                    {
+                        if (!const_cast<UPrimitiveComponent*>(PC)->LineTraceComponent(Hit, Start, End, RowQ))
+                            break;
+
+                        const double HitA = Frame.InverseTransformPosition(Hit.ImpactPoint)[a];
+                        Vox[a] = FMath::Clamp(FMath::FloorToInt((HitA - OriginLS[a]) / VoxelSize), Lo[a], Hi[a] - 1);
+                        uint8& Voxel = Occupancy[Index(Vox.X, Vox.Y, Vox.Z)];
+                        if (!Voxel) Voxel = Slot;
+
+                        // Continue just past this crossing
+                        Start = Hit.ImpactPoint + AxisWS * (0.01f * VoxelSize);
+                        if (FVector::DotProduct(End - Start, AxisWS) <= 0.0) break;
+                    }
+                });
+            }
+        }
+    }
+}
+
+// ---- marching (Amanatides–Woo DDA) ----
+// Visits voxels along the ray in order; Visit(Slot, SegmentVoxels) returns false to stop.
+template<typename VisitorType>
+static void TF_MarchVoxels(const FThermoForgeOccupancyGrid& Grid, const FVector& PWS, const FVector& DirWS, float MaxLen, VisitorType&& Visit)
+{
+    const FVector G = (Grid.Frame.InverseTransformPosition(PWS) - Grid.OriginLS) / Grid.VoxelSize; // voxel units
+    const FVector D = Grid.Frame.InverseTransformVectorNoScale(DirWS);
+
+    int32 I[3] = { FMath::FloorToInt(G.X), FMath::FloorToInt(G.Y), FMath::FloorToInt(G.Z) };
+    const int32 N[3] = { Grid.Dim.X, Grid.Dim.Y, Grid.Dim.Z };
+    for (int32 a = 0; a < 3; ++a)
+        if (I[a] < 0 || I[a] >= N[a]) return; // start outside: nothing known, treat as open
+
+    int32  Step[3];
+    double TMax[3], TDelta[3];
+    for (int32 a = 0; a < 3; ++a)
+    {
+        const double d = D[a];
+        if (d > UE_KINDA_SMALL_NUMBER)       { Step[a] =  1; TDelta[a] = 1.0 / d;  TMax[a] = (I[a] + 1 - G[a]) / d; }
+        else if (d < -UE_KINDA_SMALL_NUMBER) { Step[a] = -1; TDelta[a] = -1.0 / d; TMax[a] = (G[a] - I[a]) / -d; }
+        else                                 { Step[a] =  0; TDelta[a] = TMax[a] = TNumericLimits<double>::Max(); }
+    }
+
+    const double MaxT = MaxLen / Grid.VoxelSize;
+    double T = 0.0;
+    for (;;)
+    {
+        const int32 a    = (TMax[0] < TMax[1]) ? (TMax[0] < TMax[2] ? 0 : 2) : (TMax[1] < TMax[2] ? 1 : 2);
+        const double TEnd = FMath::Min(TMax[a], MaxT);
+
+        if (!Visit(Grid.Occupancy[Grid.Index(I[0], I[1], I[2])], TEnd - T)) return;
+        if (TMax[a] > MaxT) return;
+
+        T = TMax[a];
+        I[a] += Step[a];
+        if (I[a] < 0 || I[a] >= N[a]) return; // left the grid: open
+        TMax[a] += TDelta[a];
+    }
+}
+
+bool FThermoForgeOccupancyGrid::FirstHit(const FVector& PWS, const FVector& DirWS, float MaxLen, float& OutDensityKgM3) const
+{
+    bool bHit = false;
+    TF_MarchVoxels(*this, PWS, DirWS, MaxLen, [&](uint8 Slot, double)
+    {
+        if (!Slot) return true;
+        OutDensityKgM3 = DensityPalette[Slot - 1];
+        bHit = true;
+        return false;
+    });
+    return bHit;
+}
+
+float FThermoForgeOccupancyGrid::OpticalDepthAlong(const FVector& PWS, const FVector& DirWS, float MaxLen, float MaxDepth,
+    const UThermoForgeProjectSettings* S) const
+{
+    float Depth = 0.f;
+    if (!S) return Depth;
+
+    // Segment length in cells, scaled like a trace crossing
+    const float VoxelInCells = VoxelSize / CellSizeCm * S->FaceThicknessFactor;
+    TF_MarchVoxels(*this, PWS, DirWS, MaxLen, [&](uint8 Slot, double SegVoxels)
+    {
+        if (Slot)
+            Depth += S->OpticalDepth(DensityPalette[Slot - 1], (float)SegVoxels * VoxelInCells);
+        return Depth < MaxDepth;
+    });
+    return FMath::Min(Depth, MaxDepth);
+}
+
+float FThermoForgeOccupancyGrid::AmbientRay01(const FVector& P, const FVector& Dir, float MaxLen, const UThermoForgeProjectSettings* S) const
+{
+    if (!S) return 1.f;
+
+    if (S->bMultiHitOcclusion)
+    {
+        const float MaxDepth = -FMath::Loge(FMath::Clamp(S->TransmittanceEpsilon, 1e-6f, 1.f));
+        return S->OpticalDepthToPermeability(OpticalDepthAlong(P, Dir, MaxLen, MaxDepth, S));
+    }
+
+    float rho = 0.f;
+    if (!FirstHit(P, Dir, MaxLen, rho)) return 1.f;
+    return S->DensityToPermeability(rho, S->FaceThicknessFactor);
+}
+
+float FThermoForgeOccupancyGrid::OcclusionBetween(const FVector& A, const FVector& B, float InCellSizeCm, const UThermoForgeProjectSettings* S) const
+{
+    const FVector AB   = B - A;
+    const float   Dist = AB.Size();
+    if (!S || Dist <= UE_KINDA_SMALL_NUMBER) return 1.f;
+
+    if (S->bMultiHitOcclusion)
+    {
+        const float MaxDepth = -FMath::Loge(FMath::Clamp(S->TransmittanceEpsilon, 1e-6f, 1.f));
+        return S->OpticalDepthToPermeability(OpticalDepthAlong(A, AB / Dist, Dist, MaxDepth, S));
+    }
+
+    float rho = 0.f;
+    if (!FirstHit(A, AB / Dist, Dist, rho)) return 1.f; // open
+
+    const float Cell  = FMath::Max(1.f, InCellSizeCm);
+    const float Lfrac = (Dist / Cell) * S->FaceThicknessFactor;
+    return S->DensityToPermeability(rho, Lfrac);
+}
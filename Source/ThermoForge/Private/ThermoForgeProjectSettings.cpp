@@ -1,24 +1,16 @@
 ﻿#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeDeterministicMath.h"
+#include "ThermoForgeClimateProfile.h"
 #include "Math/UnrealMathUtility.h"
+#include "Math/RandomStream.h"
 
 UThermoForgeProjectSettings::UThermoForgeProjectSettings()
 {
 }
 
-static FORCEINLINE float TF_Diurnal(float Avg, float Delta, float TimeOfDayHours)
-{
-    // Cosine curve: warmest ~15:00, coolest ~03:00
-    const float ClampedH = FMath::Clamp(TimeOfDayHours, 0.0f, 24.0f);
-    const float Phase    = (ClampedH - 15.0f) / 24.0f;   // shift so peak at 15:00
-    const float Osc      = FMath::Cos(2.0f * PI * Phase);// -1..+1
-    return Avg + 0.5f * Delta * Osc;
-}
-
 float UThermoForgeProjectSettings::GetAmbientCelsius(bool bWinter, float TimeOfDayHours) const
 {
-    const float Avg   = bWinter ? WinterAverageC       : SummerAverageC;
-    const float Delta = bWinter ? WinterDayNightDeltaC : SummerDayNightDeltaC;
-    return TF_Diurnal(Avg, Delta, TimeOfDayHours);
+    return FThermoForgeClimate::FromSettings(this).GetAmbientCelsius(bWinter, TimeOfDayHours, bDeterministicComposition);
 }
 
 float UThermoForgeProjectSettings::AdjustForAltitude(float BaseCelsius, float WorldZcm) const
@@ -38,6 +30,23 @@ float UThermoForgeProjectSettings::GetAmbientCelsiusAt(bool bWinter, float TimeO
 }
 
 float UThermoForgeProjectSettings::DensityToPermeability(float DensityKgM3, float ThicknessFraction) const
+{
+    return OpticalDepthToPermeability(OpticalDepth(DensityKgM3, ThicknessFraction));
+}
+
+bool UThermoForgeProjectSettings::FindDensityOverride(const UPhysicalMaterial* PhysMat, float& OutDensityKgM3) const
+{
+    if (!PhysMat || DensityOverridesKgM3.Num() == 0) return false;
+
+    if (const float* Found = DensityOverridesKgM3.Find(TSoftObjectPtr<UPhysicalMaterial>(FSoftObjectPath(PhysMat))))
+    {
+        OutDensityKgM3 = FMath::Max(0.f, *Found);
+        return true;
+    }
+    return false;
+}
+
+float UThermoForgeProjectSettings::OpticalDepth(float DensityKgM3, float ThicknessFraction) const
 {
     // Normalize density to [0..1] within [air .. max solid]
     const float DenMin  = FMath::Min(AirDensityKgM3, MaxSolidDensityKgM3);
@@ -46,9 +55,127 @@ float UThermoForgeProjectSettings::DensityToPermeability(float DensityKgM3, floa
 
     // Beer–Lambert attenuation: exp(-beta * rho_norm * L)
     const float L = FMath::Max(0.0f, ThicknessFraction);
-    float P = FMath::Exp(-AbsorptionBeta * RhoNorm * L);
+    return AbsorptionBeta * RhoNorm * L;
+}
 
+float UThermoForgeProjectSettings::OpticalDepthToPermeability(float Depth) const
+{
     // Clamp to user range
-    P = FMath::Clamp(P, MinPermeabilityClamp, MaxPermeabilityClamp);
-    return P;
+    const float T = bDeterministicComposition ? FThermoForgeDeterministicMath::ExpNeg(-FMath::Max(0.0f, Depth))
+                                              : FMath::Exp(-FMath::Max(0.0f, Depth));
+    return FMath::Clamp(T, MinPermeabilityClamp, MaxPermeabilityClamp);
+}
+
+FThermoForgeSkySampling UThermoForgeProjectSettings::GetSkySampling() const
+{
+    FThermoForgeSkySampling Out;
+    Out.MaxRayLengthCm = SkyMaxRayLengthCm;
+
+    switch (BakeQuality)
+    {
+    case EThermoBakeQuality::Draft:
+        Out.Directions      = EThermoSkyDirections::Fibonacci;
+        Out.NumDirections   = 4;
+        Out.bCosineWeighted = true;
+        break;
+
+    case EThermoBakeQuality::Standard:
+        break; // legacy defaults
+
+    case EThermoBakeQuality::Shipping:
+        Out.Directions            = EThermoSkyDirections::Stratified;
+        Out.NumDirections         = 8;
+        Out.bCosineWeighted       = true;
+        Out.bAdaptive             = true;
+        Out.AdaptiveMaxDirections = 64;
+        Out.AdaptiveSpread        = 0.25f;
+        break;
+
+    case EThermoBakeQuality::Custom:
+        Out.Directions            = SkyDirections;
+        Out.NumDirections         = FMath::Max(1, SkyDirectionCount);
+        Out.bCosineWeighted       = bSkyCosineWeighted;
+        Out.bAdaptive             = bSkyAdaptive;
+        Out.AdaptiveMaxDirections = FMath::Max(Out.NumDirections, SkyAdaptiveMaxDirections);
+        Out.AdaptiveSpread        = SkyAdaptiveSpread;
+        break;
+    }
+
+    if (Out.Directions == EThermoSkyDirections::Fixed12)
+        Out.bAdaptive = false; // one fixed table, nothing to refine with
+    return Out;
+}
+
+// Hemisphere point for unit square (u,v): z from u, azimuth from v
+static FORCEINLINE FVector TF_HemisphereDir(float u, float v, bool bCosine)
+{
+    const float z   = bCosine ? FMath::Sqrt(FMath::Max(0.f, 1.f - u)) : 1.f - u;
+    const float r   = FMath::Sqrt(FMath::Max(0.f, 1.f - z * z));
+    const float Phi = 2.f * PI * v;
+    return FVector(r * FMath::Cos(Phi), r * FMath::Sin(Phi), z);
+}
+
+void FThermoForgeSkySampling::BuildDirections(int32 Count, TArray<FVector>& OutDirs, TArray<float>& OutWeights) const
+{
+    OutDirs.Reset();
+    OutWeights.Reset();
+
+    switch (Directions)
+    {
+    case EThermoSkyDirections::Fixed12:
+    {
+        const FVector base[12] = {
+            { 0, 0, 1}, { 0.5, 0, 0.866f}, {-0.5, 0, 0.866f}, {0, 0.5, 0.866f}, {0, -0.5, 0.866f},
+            { 0.707f, 0.707f, 0}, {-0.707f, 0.707f, 0}, {0.707f,-0.707f, 0}, {-0.707f,-0.707f, 0},
+            { 0.923f, 0, 0.382f}, {-0.923f, 0, 0.382f}, {0, 0.923f, 0.382f}
+        };
+        OutDirs.Append(base, UE_ARRAY_COUNT(base));
+        for (FVector& d : OutDirs)
+        {
+            d.Normalize();
+            // Horizontal rays keep a small weight so the table never collapses to a few rays
+            OutWeights.Add(bCosineWeighted ? FMath::Max(0.05f, (float)d.Z) : 1.f);
+        }
+        break;
+    }
+
+    case EThermoSkyDirections::Stratified:
+    {
+        // Rows in u (elevation) x columns in v (azimuth), jittered with a fixed seed so bakes are reproducible.
+        // The last row takes the remainder with its own columns, so exactly Count rays go out.
+        Count = FMath::Max(1, Count);
+        const int32 Cols = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(2.f * Count)));
+        const int32 Rows = FMath::DivideAndRoundUp(Count, Cols);
+        FRandomStream Rng(0x7E4D0F);
+        for (int32 r = 0; r < Rows; ++r)
+        {
+            const int32 RowCols = (r < Rows - 1) ? Cols : Count - (Rows - 1) * Cols;
+            for (int32 c = 0; c < RowCols; ++c)
+            {
+                const float u = (r + Rng.GetFraction()) / Rows;
+                const float v = (c + Rng.GetFraction()) / RowCols;
+                OutDirs.Add(TF_HemisphereDir(u, v, bCosineWeighted));
+                OutWeights.Add(1.f);
+            }
+        }
+        break;
+    }
+
+    case EThermoSkyDirections::Fibonacci:
+    {
+        const float Golden = 0.5f * (3.f - FMath::Sqrt(5.f)); // fraction of a turn per step
+        for (int32 i = 0; i < Count; ++i)
+        {
+            const float u = (i + 0.5f) / Count;
+            const float v = FMath::Frac(i * Golden);
+            OutDirs.Add(TF_HemisphereDir(u, v, bCosineWeighted));
+            OutWeights.Add(1.f);
+        }
+        break;
+    }
+    }
+
+    float Sum = 0.f;
+    for (float w : OutWeights) Sum += w;
+    for (float& w : OutWeights) w /= FMath::Max(1e-6f, Sum);
 }
@@ -0,0 +1,103 @@
+﻿#include "ThermoForgeSnapshot.h"
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeStats.h"
+
+bool FThermoForgeFieldSnapshot::FindNearestCell(const FVector& WorldPos, FThermoForgeSnapshotSample& Out) const
+{
+    if (Dim.X <= 0 || Dim.Y <= 0 || Dim.Z <= 0 || CellSizeCm <= 0.f) return false;
+
+    const FVector LocalGrid = InvFrame.TransformPosition(WorldPos) / CellSizeCm;
+    const int32 ix = FMath::Clamp(FMath::FloorToInt(LocalGrid.X + 0.5f), 0, Dim.X - 1);
+    const int32 iy = FMath::Clamp(FMath::FloorToInt(LocalGrid.Y + 0.5f), 0, Dim.Y - 1);
+    const int32 iz = FMath::Clamp(FMath::FloorToInt(LocalGrid.Z + 0.5f), 0, Dim.Z - 1);
+    const int32 Linear = (iz * Dim.Y + iy) * Dim.X + ix;
+
+    Out.bFound       = true;
+    Out.GridIndex    = FIntVector(ix, iy, iz);
+    Out.LinearIndex  = Linear;
+    Out.CellCenterWS = Frame.TransformPosition(FVector((ix + 0.5f) * CellSizeCm, (iy + 0.5f) * CellSizeCm, (iz + 0.5f) * CellSizeCm));
+    Out.DistanceSq   = FVector::DistSquared(Out.CellCenterWS, WorldPos);
+    Out.Sky          = FMath::Clamp(SkyView01[Linear], 0.f, 1.f);
+    Out.WallPerm     = FMath::Clamp(WallPermeability01[Linear], 0.f, 1.f);
+
+    Out.bClimateOverride = ClimateBlend.IsValidIndex(Linear);
+    if (Out.bClimateOverride)
+        Out.Climate = FThermoForgeClimate::UnpackBlend(ClimateBlend[Linear], ClimatePalette);
+
+    Out.bSunVisibility = SunVisibilityL1.IsValidIndex(Linear);
+    if (Out.bSunVisibility)
+        Out.SunVisibilityL1 = SunVisibilityL1[Linear];
+    return true;
+}
+
+bool FThermoForgeSnapshotVolume::Contains(const FVector& WorldPos) const
+{
+    if (bUnbounded) return true;
+
+    const FVector L = Transform.InverseTransformPosition(WorldPos);
+    return FMath::Abs(L.X) <= BoxExtent.X && FMath::Abs(L.Y) <= BoxExtent.Y && FMath::Abs(L.Z) <= BoxExtent.Z;
+}
+
+bool FThermoForgeWorldSnapshot::FindNearestCell(const FVector& WorldPos, FThermoForgeSnapshotSample& Out) const
+{
+    Out = FThermoForgeSnapshotSample();
+
+    for (const FThermoForgeSnapshotVolume& V : Volumes)
+        if (V.bChunk && V.Contains(WorldPos) && V.Field->FindNearestCell(WorldPos, Out))
+            return true;
+
+    bool bContained = false;
+    for (const FThermoForgeSnapshotVolume& V : Volumes)
+    {
+        FThermoForgeSnapshotSample Hit;
+        if (!V.bChunk && V.Contains(WorldPos) && V.Field->FindNearestCell(WorldPos, Hit) && (!bContained || Hit.DistanceSq < Out.DistanceSq))
+        {
+            Out = Hit;
+            bContained = true;
+        }
+    }
+    if (bContained) return true;
+
+    for (const FThermoForgeSnapshotVolume& V : Volumes)
+    {
+        FThermoForgeSnapshotSample Hit;
+        if (V.Field->FindNearestCell(WorldPos, Hit) && (!Out.bFound || Hit.DistanceSq < Out.DistanceSq))
+            Out = Hit;
+    }
+    return Out.bFound;
+}
+
+FThermoForgeWeatherSample FThermoForgeWorldSnapshot::SampleWeatherAt(const FVector& WorldPos) const
+{
+    if (Weather.IsValid()) return Weather->Sample(WorldPos);
+
+    FThermoForgeWeatherSample Out;
+    Out.CloudCover01 = WeatherAlpha01;
+    return Out;
+}
+
+float FThermoForgeWorldSnapshot::ComputeTemperatureAt(const FVector& WorldPos, FThermoForgeTraceContext* TraceContext) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Query);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::SnapshotTemperatureAt);
+    INC_DWORD_STAT(STAT_ThermoForge_Queries);
+
+    // Outside every field: open sky is unknown, keep Sky=0 / WallPerm=1 like ComputeCurrentTemperatureAt
+    FThermoForgeSnapshotSample Sample;
+    FindNearestCell(WorldPos, Sample);
+
+    const FThermoForgeClimate& C = Sample.bClimateOverride ? Sample.Climate : DefaultClimate;
+    const FThermoForgeWeatherSample W = SampleWeatherAt(WorldPos);
+    const float AmbientC = Climate.AmbientAt(C, WorldPos.Z) + W.GetAmbientOffsetC(Settings ? Settings->PrecipitationCoolingC : 0.f);
+    const float Sky = Sample.bSunVisibility ? FThermoForgeSunVisibility::Exposure(Sample.SunVisibilityL1, Climate.SunDirection) : Sample.Sky;
+    return UThermoForgeSubsystem::ComposeTemperature(Settings, TraceContext, WorldPos, Sky, Sample.WallPerm, AmbientC,
+                                                     W.GetWeatherAlpha01(), Sources, &C);
+}
+
+FThermoForgeTraceContext FThermoForgeWorldSnapshot::MakeTraceContext() const
+{
+    FThermoForgeTraceContext Ctx(World, Settings);
+    Ctx.SharedDensityCache = DensityCache;
+    return Ctx;
+}
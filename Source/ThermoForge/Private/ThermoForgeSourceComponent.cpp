@@ -39,44 +39,77 @@ static float PointFalloffWeight(EThermoSourceFalloff F, float Distance, float Ra
     }
 }
 
-FBox UThermoForgeSourceComponent::GetBoundsWS() const
+/** d(weight)/d(distance) of PointFalloffWeight; the step at the radius is ignored. */
+static float PointFalloffSlope(EThermoSourceFalloff F, float Distance, float Radius)
 {
-    const FTransform T = GetOwnerTransformSafe();
-    const FVector    L = GetOwnerLocationSafe();
-    const float scale = bAffectByOwnerScale ? T.GetMaximumAxisScale() : 1.f;
+    if (Radius <= KINDA_SMALL_NUMBER) return 0.f;
+    if (Distance >= Radius) return 0.f;
 
-    if (Shape == EThermoSourceShape::Point)
-    {
-        return FBox::BuildAABB(L, FVector(RadiusCm * scale));
-    }
-    else
+    switch (F)
     {
-        const FVector Ext = bAffectByOwnerScale ? (BoxExtent * scale) : BoxExtent;
-        const FBox Local(-Ext, Ext);
-        return Local.TransformBy(T);
+        case EThermoSourceFalloff::None:   return 0.f;
+        case EThermoSourceFalloff::Linear: return -1.f / Radius;
+        case EThermoSourceFalloff::InverseSquare:
+        default:
+        {
+            const float x = Distance / Radius;
+            const float d = 1.f + x * x;
+            return -2.f * x / (Radius * d * d);
+        }
     }
 }
 
+FThermoForgeSourceState UThermoForgeSourceComponent::MakeState() const
+{
+    const FTransform T = GetOwnerTransformSafe();
+    const float scale = bAffectByOwnerScale ? T.GetMaximumAxisScale() : 1.f;
+
+    FThermoForgeSourceState St;
+    St.Shape            = Shape;
+    St.Falloff          = Falloff;
+    St.IntensityCelsius = bEnabled ? IntensityCelsius : 0.f;
+    St.RadiusCm         = RadiusCm * scale;
+    St.BoxExtent        = bAffectByOwnerScale ? (BoxExtent * scale) : BoxExtent;
+    St.Transform        = T;
+    return St;
+}
+
+FBox UThermoForgeSourceComponent::GetBoundsWS() const
+{
+    return MakeState().GetBoundsWS();
+}
+
 float UThermoForgeSourceComponent::SampleAt(const FVector& P) const
 {
     if (!bEnabled) return 0.f;
+    return MakeState().SampleAt(P);
+}
 
-    const FTransform T = GetOwnerTransformSafe();
-    const FVector    L = T.GetLocation();
-    const float      scale = bAffectByOwnerScale ? T.GetMaximumAxisScale() : 1.f;
+// ---- plain-data evaluation (game thread or workers) ----
+FBox FThermoForgeSourceState::GetBoundsWS() const
+{
+    if (Shape == EThermoSourceShape::Point)
+    {
+        return FBox::BuildAABB(Transform.GetLocation(), FVector(RadiusCm));
+    }
+    const FBox Local(-BoxExtent, BoxExtent);
+    return Local.TransformBy(Transform);
+}
+
+float FThermoForgeSourceState::SampleAt(const FVector& P) const
+{
+    if (IntensityCelsius == 0.f) return 0.f;
 
     if (Shape == EThermoSourceShape::Point)
     {
-        const float R = RadiusCm * scale;
-        const float d = FVector::Distance(P, L);
-        const float w = PointFalloffWeight(Falloff, d, R);
+        const float d = FVector::Distance(P, Transform.GetLocation());
+        const float w = PointFalloffWeight(Falloff, d, RadiusCm);
         return IntensityCelsius * w;
     }
     else
     {
-        const FVector Ext = bAffectByOwnerScale ? (BoxExtent * scale) : BoxExtent;
-        const FVector LocalP = T.InverseTransformPosition(P);
-        const FVector Min = -Ext, Max = Ext;
+        const FVector LocalP = Transform.InverseTransformPosition(P);
+        const FVector Min = -BoxExtent, Max = BoxExtent;
 
         const bool bInside =
             (LocalP.X >= Min.X && LocalP.X <= Max.X) &&
@@ -87,6 +120,19 @@ float UThermoForgeSourceComponent::SampleAt(const FVector& P) const
     }
 }
 
+float FThermoForgeSourceState::SampleAt(const FVector& P, FVector& OutGradient) const
+{
+    OutGradient = FVector::ZeroVector;
+    if (IntensityCelsius == 0.f) return 0.f;
+    if (Shape != EThermoSourceShape::Point) return SampleAt(P);
+
+    const FVector Delta = P - Transform.GetLocation();
+    const float d = Delta.Size();
+    if (d > KINDA_SMALL_NUMBER)
+        OutGradient = Delta * (IntensityCelsius * PointFalloffSlope(Falloff, d, RadiusCm) / d);
+    return IntensityCelsius * PointFalloffWeight(Falloff, d, RadiusCm);
+}
+
 void UThermoForgeSourceComponent::OnRegister()
 {
     Super::OnRegister();
@@ -0,0 +1,226 @@
+﻿#include "ThermoForgeStateReplicator.h"
+
+#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeSubsystem.h"
+
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+// ---- wire item ----
+static FVector TF_RoundCm(const FVector& V)
+{
+    return FVector(FMath::RoundToDouble(V.X), FMath::RoundToDouble(V.Y), FMath::RoundToDouble(V.Z));
+}
+
+static FVector TF_RoundCenti(const FVector& V)
+{
+    return TF_RoundCm(V * 100.0) / 100.0;
+}
+
+bool FThermoForgeReplicatedSource::SetFromSource(const UThermoForgeSourceComponent& InSource)
+{
+    const FTransform T   = InSource.GetOwnerTransformSafe();
+    const FRotator   Rot = T.Rotator();
+
+    bool bChanged = false;
+    auto Assign = [&bChanged](auto& Dst, const auto& Src)
+    {
+        if (Dst == Src) return;
+        Dst = Src;
+        bChanged = true;
+    };
+
+    // Compare after quantizing, so sub-step jitter never dirties the item
+    Assign(bEnabled,            InSource.bEnabled);
+    Assign(Shape,               InSource.Shape);
+    Assign(Falloff,             InSource.Falloff);
+    Assign(IntensityDeciC,      (int16)FMath::Clamp(FMath::RoundToInt(InSource.IntensityCelsius * 10.f), -32767, 32767));
+    Assign(RadiusCm,            (uint16)FMath::Clamp(FMath::RoundToInt(InSource.RadiusCm), 0, 65535));
+    Assign(BoxExtent,           FVector_NetQuantize(TF_RoundCm(InSource.BoxExtent)));
+    Assign(bAffectByOwnerScale, InSource.bAffectByOwnerScale);
+    Assign(Location,            FVector_NetQuantize(TF_RoundCm(T.GetLocation())));
+    Assign(Pitch,               FRotator::CompressAxisToShort(Rot.Pitch));
+    Assign(Yaw,                 FRotator::CompressAxisToShort(Rot.Yaw));
+    Assign(Roll,                FRotator::CompressAxisToShort(Rot.Roll));
+    Assign(OwnerScale,          FVector_NetQuantize100(TF_RoundCenti(T.GetScale3D())));
+    return bChanged;
+}
+
+FThermoForgeSourceState FThermoForgeReplicatedSource::ToState() const
+{
+    const FRotator Rot(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), FRotator::DecompressAxisFromShort(Roll));
+    const FTransform T(Rot, Location, OwnerScale);
+    const float scale = bAffectByOwnerScale ? T.GetMaximumAxisScale() : 1.f;
+
+    // Mirrors UThermoForgeSourceComponent::MakeState
+    FThermoForgeSourceState St;
+    St.Shape            = Shape;
+    St.Falloff          = Falloff;
+    St.IntensityCelsius = bEnabled ? IntensityDeciC * 0.1f : 0.f;
+    St.RadiusCm         = RadiusCm * scale;
+    St.BoxExtent        = bAffectByOwnerScale ? (FVector(BoxExtent) * scale) : FVector(BoxExtent);
+    St.Transform        = T;
+    return St;
+}
+
+void FThermoForgeReplicatedSource::ApplyTo(UThermoForgeSourceComponent& Target) const
+{
+    Target.bEnabled            = bEnabled;
+    Target.Shape               = Shape;
+    Target.Falloff             = Falloff;
+    Target.IntensityCelsius    = IntensityDeciC * 0.1f;
+    Target.RadiusCm            = RadiusCm;
+    Target.BoxExtent           = BoxExtent;
+    Target.bAffectByOwnerScale = bAffectByOwnerScale;
+}
+
+void FThermoForgeReplicatedSource::PostReplicatedAdd(const FThermoForgeReplicatedSourceArray& InArraySerializer)
+{
+    if (InArraySerializer.Owner) InArraySerializer.Owner->ApplyReplicatedSource(*this);
+}
+
+void FThermoForgeReplicatedSource::PostReplicatedChange(const FThermoForgeReplicatedSourceArray& InArraySerializer)
+{
+    if (InArraySerializer.Owner) InArraySerializer.Owner->ApplyReplicatedSource(*this);
+}
+
+void FThermoForgeReplicatedSource::PreReplicatedRemove(const FThermoForgeReplicatedSourceArray& InArraySerializer)
+{
+    if (InArraySerializer.Owner) InArraySerializer.Owner->RemoveReplicatedSource(*this);
+}
+
+// ---- actor ----
+AThermoForgeStateReplicator::AThermoForgeStateReplicator()
+{
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = true;
+
+    bReplicates     = true;
+    bAlwaysRelevant = true;
+    SetReplicatingMovement(false);
+
+    Sources.Owner = this;
+}
+
+void AThermoForgeStateReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+    DOREPLIFETIME(AThermoForgeStateReplicator, Sources);
+}
+
+void AThermoForgeStateReplicator::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+    Sources.Owner = this;
+
+    const UThermoForgeProjectSettings* S = GetDefault<UThermoForgeProjectSettings>();
+    const float RateHz = S ? FMath::Max(0.5f, S->ReplicationRateHz) : 10.f;
+    SetNetUpdateFrequency(RateHz);
+    SetActorTickInterval(1.f / RateHz);
+
+    // The server's own spawn registers through the subsystem; this covers the replicated copy on clients
+    if (UWorld* W = GetWorld())
+        if (auto* SS = W->GetSubsystem<UThermoForgeSubsystem>())
+            if (!SS->GetStateReplicator())
+                SS->SetStateReplicator(this);
+}
+
+void AThermoForgeStateReplicator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UWorld* W = GetWorld())
+        if (auto* SS = W->GetSubsystem<UThermoForgeSubsystem>())
+        {
+            if (!HasAuthority())
+                for (const FThermoForgeReplicatedSource& Item : Sources.Items)
+                    SS->RemoveReplicatedSource(Item.SourceId);
+
+            if (SS->GetStateReplicator() == this)
+                SS->SetStateReplicator(nullptr);
+        }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AThermoForgeStateReplicator::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+    if (HasAuthority())
+        SyncFromSubsystem();
+}
+
+void AThermoForgeStateReplicator::SyncFromSubsystem()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ReplicationSync);
+
+    UWorld* W = GetWorld();
+    UThermoForgeSubsystem* Sub = W ? W->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!Sub) return;
+
+    TArray<UThermoForgeSourceComponent*> Live;
+    Sub->GetAllSources(Live);
+
+    TMap<int32, int32> ItemById;
+    ItemById.Reserve(Sources.Items.Num());
+    for (int32 i = 0; i < Sources.Items.Num(); ++i)
+        ItemById.Add(Sources.Items[i].SourceId, i);
+
+    TSet<int32> Seen;
+    Seen.Reserve(Live.Num());
+    for (UThermoForgeSourceComponent* Source : Live)
+    {
+        int32& Id = SourceIds.FindOrAdd(Source, INDEX_NONE);
+        if (Id == INDEX_NONE) Id = NextSourceId++;
+        Seen.Add(Id);
+
+        if (const int32* Idx = ItemById.Find(Id))
+        {
+            FThermoForgeReplicatedSource& Item = Sources.Items[*Idx];
+            if (Item.SetFromSource(*Source))
+                Sources.MarkItemDirty(Item);
+            continue;
+        }
+
+        FThermoForgeReplicatedSource& Item = Sources.Items.AddDefaulted_GetRef();
+        Item.SourceId = Id;
+        Item.Source   = Source;
+        Item.SetFromSource(*Source);
+        Sources.MarkItemDirty(Item);
+    }
+
+    // Unregistered or destroyed sources
+    const int32 Removed = Sources.Items.RemoveAll([&Seen](const FThermoForgeReplicatedSource& Item)
+    {
+        return !Seen.Contains(Item.SourceId);
+    });
+    if (Removed > 0)
+        Sources.MarkArrayDirty();
+
+    for (auto It = SourceIds.CreateIterator(); It; ++It)
+        if (!Seen.Contains(It.Value()))
+            It.RemoveCurrent();
+}
+
+void AThermoForgeStateReplicator::ApplyReplicatedSource(const FThermoForgeReplicatedSource& Item)
+{
+    UWorld* W = GetWorld();
+    UThermoForgeSubsystem* Sub = W ? W->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!Sub) return;
+
+    if (UThermoForgeSourceComponent* Target = Item.Source.Get())
+    {
+        // The component may have resolved after its first update arrived as a proxy
+        Sub->RemoveReplicatedSource(Item.SourceId);
+        Item.ApplyTo(*Target);
+        Sub->MarkSourceDirty(Target);
+        return;
+    }
+
+    Sub->SetReplicatedSource(Item.SourceId, Item.ToState());
+}
+
+void AThermoForgeStateReplicator::RemoveReplicatedSource(const FThermoForgeReplicatedSource& Item)
+{
+    UWorld* W = GetWorld();
+    if (UThermoForgeSubsystem* Sub = W ? W->GetSubsystem<UThermoForgeSubsystem>() : nullptr)
+        Sub->RemoveReplicatedSource(Item.SourceId);
+}
@@ -3,23 +3,42 @@
 #include "ThermoForgeFieldAsset.h"
 #include "ThermoForgeVolume.h"
 #include "ThermoForgeSourceComponent.h"
+#include "ThermoForgeOccupancyGrid.h"
+#include "ThermoForgeFieldChunk.h"
+#include "ThermoForgeSnapshot.h"
+#include "ThermoForgeWatchComponent.h"
+#include "ThermoForgeStateReplicator.h"
+#include "ThermoForgeWeatherActor.h"
+#include "ThermoForgeStats.h"
+#include "ThermoForgeDeterministicMath.h"
 
 #include "EngineUtils.h"
 #include "Engine/World.h"
 #include "CollisionQueryParams.h"
 #include "DrawDebugHelpers.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeRWLock.h"
 
 #include "UObject/SavePackage.h"
 #include "Misc/PackageName.h"
 #include "Misc/Paths.h"
 #include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "PhysicsEngine/BodySetup.h"
 
 #if WITH_EDITOR
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetToolsModule.h"
 #include "PackageTools.h"
+#include "WorldPartition/DataLayer/DataLayerInstance.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionHandle.h"
+#include "WorldPartition/WorldPartitionHelpers.h"
+#include "WorldPartition/WorldPartitionActorDescInstance.h"
 #endif
 
 // ---- settings access ----
@@ -31,14 +50,75 @@ const UThermoForgeProjectSettings* UThermoForgeSubsystem::GetSettings() const
 void UThermoForgeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
+
+    DensityCache = MakeShared<FThermoForgeDensityCache, ESPMode::ThreadSafe>();
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    ClockMode      = S ? S->ClockMode : EThermoClockMode::RealTime;
+    ClockTimeScale = S ? S->ClockTimeScale : 1.f;
+    const bool bWallClock = ClockMode == EThermoClockMode::RealTime && !(S && S->bDeterministicComposition);
+    ClockTerms = FThermoForgeClimateTerms::Compute(S, bWallClock ? FDateTime::UtcNow() : (S ? S->ClockStartUTC : FDateTime(2000, 6, 21, 12)));
+    WeatherClockUTC = ClockTerms.TimeUTC;
+#if WITH_EDITOR
+    ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UThermoForgeSubsystem::HandleObjectPropertyChanged);
+#endif
 }
 
 void UThermoForgeSubsystem::Deinitialize()
 {
+    // The composition task reads settings and traces against this world; let it finish first.
+    PendingCompositionTask.Wait();
+    PendingComposition.Reset();
+    ComposedChannels.Empty();
+
+    PendingWatchTask.Wait();
+    PendingWatchPass.Reset();
+    Watches.Empty();
+    SET_DWORD_STAT(STAT_ThermoForge_Watches, 0);
+
+    PendingWeatherTask.Wait();
+    PendingWeather.Reset();
+    WeatherField.Reset();
+    WeatherActor.Reset();
+
+    // Readers that pinned a snapshot keep it; nobody can acquire one from here on
+    {
+        FWriteScopeLock Lock(SnapshotLock);
+        PublishedSnapshot.Reset();
+    }
+    FieldSnapshots.Empty();
+
     SourceSet.Empty();
+    ReplicatedSources.Empty();
+    StateReplicator.Reset();
+
+#if WITH_EDITOR
+    FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
     Super::Deinitialize();
 }
 
+void UThermoForgeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Clients get the actor through replication; standalone has nobody to send to
+    const UThermoForgeProjectSettings* S = GetSettings();
+    const ENetMode NetMode = InWorld.GetNetMode();
+    if (!S || !S->bReplicateThermalState || StateReplicator.IsValid()) return;
+    if (NetMode != NM_DedicatedServer && NetMode != NM_ListenServer) return;
+
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    Params.ObjectFlags |= RF_Transient;
+    StateReplicator = InWorld.SpawnActor<AThermoForgeStateReplicator>(Params);
+}
+
+TStatId UThermoForgeSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UThermoForgeSubsystem, STATGROUP_Tickables);
+}
+
 void UThermoForgeSubsystem::RegisterSource(UThermoForgeSourceComponent* Source)
 {
     if (!IsValid(Source)) return;
@@ -60,6 +140,137 @@ void UThermoForgeSubsystem::MarkSourceDirty(UThermoForgeSourceComponent* /*Sourc
     OnSourcesChanged.Broadcast();
 }
 
+void UThermoForgeSubsystem::RegisterWatch(UThermoForgeWatchComponent* Watch)
+{
+    if (!IsValid(Watch)) return;
+    Watches.AddUnique(Watch);
+    SET_DWORD_STAT(STAT_ThermoForge_Watches, Watches.Num());
+}
+
+void UThermoForgeSubsystem::UnregisterWatch(UThermoForgeWatchComponent* Watch)
+{
+    Watches.RemoveSingleSwap(Watch);
+    SET_DWORD_STAT(STAT_ThermoForge_Watches, Watches.Num());
+}
+
+void UThermoForgeSubsystem::RegisterWeather(AThermoForgeWeatherActor* Weather)
+{
+    if (!IsValid(Weather)) return;
+    if (const AThermoForgeWeatherActor* Current = WeatherActor.Get(); Current && Current != Weather)
+        UE_LOG(LogThermoForge, Warning, TEXT("%s replaces %s as the active weather actor"), *Weather->GetName(), *Current->GetName());
+
+    PendingWeatherTask.Wait();
+    PendingWeather.Reset();
+
+    WeatherActor       = Weather;
+    WeatherField       = MakeShared<const FThermoForgeWeatherField, ESPMode::ThreadSafe>(Weather->MakeInitialField());
+    WeatherAccumulator = 0.f;
+    WeatherClockUTC    = ClockTerms.TimeUTC; // the initial field is "now"; don't replay steps since the last actor
+}
+
+void UThermoForgeSubsystem::UnregisterWeather(AThermoForgeWeatherActor* Weather)
+{
+    if (WeatherActor.Get() != Weather) return;
+
+    PendingWeatherTask.Wait();
+    PendingWeather.Reset();
+    WeatherActor.Reset();
+    WeatherField.Reset();
+}
+
+FThermoForgeWeatherSample UThermoForgeSubsystem::SampleWeatherAt(const FVector& WorldPos) const
+{
+    if (WeatherField.IsValid()) return WeatherField->Sample(WorldPos);
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    FThermoForgeWeatherSample Out;
+    Out.CloudCover01 = S ? S->DefaultWeatherAlpha01 : 0.3f;
+    return Out;
+}
+
+void UThermoForgeSubsystem::GetWeatherAt(const FVector& WorldPos, float& OutCloudCover01, float& OutPrecipitation01) const
+{
+    const FThermoForgeWeatherSample W = SampleWeatherAt(WorldPos);
+    OutCloudCover01    = W.CloudCover01;
+    OutPrecipitation01 = W.Precipitation01;
+}
+
+void UThermoForgeSubsystem::UpdateWeather(float DeltaTime, const UThermoForgeProjectSettings* S)
+{
+    // Publish a finished step; readers holding the previous field keep it alive. Deterministic mode always
+    // publishes the tick after launch, however long the step took.
+    if (PendingWeather.IsValid() && (PendingWeatherTask.IsCompleted() || S->bDeterministicComposition))
+    {
+        PendingWeatherTask.Wait();
+        WeatherField = PendingWeather;
+        PendingWeather.Reset();
+        PendingWeatherTask = UE::Tasks::FTask();
+    }
+
+    AThermoForgeWeatherActor* Weather = WeatherActor.Get();
+    if (!Weather || !WeatherField.IsValid())
+    {
+        WeatherAccumulator = 0.f;
+        WeatherClockUTC    = ClockTerms.TimeUTC;
+        return;
+    }
+
+    float Dt = 0.f;
+    int32 NumSteps = 1;
+    if (S->bDeterministicComposition)
+    {
+        // Fixed steps of thermal-clock time, as many as the clock moved: the same clock gives the same field on every
+        // machine, whatever the frame times. Steps past the cap (clock jumps) are dropped; the field has relaxed by then.
+        constexpr int64 MaxSteps = 64;
+        const FTimespan Step = FTimespan::FromMilliseconds(FMath::Max(1.0, FMath::RoundToDouble(1000.0 / FMath::Max(0.1f, S->WeatherUpdateRateHz))));
+        const FDateTime Now = ClockTerms.TimeUTC;
+        if (Now < WeatherClockUTC) WeatherClockUTC = Now;
+        if (PendingWeather.IsValid()) return;
+
+        const int64 Elapsed = (Now - WeatherClockUTC).GetTicks() / Step.GetTicks();
+        if (Elapsed <= 0) return;
+        WeatherClockUTC += FTimespan(Step.GetTicks() * Elapsed);
+        NumSteps = (int32)FMath::Min(Elapsed, MaxSteps);
+        Dt = (float)Step.GetTotalSeconds();
+    }
+    else
+    {
+        WeatherAccumulator += DeltaTime;
+        if (PendingWeather.IsValid() || WeatherAccumulator < 1.f / FMath::Max(0.1f, S->WeatherUpdateRateHz)) return;
+
+        Dt = WeatherAccumulator;
+        WeatherAccumulator = 0.f;
+    }
+
+    // Inputs are copied here; the step reads only the immutable previous field
+    TArray<FThermoForgeWeatherStamp> Stamps;
+    Weather->TakePendingStamps(Stamps);
+
+    const FVector2D Wind = Weather->WindCmPerSec;
+    const float Decay = Weather->RelaxationMinutes > 0.f ? Dt / (Weather->RelaxationMinutes * 60.f) : 0.f;
+    const float Relax = 1.f - (S->bDeterministicComposition ? FThermoForgeDeterministicMath::ExpNeg(-Decay) : FMath::Exp(-Decay));
+
+    TSharedPtr<const FThermoForgeWeatherField, ESPMode::ThreadSafe> Previous = WeatherField;
+    TSharedPtr<FThermoForgeWeatherField, ESPMode::ThreadSafe> Next = MakeShared<FThermoForgeWeatherField, ESPMode::ThreadSafe>();
+    PendingWeather = Next;
+    PendingWeatherTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Previous, Next, Stamps = MoveTemp(Stamps), Wind, Dt, Relax, NumSteps]()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::AdvectWeather);
+
+        // Intermediate steps ping-pong between two scratch fields; the last one lands in Next
+        FThermoForgeWeatherField Scratch[2];
+        const FThermoForgeWeatherField* In = Previous.Get();
+        for (int32 i = 0; i < NumSteps; ++i)
+        {
+            FThermoForgeWeatherField& Out = (i == NumSteps - 1) ? *Next : Scratch[i & 1];
+            FThermoForgeWeatherField::Advect(*In, Wind, Dt, Relax, Out);
+            In = &Out;
+        }
+        for (const FThermoForgeWeatherStamp& Stamp : Stamps)
+            Next->Stamp(Stamp);
+    });
+}
+
 int32 UThermoForgeSubsystem::GetSourceCount() const
 {
     int32 Count = 0;
@@ -76,478 +287,2546 @@ void UThermoForgeSubsystem::GetAllSources(TArray<UThermoForgeSourceComponent*>&
             OutSources.Add(S);
 }
 
-// ---- physmat helpers ----
-static UPhysicalMaterial* TF_ResolvePhysicalMaterial(const FHitResult& Hit)
-{
-    if (UPhysicalMaterial* PM = Hit.PhysMaterial.Get()) return PM;
+// Lexicographic over every field SampleAt reads, so only sources that compose identically compare equal
+static bool TF_SourceStateLess(const FThermoForgeSourceState& A, const FThermoForgeSourceState& B)
+{
+    auto Key = [](const FThermoForgeSourceState& S, double (&Out)[17])
+    {
+        const FVector P = S.Transform.GetLocation(), Sc = S.Transform.GetScale3D();
+        const FQuat   Q = S.Transform.GetRotation();
+        const double K[17] = { P.X, P.Y, P.Z, S.IntensityCelsius, S.RadiusCm, double(S.Shape), double(S.Falloff),
+                               S.BoxExtent.X, S.BoxExtent.Y, S.BoxExtent.Z, Q.X, Q.Y, Q.Z, Q.W, Sc.X, Sc.Y, Sc.Z };
+        FMemory::Memcpy(Out, K, sizeof(K));
+    };
+
+    double KA[17], KB[17];
+    Key(A, KA);
+    Key(B, KB);
+    for (int32 i = 0; i < 17; ++i)
+        if (KA[i] != KB[i]) return KA[i] < KB[i];
+    return false;
+}
+
+void UThermoForgeSubsystem::GatherSourceStates(TArray<FThermoForgeSourceState>& OutStates) const
+{
+    OutStates.Reset();
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Sc = W.Get();
+        if (!Sc || !Sc->bEnabled) continue;
+        OutStates.Add(Sc->MakeState());
+    }
+
+    for (const TPair<int32, FThermoForgeSourceState>& R : ReplicatedSources)
+        if (R.Value.IntensityCelsius != 0.f)
+            OutStates.Add(R.Value);
+
+    // Set order follows pointer hashes; a float sum has to see the sources in the same order on every machine
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (S && S->bDeterministicComposition)
+        OutStates.StableSort(TF_SourceStateLess);
+}
+
+void UThermoForgeSubsystem::SetReplicatedSource(int32 SourceId, const FThermoForgeSourceState& State)
+{
+    ReplicatedSources.Add(SourceId, State);
+    OnSourcesChanged.Broadcast();
+}
+
+void UThermoForgeSubsystem::RemoveReplicatedSource(int32 SourceId)
+{
+    if (ReplicatedSources.Remove(SourceId) > 0)
+        OnSourcesChanged.Broadcast();
+}
+
+// ---- streamed field chunks ----
+void UThermoForgeSubsystem::RegisterFieldChunk(AThermoForgeFieldChunk* Chunk)
+{
+    if (!IsValid(Chunk) || !Chunk->Field || Chunk->ChunkCells <= 0 || Chunk->CellSizeCm <= 0.f) return;
+
+    FThermoForgeChunkLayer& Layer = ChunkLayers.FindOrAdd(Chunk->SourceVolume);
+    Layer.InvFrame   = Chunk->LayerFrame.Inverse();
+    Layer.CellSizeCm = Chunk->CellSizeCm;
+    Layer.ChunkCells = Chunk->ChunkCells;
+    Layer.Chunks.Add(Chunk->ChunkCoord, Chunk);
+    SET_DWORD_STAT(STAT_ThermoForge_LoadedChunks, GetLoadedFieldChunkCount());
+}
+
+void UThermoForgeSubsystem::UnregisterFieldChunk(AThermoForgeFieldChunk* Chunk)
+{
+    if (!Chunk) return;
+
+    FThermoForgeChunkLayer* Layer = ChunkLayers.Find(Chunk->SourceVolume);
+    if (!Layer) return;
+
+    const TWeakObjectPtr<AThermoForgeFieldChunk>* Registered = Layer->Chunks.Find(Chunk->ChunkCoord);
+    if (Registered && Registered->Get() == Chunk)
+        Layer->Chunks.Remove(Chunk->ChunkCoord);
+    if (Layer->Chunks.Num() == 0)
+        ChunkLayers.Remove(Chunk->SourceVolume);
+    SET_DWORD_STAT(STAT_ThermoForge_LoadedChunks, GetLoadedFieldChunkCount());
+}
+
+const AThermoForgeFieldChunk* UThermoForgeSubsystem::FindFieldChunkAt(const FVector& WorldPos) const
+{
+    for (const TPair<FName, FThermoForgeChunkLayer>& It : ChunkLayers)
+    {
+        const FThermoForgeChunkLayer& Layer = It.Value;
+        const FVector L = Layer.InvFrame.TransformPosition(WorldPos) / (Layer.CellSizeCm * Layer.ChunkCells);
+        const TWeakObjectPtr<AThermoForgeFieldChunk>* Chunk = Layer.Chunks.Find(FIntPoint(FMath::FloorToInt(L.X), FMath::FloorToInt(L.Y)));
+        if (!Chunk) continue;
+
+        // Chunks span the volume's baked height only
+        const AThermoForgeFieldChunk* C = Chunk->Get();
+        if (!C || !C->Field) continue;
+        const float Z = C->Field->GetGridFrame().InverseTransformPosition(WorldPos).Z;
+        if (Z >= 0.f && Z <= C->Field->Dim.Z * C->Field->CellSizeCm)
+            return C;
+    }
+    return nullptr;
+}
+
+int32 UThermoForgeSubsystem::GetLoadedFieldChunkCount() const
+{
+    int32 Count = 0;
+    for (const TPair<FName, FThermoForgeChunkLayer>& It : ChunkLayers)
+        Count += It.Value.Chunks.Num();
+    return Count;
+}
+
+// ---- physmat helpers ----
+static UPhysicalMaterial* TF_ResolveComponentPhysicalMaterial(const UPrimitiveComponent* PC)
+{
+    if (!PC) return nullptr;
+
+    if (PC->BodyInstance.GetSimplePhysicalMaterial())
+        return PC->BodyInstance.GetSimplePhysicalMaterial();
+    if (UBodySetup* BS = const_cast<UPrimitiveComponent*>(PC)->GetBodySetup())
+        if (BS->PhysMaterial)
+            return BS->PhysMaterial;
+    return nullptr;
+}
+
+static UPhysicalMaterial* TF_ResolvePhysicalMaterial(const FHitResult& Hit)
+{
+    if (UPhysicalMaterial* PM = Hit.PhysMaterial.Get()) return PM;
+    return TF_ResolveComponentPhysicalMaterial(Hit.GetComponent());
+}
+
+static float TF_DensityFromPhysMat(const UPhysicalMaterial* PM, const UThermoForgeProjectSettings* S)
+{
+    if (!S) return 1.f;
+
+    float Override = 0.f;
+    if (S->FindDensityOverride(PM, Override))
+        return Override;
+
+    if (S->bUsePhysicsMaterialForDensity && PM)
+    {
+        const float Found = PM->Density;
+        return FMath::Max(0.f, Found);
+    }
+    return S->bTreatMissingPhysMatAsAir ? S->AirDensityKgM3 : S->UnknownHitDensityKgM3;
+}
+
+static FORCEINLINE bool TF_NeedsPhysMat(const UThermoForgeProjectSettings* S)
+{
+    return S && (S->bUsePhysicsMaterialForDensity || S->DensityOverridesKgM3.Num() > 0);
+}
+
+static float TF_GetHitDensityKgM3(const FHitResult& Hit, const UThermoForgeProjectSettings* S)
+{
+    return TF_DensityFromPhysMat(TF_NeedsPhysMat(S) ? TF_ResolvePhysicalMaterial(Hit) : nullptr, S);
+}
+
+float UThermoForgeSubsystem::GetComponentDensityKgM3(const UPrimitiveComponent* Component, const UThermoForgeProjectSettings* S)
+{
+    return TF_DensityFromPhysMat(TF_NeedsPhysMat(S) ? TF_ResolveComponentPhysicalMaterial(Component) : nullptr, S);
+}
+
+// ---- density cache ----
+bool FThermoForgeDensityCache::Find(const FKey& Key, float& OutDensityKgM3) const
+{
+    FReadScopeLock ReadLock(Lock);
+    if (const float* Found = Map.Find(Key))
+    {
+        OutDensityKgM3 = *Found;
+        return true;
+    }
+    return false;
+}
+
+void FThermoForgeDensityCache::Add(const FKey& Key, float DensityKgM3)
+{
+    FWriteScopeLock WriteLock(Lock);
+    Map.Add(Key, DensityKgM3);
+}
+
+void FThermoForgeDensityCache::Reset()
+{
+    FWriteScopeLock WriteLock(Lock);
+    Map.Reset();
+}
+
+int32 FThermoForgeDensityCache::Num() const
+{
+    FReadScopeLock ReadLock(Lock);
+    return Map.Num();
+}
+
+void UThermoForgeSubsystem::ClearDensityCache()
+{
+    if (DensityCache.IsValid())
+        DensityCache->Reset();
+}
+
+#if WITH_EDITOR
+void UThermoForgeSubsystem::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& /*Event*/)
+{
+    // Anything that can change a resolved density: physmats, collision setups, the override table
+    if (Object && (Object->IsA<UPhysicalMaterial>() || Object->IsA<UBodySetup>() ||
+                   Object->IsA<UPrimitiveComponent>() || Object->IsA<UThermoForgeProjectSettings>()))
+    {
+        ClearDensityCache();
+    }
+}
+#endif
+
+// ---- trace context ----
+FThermoForgeTraceContext::FThermoForgeTraceContext(const UWorld* InWorld, const UThermoForgeProjectSettings* InSettings)
+    : World(InWorld)
+    , Settings(InSettings)
+    , Params(SCENE_QUERY_STAT(ThermoTrace), InSettings ? InSettings->bTraceComplex : true)
+{
+    if (Settings)
+    {
+        Channel    = static_cast<ECollisionChannel>(Settings->TraceChannel.GetValue());
+        CellSizeCm = Settings->DefaultCellSizeCm;
+    }
+    Params.bReturnPhysicalMaterial = true;
+}
+
+float FThermoForgeTraceContext::HitDensityKgM3(const FHitResult& InHit)
+{
+    const TPair<const UPrimitiveComponent*, const UPhysicalMaterial*> Key(InHit.GetComponent(), InHit.PhysMaterial.Get());
+    if (const float* Found = DensityCache.Find(Key))
+    {
+        ++NumCacheHits;
+        return *Found;
+    }
+
+    // World cache next, resolve through hit/body instance/body setup only on a miss there
+    const FThermoForgeDensityCache::FKey SharedKey(FObjectKey(Key.Key), FObjectKey(Key.Value));
+    float Density = 0.f;
+    if (!SharedDensityCache.IsValid() || !SharedDensityCache->Find(SharedKey, Density))
+    {
+        ++NumCacheMisses;
+        Density = TF_GetHitDensityKgM3(InHit, Settings);
+        if (SharedDensityCache.IsValid())
+            SharedDensityCache->Add(SharedKey, Density);
+    }
+    else
+    {
+        ++NumCacheHits;
+    }
+    return DensityCache.Add(Key, Density);
+}
+
+void FThermoForgeTraceContext::EmitStats() const
+{
+    INC_DWORD_STAT_BY(STAT_ThermoForge_OcclusionTraces,    (uint32)NumTraces);
+    INC_DWORD_STAT_BY(STAT_ThermoForge_DensityCacheHits,   (uint32)NumCacheHits);
+    INC_DWORD_STAT_BY(STAT_ThermoForge_DensityCacheMisses, (uint32)NumCacheMisses);
+}
+
+float FThermoForgeTraceContext::OpticalDepthBetween(const FVector& A, const FVector& B, float ThicknessRefCm)
+{
+    const float Len = FVector::Distance(A, B);
+    if (!IsValid() || Len <= UE_KINDA_SMALL_NUMBER) return 0.f;
+
+    const int32 MaxCrossings = FMath::Max(1, Settings->MaxOcclusionCrossings);
+    const float MaxDepth     = -FMath::Loge(FMath::Clamp(Settings->TransmittanceEpsilon, 1e-6f, 1.f));
+    const float Cell         = FMath::Max(1.f, ThicknessRefCm);
+    const float FaceL        = Settings->FaceThicknessFactor;
+    const FVector Dir        = (B - A) / Len;
+    constexpr float Nudge    = 0.5f; // cm; keeps component traces off the face they start from
+
+    // Entries: one scene pass, which reports a single (entry) hit per shape, sorted along the ray
+    ++NumTraces;
+    CrossingHits.Reset();
+    World->LineTraceMultiByChannel(CrossingHits, A, B, Channel, Params, CrossingResponse);
+    if (CrossingHits.Num() == 0) return 0.f;
+
+    // Exits and further walls come from traces against the entered component only (no broadphase)
+    auto TraceComponent = [&](UPrimitiveComponent* PC, float FromCm, float ToCm) -> bool
+    {
+        if (FMath::Abs(ToCm - FromCm) <= UE_KINDA_SMALL_NUMBER) return false;
+        ++NumTraces;
+        return PC->LineTraceComponent(Hit, A + Dir * FromCm, A + Dir * ToCm, Params) && !Hit.bStartPenetrating;
+    };
+    auto HitCm = [&]() { return (float)FVector::DotProduct(Hit.ImpactPoint - A, Dir); };
+
+    float Depth = 0.f;
+    int32 Integrated = 0;
+    TArray<const UPrimitiveComponent*, TInlineAllocator<8>> Done;
+    TArray<int32, TInlineAllocator<4>> Shapes;
+
+    for (int32 h = 0; h < CrossingHits.Num(); ++h)
+    {
+        UPrimitiveComponent* PC = CrossingHits[h].GetComponent();
+        if (!PC || Done.Contains(PC)) continue;
+        Done.Add(PC);
+
+        // Scene-pass entries of this component (compound bodies report one per shape)
+        Shapes.Reset();
+        for (int32 k = h; k < CrossingHits.Num(); ++k)
+            if (CrossingHits[k].GetComponent() == PC) Shapes.Add(k);
+
+        int32 NextShape = 1;
+        float EntryCm   = CrossingHits[h].Time * Len;
+        float Density   = HitDensityKgM3(CrossingHits[h]);
+        for (;;)
+        {
+            const float BoundCm = Shapes.IsValidIndex(NextShape) ? CrossingHits[Shapes[NextShape]].Time * Len : Len;
+
+            // Meshes report their back face walking forward from inside; simple shapes report nothing from inside,
+            // so walk back from the bound instead. No exit at all means the solid runs up to the bound.
+            float ExitCm = BoundCm;
+            if (TraceComponent(PC, EntryCm + Nudge, BoundCm) && FVector::DotProduct(Hit.ImpactNormal, Dir) > 0.f)
+                ExitCm = HitCm();
+            else if (BoundCm - Nudge > EntryCm && TraceComponent(PC, BoundCm - Nudge, EntryCm))
+                ExitCm = HitCm();
+
+            const float Thickness = ExitCm - EntryCm;
+            Depth += Settings->OpticalDepth(Density, Thickness > Nudge ? (Thickness / Cell) * FaceL : FaceL);
+            if (++Integrated >= MaxCrossings || Depth >= MaxDepth)
+                return FMath::Min(Depth, MaxDepth);
+
+            // Next solid of the same component: another wall of a mesh, else the next shape of a compound body
+            if (TraceComponent(PC, ExitCm + Nudge, BoundCm - Nudge) && FVector::DotProduct(Hit.ImpactNormal, Dir) <= 0.f)
+            {
+                EntryCm = HitCm();
+                Density = HitDensityKgM3(Hit);
+            }
+            else if (Shapes.IsValidIndex(NextShape))
+            {
+                const FHitResult& Next = CrossingHits[Shapes[NextShape++]];
+                EntryCm = Next.Time * Len;
+                Density = HitDensityKgM3(Next);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+    return FMath::Min(Depth, MaxDepth);
+}
+
+// single ray permeability (Beer–Lambert on hit)
+float FThermoForgeTraceContext::AmbientRay01(const FVector& P, const FVector& Dir, float MaxLen)
+{
+    if (!IsValid()) return 1.f;
+
+    if (Settings->bMultiHitOcclusion)
+        return Settings->OpticalDepthToPermeability(OpticalDepthBetween(P, P + Dir * MaxLen, CellSizeCm));
+
+    ++NumTraces;
+    if (!World->LineTraceSingleByChannel(Hit, P, P + Dir * MaxLen, Channel, Params))
+        return 1.f;
+
+    const float rho   = HitDensityKgM3(Hit);
+    const float Lfrac = Settings->FaceThicknessFactor;
+    return Settings->DensityToPermeability(rho, Lfrac);
+}
+
+float FThermoForgeTraceContext::OcclusionBetween(const FVector& A, const FVector& B, float InCellSizeCm)
+{
+    if (!IsValid()) return 1.f;
+
+    if (Settings->bMultiHitOcclusion)
+        return Settings->OpticalDepthToPermeability(OpticalDepthBetween(A, B, InCellSizeCm));
+
+    ++NumTraces;
+    if (!World->LineTraceSingleByChannel(Hit, A, B, Channel, Params))
+        return 1.f; // open
+
+    const float rho   = HitDensityKgM3(Hit);
+    const float Dist  = FVector::Distance(A, B);
+    const float Cell  = FMath::Max(1.f, InCellSizeCm);
+    const float Lfrac = (Dist / Cell) * Settings->FaceThicknessFactor;
+
+    return Settings->DensityToPermeability(rho, Lfrac);
+}
+
+bool FThermoForgeTraceContext::OverlapsBlocking(const FVector& Center, const FQuat& Rot, const FVector& HalfExtent)
+{
+    if (!IsValid()) return true;
+
+    ++NumOverlaps;
+    return World->OverlapBlockingTestByChannel(Center, Rot, Channel, FCollisionShape::MakeBox(HalfExtent), Params);
+}
+
+bool FThermoForgeTraceContext::SweepBlocking(const FVector& Start, const FVector& End, const FQuat& Rot, const FVector& HalfExtent)
+{
+    if (!IsValid()) return true;
+
+    ++NumTraces;
+    return World->SweepTestByChannel(Start, End, Rot, Channel, FCollisionShape::MakeBox(HalfExtent), Params);
+}
+
+bool FThermoForgeTraceContext::PointsInsideOneSolid(TConstArrayView<FVector> Points, const FVector& Center, const FQuat& Rot, const FVector& HalfExtent,
+    const UPrimitiveComponent** OutSolid)
+{
+    if (!IsValid() || Points.Num() == 0) return false;
+
+    ++NumOverlaps;
+    Overlaps.Reset();
+    if (!World->OverlapMultiByChannel(Overlaps, Center, Rot, Channel, FCollisionShape::MakeBox(HalfExtent), Params))
+        return false;
+
+    for (const FOverlapResult& O : Overlaps)
+    {
+        const UPrimitiveComponent* PC = O.bBlockingHit ? O.GetComponent() : nullptr;
+        const UBodySetup* BS = PC ? const_cast<UPrimitiveComponent*>(PC)->GetBodySetup() : nullptr;
+        if (!BS) continue;
+
+        // Elements are convex, so all points inside one element means their hull is inside too
+        const FTransform Xf = PC->GetComponentTransform();
+        auto AllInside = [&](const auto& Elem)
+        {
+            for (const FVector& P : Points)
+                if (Elem.GetShortestDistanceToPoint(P, Xf) > 0.f) return false;
+            return true;
+        };
+
+        auto InsideOneElement = [&]()
+        {
+            for (const FKBoxElem& E : BS->AggGeom.BoxElems)       if (AllInside(E)) return true;
+            for (const FKSphereElem& E : BS->AggGeom.SphereElems) if (AllInside(E)) return true;
+            for (const FKSphylElem& E : BS->AggGeom.SphylElems)   if (AllInside(E)) return true;
+            for (const FKConvexElem& E : BS->AggGeom.ConvexElems) if (AllInside(E)) return true;
+            return false;
+        };
+        if (InsideOneElement())
+        {
+            if (OutSolid) *OutSolid = PC;
+            return true;
+        }
+    }
+    return false;
+}
+
+FThermoForgeTraceContext UThermoForgeSubsystem::MakeTraceContext() const
+{
+    FThermoForgeTraceContext Ctx(GetWorld(), GetSettings());
+    Ctx.SharedDensityCache = DensityCache;
+    return Ctx;
+}
+
+float UThermoForgeSubsystem::TraceAmbientRay01(const FVector& P, const FVector& Dir, float MaxLen) const
+{
+    FThermoForgeTraceContext Ctx = MakeTraceContext();
+    const float Ray = Ctx.AmbientRay01(P, Dir, MaxLen);
+    Ctx.EmitStats();
+    return Ray;
+}
+
+float UThermoForgeSubsystem::OcclusionBetween(const FVector& A, const FVector& B, float CellSizeCm) const
+{
+    FThermoForgeTraceContext Ctx = MakeTraceContext();
+    const float Occ = Ctx.OcclusionBetween(A, B, CellSizeCm);
+    Ctx.EmitStats();
+    return Occ;
+}
+
+// ---- bake pre-pass ----
+enum : uint8
+{
+    TFCell_SkyResolved  = 1 << 0,
+    TFCell_WallResolved = 1 << 1,
+};
+
+void UThermoForgeSubsystem::ClassifyBakeBricks(const FTransform& Frame, const FIntVector& CellMin, const FIntVector& Dim, float Cell,
+    TConstArrayView<FVector> SkyDirs, float SkyReachCm, int32 SliceBegin, int32 SliceEnd, bool bParallel,
+    TArray<float>& Sky, TArray<float>& Wall, TArray<uint8>& OutCellFlags, int32& OutOpen, int32& OutSolid) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ClassifyBakeBricks);
+    enum : uint8 { Mixed = 0, OpenWalls = 1, OpenAll = 2, Solid = 3 };
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    const int32 B = FMath::Max(2, S->BakeBrickSize);
+    const FIntVector BD(FMath::DivideAndRoundUp(Dim.X, B), FMath::DivideAndRoundUp(Dim.Y, B), FMath::DivideAndRoundUp(Dim.Z, B));
+    const int32 NumBricks = BD.X * BD.Y * BD.Z;
+    const FQuat Rot = Frame.GetRotation();
+
+    OutCellFlags.SetNumZeroed(Dim.X * Dim.Y * (SliceEnd - SliceBegin));
+    OutOpen = OutSolid = 0;
+
+    TArray<uint8> BrickClass; BrickClass.SetNumZeroed(NumBricks);
+    TArray<float> BrickPerm;  BrickPerm.SetNumZeroed(NumBricks); // solid bricks: one-cell transmittance of the solid
+    TArray<FThermoForgeTraceContext> Contexts;
+    ParallelForWithTaskContext(Contexts, NumBricks,
+        [this](int32, int32) { return MakeTraceContext(); },
+        [&](FThermoForgeTraceContext& Ctx, int32 b)
+        {
+            const FIntVector Lo((b % BD.X) * B, ((b / BD.X) % BD.Y) * B, (b / (BD.X * BD.Y)) * B);
+            const FIntVector Hi(FMath::Min(Lo.X + B, Dim.X), FMath::Min(Lo.Y + B, Dim.Y), FMath::Min(Lo.Z + B, Dim.Z));
+            if (Hi.Z <= SliceBegin || Lo.Z >= SliceEnd) return; // another shard's slab
+
+            // Grid-space box of the brick, grown by one cell to cover the neighbour traces
+            const FVector MinLS   = FVector(CellMin + Lo) * Cell;
+            const FVector MaxLS   = FVector(CellMin + Hi) * Cell;
+            const FVector CenterWS = Frame.TransformPosition(0.5f * (MinLS + MaxLS));
+            const FVector HalfLS   = 0.5f * (MaxLS - MinLS);
+
+            if (!Ctx.OverlapsBlocking(CenterWS, Rot, HalfLS + FVector(Cell)))
+            {
+                // The brick swept along a sky direction covers that ray from every one of its cells, so one sweep
+                // per direction replaces the per-cell rays; any hit leaves the sky to the rays
+                BrickClass[b] = OpenAll;
+                for (const FVector& Dir : SkyDirs)
+                    if (Ctx.SweepBlocking(CenterWS, CenterWS + Dir * SkyReachCm, Rot, HalfLS))
+                    {
+                        BrickClass[b] = OpenWalls;
+                        break;
+                    }
+                return;
+            }
+
+            // Hull of the brick's cell centers
+            const FVector C0 = MinLS + FVector(0.5f * Cell);
+            const FVector C1 = MaxLS - FVector(0.5f * Cell);
+            FVector Pts[8];
+            for (int32 i = 0; i < 8; ++i)
+                Pts[i] = Frame.TransformPosition(FVector((i & 1) ? C1.X : C0.X, (i & 2) ? C1.Y : C0.Y, (i & 4) ? C1.Z : C0.Z));
+
+            // Buried: neighbour traces would cross one cell of the solid; sky rays at least that much
+            const UPrimitiveComponent* SolidPC = nullptr;
+            if (Ctx.PointsInsideOneSolid(Pts, CenterWS, Rot, HalfLS, &SolidPC))
+            {
+                BrickClass[b] = Solid;
+                BrickPerm[b]  = S->DensityToPermeability(GetComponentDensityKgM3(SolidPC, S), S->FaceThicknessFactor);
+            }
+        },
+        bParallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+    for (const FThermoForgeTraceContext& Ctx : Contexts)
+        Ctx.EmitStats();
+
+    for (int32 b = 0; b < NumBricks; ++b)
+    {
+        const uint8 Class = BrickClass[b];
+        if (Class == Mixed) continue;
+
+        OutOpen  += (Class == OpenAll);
+        OutSolid += (Class == Solid);
+
+        const FIntVector Lo((b % BD.X) * B, ((b / BD.X) % BD.Y) * B, (b / (BD.X * BD.Y)) * B);
+        const FIntVector Hi(FMath::Min(Lo.X + B, Dim.X), FMath::Min(Lo.Y + B, Dim.Y), FMath::Min(Lo.Z + B, Dim.Z));
+        for (int32 z=FMath::Max(Lo.Z, SliceBegin); z<FMath::Min(Hi.Z, SliceEnd); ++z)
+        for (int32 y=Lo.Y; y<Hi.Y; ++y)
+        for (int32 x=Lo.X; x<Hi.X; ++x)
+        {
+            const int32 idx = ((z - SliceBegin) * Dim.Y + y) * Dim.X + x; // slab-local
+            if (Class == Solid)
+            {
+                Sky[idx] = Wall[idx] = BrickPerm[b];
+                OutCellFlags[idx] = TFCell_SkyResolved | TFCell_WallResolved;
+            }
+            else
+            {
+                Wall[idx] = 1.f;
+                OutCellFlags[idx] = TFCell_WallResolved;
+                if (Class == OpenAll)
+                {
+                    Sky[idx] = 1.f;
+                    OutCellFlags[idx] |= TFCell_SkyResolved;
+                }
+            }
+        }
+    }
+}
+
+// ---- sun visibility fit ----
+// Inverse normal matrix of the weighted least-squares fit Vis(dir) ~ a + b.dir over one direction set. It does not
+// depend on the cell, so each cell only accumulates its ray moments. False if the set is degenerate.
+static bool TF_SunFitMatrix(TConstArrayView<FVector> Dirs, TConstArrayView<float> Weights, FMatrix& OutInverse)
+{
+    FMatrix M(ForceInit);
+    for (int32 d = 0; d < Dirs.Num(); ++d)
+    {
+        const double Basis[4] = { 1.0, Dirs[d].X, Dirs[d].Y, Dirs[d].Z };
+        for (int32 i = 0; i < 4; ++i)
+            for (int32 j = 0; j < 4; ++j)
+                M.M[i][j] += Weights[d] * Basis[i] * Basis[j];
+    }
+
+    if (FMath::Abs(M.Determinant()) < UE_SMALL_NUMBER) return false;
+    OutInverse = M.Inverse();
+    return true;
+}
+
+// ---- main bake: SkyView01 + WallPermeability01 (+ Indoorness01, SunVisibilityL1) ----
+bool UThermoForgeSubsystem::BakeVolume(AThermoForgeVolume* V, const FThermoForgeBakeOptions& Options, FThermoForgeBakedField& OutField,
+    FThermoForgeBakeVolumeStats& OutStats) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Bake);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::BakeVolume);
+
+    UWorld* W = GetWorld();
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!W || !S || !V) return false;
+
+    const double StartTime = FPlatformTime::Seconds();
+    OutStats = FThermoForgeBakeVolumeStats();
+    OutStats.VolumeName = V->GetName();
+
+    // Sky openness directions for the current quality tier (+ dense set for adaptive refinement)
+    const FThermoForgeSkySampling Sampling = S->GetSkySampling();
+    TArray<FVector> HemiDirs, FineDirs;
+    TArray<float>   HemiW,    FineW;
+    Sampling.BuildDirections(Sampling.NumDirections, HemiDirs, HemiW);
+    if (Sampling.bAdaptive)
+        Sampling.BuildDirections(Sampling.AdaptiveMaxDirections, FineDirs, FineW);
+
+    const FTransform Frame = V->GetGridFrame();
+    const FTransform InvFrame = Frame.Inverse();
+    
+    const FBox Bounds = V->GetWorldBounds();
+    const float   Cell   = V->GetEffectiveCellSize();
+    const FVector Origin = V->GetEffectiveGridOrigin();
+
+    // Transform world AABB corners into grid space (so indices align to the rotated grid)
+    FVector Corners[8] = {
+        FVector(Bounds.Min.X, Bounds.Min.Y, Bounds.Min.Z),
+        FVector(Bounds.Min.X, Bounds.Min.Y, Bounds.Max.Z),
+        FVector(Bounds.Min.X, Bounds.Max.Y, Bounds.Min.Z),
+        FVector(Bounds.Min.X, Bounds.Max.Y, Bounds.Max.Z),
+        FVector(Bounds.Max.X, Bounds.Min.Y, Bounds.Min.Z),
+        FVector(Bounds.Max.X, Bounds.Min.Y, Bounds.Max.Z),
+        FVector(Bounds.Max.X, Bounds.Max.Y, Bounds.Min.Z),
+        FVector(Bounds.Max.X, Bounds.Max.Y, Bounds.Max.Z),
+    };
+    FBox GridBox(ForceInit);
+    for (int i=0; i<8; ++i)
+    {
+        GridBox += InvFrame.TransformPosition(Corners[i]); // world → grid (rotate & translate)
+    }
+
+    // Index range in grid space
+    auto FloorDiv0 = [](double X, double Step)->int32 { return FMath::FloorToInt(X / Step); };
+    auto CeilDiv0  = [](double X, double Step)->int32 { return FMath::CeilToInt (X / Step); };
+
+    const int32 ix0 = FloorDiv0(GridBox.Min.X, Cell);
+    const int32 iy0 = FloorDiv0(GridBox.Min.Y, Cell);
+    const int32 iz0 = FloorDiv0(GridBox.Min.Z, Cell);
+
+    const int32 ix1 = CeilDiv0 (GridBox.Max.X, Cell) - 1;
+    const int32 iy1 = CeilDiv0 (GridBox.Max.Y, Cell) - 1;
+    const int32 iz1 = CeilDiv0 (GridBox.Max.Z, Cell) - 1;
+
+    const FIntVector Dim(
+        FMath::Max(0, ix1 - ix0 + 1),
+        FMath::Max(0, iy1 - iy0 + 1),
+        FMath::Max(0, iz1 - iz0 + 1)
+    );
+
+    const int32 Nx = Dim.X, Ny = Dim.Y, Nz = Dim.Z;
+    const int32 N  = Nx * Ny * Nz;
+    if (N <= 0) return false;
+
+    // This shard's z-slab. Cells depend only on geometry, so any split reproduces the single-process values.
+    const int32 NumShards  = FMath::Max(1, Options.NumShards);
+    const int32 ShardIndex = FMath::Clamp(Options.ShardIndex, 0, NumShards - 1);
+    const int32 SliceBegin = (int32)((int64)Nz * ShardIndex / NumShards);
+    const int32 SliceEnd   = (int32)((int64)Nz * (ShardIndex + 1) / NumShards);
+    if (SliceEnd <= SliceBegin) return false;
+
+    const bool bParallel = S->bParallelBake && Options.bParallel;
+
+    // World origin of the [ix0,iy0,iz0] corner via the frame
+    const FVector FieldOriginWS = Frame.TransformPosition(FVector(ix0 * Cell, iy0 * Cell, iz0 * Cell));
+
+    auto Index = [&](int32 x,int32 y,int32 z)->int32 { return (z * Ny + y) * Nx + x; };
+
+    // Center of a cell in WORLD space: go LS → WS through the frame
+    auto Center = [&](int32 x,int32 y,int32 z)
+    {
+        const FVector CenterLS(
+            (ix0 + x + 0.5f) * Cell,
+            (iy0 + y + 0.5f) * Cell,
+            (iz0 + z + 0.5f) * Cell
+        );
+        return Frame.TransformPosition(CenterLS);
+    };
+    
+    // Per-cell arrays cover this shard's slab only; cell centers keep one extra slice on each side for the neighbour traces
+    const int32 SliceCells   = Nx * Ny;
+    const int32 SlabFirst    = SliceBegin * SliceCells;
+    const int32 SlabN        = (SliceEnd - SliceBegin) * SliceCells;
+    const int32 CenterZ0     = FMath::Max(0, SliceBegin - 1);
+    const int32 CenterZ1     = FMath::Min(Nz, SliceEnd + 1);
+    const int32 CentersFirst = CenterZ0 * SliceCells;
+    const int32 CenterShift  = SlabFirst - CentersFirst; // slab-local index -> Centers index
+
+    TArray<float> Sky;   Sky.SetNumZeroed(SlabN);
+    TArray<float> Wall;  Wall.SetNumZeroed(SlabN);
+    TArray<float> Indoor;Indoor.SetNumZeroed(SlabN);
+
+    // Sun visibility: per-cell first moments of the sky rays, solved against the shared fit matrices
+    const bool bSunVis = S->bBakeSunVisibility;
+    FMatrix HemiFit, FineFit;
+    const bool bHemiFit = bSunVis && TF_SunFitMatrix(HemiDirs, HemiW, HemiFit);
+    const bool bFineFit = bSunVis && Sampling.bAdaptive && TF_SunFitMatrix(FineDirs, FineW, FineFit);
+    TArray<FVector3f> SkyMoment;
+    TArray<FVector4f> SunVis;
+    if (bSunVis)
+    {
+        SkyMoment.SetNumZeroed(SlabN);
+        SunVis.SetNumZeroed(SlabN);
+    }
+
+    const float RayLen = Sampling.MaxRayLengthCm;
+
+    TArray<FVector> Centers; Centers.SetNumUninitialized((CenterZ1 - CenterZ0) * SliceCells);
+    for (int32 z=CenterZ0; z<CenterZ1; ++z)
+    for (int32 y=0; y<Ny; ++y)
+    for (int32 x=0; x<Nx; ++x)
+        Centers[Index(x,y,z) - CentersFirst] = Center(x,y,z);
+
+    // Voxel backend: rasterize collision once, then march instead of tracing
+    const bool bVoxels = (S->BakeBackend == EThermoBakeBackend::Voxels);
+    FThermoForgeOccupancyGrid Occ;
+    if (bVoxels)
+    {
+        const int32 VPC    = FMath::Max(1, S->VoxelsPerCell);
+        const int32 Margin = FMath::CeilToInt(FMath::Max(0.f, S->VoxelMarginCm) / Cell) * VPC; // in voxels
+        const FIntVector OccDim(Nx * VPC + 2 * Margin, Ny * VPC + 2 * Margin, Nz * VPC + Margin + VPC);
+        const FVector OccOriginLS = FVector(ix0 * Cell, iy0 * Cell, iz0 * Cell) - FVector(Margin, Margin, VPC) * (Cell / VPC);
+
+        TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::Voxelize);
+        Occ.Init(Frame, OccOriginLS, Cell / VPC, OccDim, Cell);
+        Occ.Rasterize(W, S);
+        UE_LOG(LogThermoForge, Log, TEXT("%s: voxelized %dx%dx%d, %d occupied, %d densities"),
+            *V->GetName(), OccDim.X, OccDim.Y, OccDim.Z, Occ.NumOccupied(), Occ.DensityPalette.Num());
+    }
+
+    auto SkyRay = [&](FThermoForgeTraceContext& Ctx, const FVector& P, const FVector& Dir)
+    {
+        return bVoxels ? Occ.AmbientRay01(P, Dir, RayLen, S) : Ctx.AmbientRay01(P, Dir, RayLen);
+    };
+    auto WallRay = [&](FThermoForgeTraceContext& Ctx, const FVector& A, const FVector& B)
+    {
+        return bVoxels ? Occ.OcclusionBetween(A, B, Cell, S) : Ctx.OcclusionBetween(A, B, Cell);
+    };
+
+    TArray<uint8> CellFlags;
+    if (S->bSkipUniformBricks && !bVoxels)
+    {
+        ClassifyBakeBricks(Frame, FIntVector(ix0, iy0, iz0), Dim, Cell, HemiDirs, RayLen, SliceBegin, SliceEnd, bParallel,
+                           Sky, Wall, CellFlags, OutStats.OpenBricks, OutStats.SolidBricks);
+        UE_LOG(LogThermoForge, Log, TEXT("%s: pre-pass resolved %d open / %d solid bricks"), *V->GetName(), OutStats.OpenBricks, OutStats.SolidBricks);
+    }
+    else
+    {
+        CellFlags.SetNumZeroed(SlabN);
+    }
+
+    // One z-slice per task. Within a slice rays go out direction by direction, so consecutive
+    // queries are parallel and close together and walk the same part of the broadphase.
+    const FIntVector NeighborOffsets[6] = {
+        {-1,0,0}, {1,0,0}, {0,-1,0}, {0,1,0}, {0,0,-1}, {0,0,1}
+    };
+
+    TArray<FThermoForgeTraceContext> Contexts;
+    ParallelForWithTaskContext(Contexts, SliceEnd - SliceBegin,
+        [this, Cell](int32 /*ContextIndex*/, int32 /*NumContexts*/)
+        {
+            FThermoForgeTraceContext Ctx = MakeTraceContext();
+            Ctx.CellSizeCm = Cell;
+            return Ctx;
+        },
+        [&](FThermoForgeTraceContext& Ctx, int32 Slice)
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::BakeSlice);
+            const int32 z = SliceBegin + Slice;
+            const int32 Begin = Index(0,0,z) - SlabFirst; // slab-local
+            const int32 End   = Begin + SliceCells;
+
+            // Sky openness (hemisphere)
+            TArray<float> RayMin, RayMax;
+            if (Sampling.bAdaptive)
+            {
+                RayMin.Init(1.f, SliceCells);
+                RayMax.Init(0.f, SliceCells);
+            }
+
+            for (int32 d=0; d<HemiDirs.Num(); ++d)
+                for (int32 idx=Begin; idx<End; ++idx)
+                {
+                    if (CellFlags[idx] & TFCell_SkyResolved) continue;
+                    const float Ray = SkyRay(Ctx, Centers[idx + CenterShift], HemiDirs[d]);
+                    Sky[idx] += HemiW[d] * Ray;
+                    if (bSunVis) SkyMoment[idx] += FVector3f(HemiDirs[d]) * (HemiW[d] * Ray);
+                    if (Sampling.bAdaptive)
+                    {
+                        RayMin[idx - Begin] = FMath::Min(RayMin[idx - Begin], Ray);
+                        RayMax[idx - Begin] = FMath::Max(RayMax[idx - Begin], Ray);
+                    }
+                }
+
+            // Adaptive: cells whose initial rays disagree are re-estimated with the dense set
+            TBitArray<> Refined(false, SliceCells);
+            if (Sampling.bAdaptive)
+            {
+                TArray<int32> Refine;
+                for (int32 idx=Begin; idx<End; ++idx)
+                    if (RayMax[idx - Begin] - RayMin[idx - Begin] > Sampling.AdaptiveSpread)
+                    {
+                        Refine.Add(idx);
+                        Refined[idx - Begin] = true;
+                        Sky[idx] = 0.f;
+                        if (bSunVis) SkyMoment[idx] = FVector3f::ZeroVector;
+                    }
+
+                for (int32 d=0; d<FineDirs.Num() && Refine.Num() > 0; ++d)
+                    for (int32 idx : Refine)
+                    {
+                        const float Ray = SkyRay(Ctx, Centers[idx + CenterShift], FineDirs[d]);
+                        Sky[idx] += FineW[d] * Ray;
+                        if (bSunVis) SkyMoment[idx] += FVector3f(FineDirs[d]) * (FineW[d] * Ray);
+                    }
+            }
+
+            // L1 coefficients from the moments; pre-pass cells and degenerate direction sets stay isotropic
+            if (bSunVis)
+                for (int32 idx=Begin; idx<End; ++idx)
+                {
+                    const bool bFine = Refined[idx - Begin];
+                    const FMatrix* Fit = (CellFlags[idx] & TFCell_SkyResolved) ? nullptr
+                                       : bFine ? (bFineFit ? &FineFit : nullptr) : (bHemiFit ? &HemiFit : nullptr);
+                    if (!Fit)
+                    {
+                        SunVis[idx] = FVector4f(FMath::Clamp(Sky[idx], 0.f, 1.f), 0.f, 0.f, 0.f);
+                        continue;
+                    }
+
+                    // Fit is symmetric, so the row-vector transform is the matrix-vector product
+                    const FVector3f& Mo = SkyMoment[idx];
+                    SunVis[idx] = FVector4f(Fit->TransformFVector4(FVector4(Sky[idx], Mo.X, Mo.Y, Mo.Z)));
+                }
+
+            for (int32 idx=Begin; idx<End; ++idx)
+                Sky[idx] = FMath::Clamp(Sky[idx], 0.f, 1.f);
+
+            // Wall permeability: average occlusion to 6 neighbor centers
+            TArray<uint8> Count; Count.SetNumZeroed(SliceCells);
+            for (const FIntVector& O : NeighborOffsets)
+            {
+                const int32 zz = z + O.Z;
+                if (zz<0 || zz>=Nz) continue;
+
+                for (int32 y=0; y<Ny; ++y)
+                for (int32 x=0; x<Nx; ++x)
+                {
+                    const int32 xx = x + O.X, yy = y + O.Y;
+                    if (xx<0 || yy<0 || xx>=Nx || yy>=Ny) continue;
+
+                    const int32 idx = Index(x,y,z) - SlabFirst;
+                    if (CellFlags[idx] & TFCell_WallResolved) continue;
+                    const float perm = WallRay(Ctx, Centers[idx + CenterShift], Centers[Index(xx,yy,zz) - CentersFirst]); // 0..1, uses physmat density
+                    Wall[idx] += FMath::Clamp(perm, 0.f, 1.f);
+                    ++Count[idx - Begin];
+                }
+            }
+
+            for (int32 idx=Begin; idx<End; ++idx)
+            {
+                if (!(CellFlags[idx] & TFCell_WallResolved))
+                {
+                    const uint8 cnt = Count[idx - Begin];
+                    Wall[idx] = (cnt>0) ? (Wall[idx] / cnt) : 1.f;
+                }
+
+                // Composite indoor proxy
+                Indoor[idx] = (1.f - Sky[idx]) * (1.f - Wall[idx]);
+            }
+        },
+        bParallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+    for (const FThermoForgeTraceContext& Ctx : Contexts)
+    {
+        OutStats.NumTraces += Ctx.NumTraces;
+        Ctx.EmitStats();
+    }
+
+    OutField.Dim          = Dim;
+    OutField.CellSizeCm   = Cell;
+    OutField.OriginWS     = FieldOriginWS;
+    OutField.GridRotation = Frame.Rotator();
+    OutField.SliceBegin   = SliceBegin;
+    OutField.SliceEnd     = SliceEnd;
+    OutField.SkyView01          = MoveTemp(Sky);
+    OutField.WallPermeability01 = MoveTemp(Wall);
+    OutField.Indoorness01       = MoveTemp(Indoor);
+    OutField.SunVisibilityL1    = MoveTemp(SunVis);
+
+    OutStats.Dim      = Dim;
+    OutStats.NumCells = SlabN;
+    OutStats.Seconds  = FPlatformTime::Seconds() - StartTime;
+    SET_FLOAT_STAT(STAT_ThermoForge_BakeCellsPerSec, OutStats.NumCells / FMath::Max(OutStats.Seconds, 1e-6));
+    return true;
+
+}
+
+bool UThermoForgeSubsystem::IsVolumeSelected(const AThermoForgeVolume* V, const FThermoForgeBakeOptions& Options)
+{
+    if (!V) return false;
+    if (Options.VolumeNames.Num() == 0) return true;
+
+    bool bSelected = Options.VolumeNames.Contains(V->GetName());
+#if WITH_EDITOR
+    bSelected |= Options.VolumeNames.Contains(V->GetActorLabel());
+#endif
+    return bSelected;
+}
+
+#if WITH_EDITOR
+void UThermoForgeSubsystem::ApplyBakedField(AThermoForgeVolume* V, const FThermoForgeBakedField& Field, const FThermoForgeBakeOptions& Options,
+    FThermoForgeBakeVolumeStats& Stats) const
+{
+    TArray<uint32> ClimateBlend;
+    TArray<TObjectPtr<UThermoForgeClimateProfile>> ClimatePalette;
+    ComputeClimateBlend(Field, ClimateBlend, ClimatePalette);
+
+    if (V->bStreamWithWorldPartition)
+    {
+        UWorld* W = GetWorld();
+        if (W && W->IsPartitionedWorld())
+        {
+            WriteFieldChunks(V, Field, ClimateBlend, ClimatePalette, Stats);
+            return;
+        }
+        UE_LOG(LogThermoForge, Warning, TEXT("%s: bStreamWithWorldPartition needs a World Partition map; writing one field asset"), *V->GetName());
+    }
+
+    const FString PackageName = FString::Printf(TEXT("/Game/ThermoForge/Bakes/%s_Field"), *V->GetName());
+    UThermoForgeFieldAsset* Saved = CreateAndSaveFieldAsset(PackageName, Field.Dim, Field.CellSizeCm, Field.OriginWS, Field.GridRotation,
+                                                            Field.SkyView01, Field.WallPermeability01, Field.Indoorness01,
+                                                            Field.SunVisibilityL1, ClimateBlend, ClimatePalette);
+    if (!Saved) return;
+
+    Stats.AssetPath = Saved->GetPathName();
+    V->Modify();
+    V->BakedField = Saved;
+    if (Options.bBuildPreview)
+    {
+        V->SetPreviewVisibility(true);
+        V->BuildHeatPreviewFromField();
+    }
+    V->MarkPackageDirty();
+}
+#endif
+
+#if WITH_EDITOR
+void UThermoForgeSubsystem::ComputeClimateBlend(const FThermoForgeBakedField& Field, TArray<uint32>& OutBlend,
+    TArray<TObjectPtr<UThermoForgeClimateProfile>>& OutPalette) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ComputeClimateBlend);
+    OutBlend.Reset();
+    OutPalette.Reset();
+
+    UWorld* W = GetWorld();
+    const FIntVector D = Field.Dim;
+    if (!W || D.X <= 0 || D.Y <= 0 || D.Z <= 0) return;
+
+    const FTransform Frame(Field.GridRotation, Field.OriginWS);
+    const float      Cell = Field.CellSizeCm;
+    const FBox FieldBox = FBox(FVector::ZeroVector, FVector(D) * Cell).TransformBy(Frame);
+
+    // Override volumes touching the field; one palette slot per distinct profile, slot 0 = project climate
+    TArray<const AThermoForgeVolume*> Overrides;
+    TArray<uint8> SlotOf;
+    OutPalette.Add(nullptr);
+    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    {
+        const AThermoForgeVolume* V = *It;
+        if (!V || !V->ClimateProfile) continue;
+        if (!V->bUnbounded && !FBox(-V->BoxExtent, V->BoxExtent).TransformBy(V->GetActorTransform()).Intersect(FieldBox)) continue;
+
+        int32 Slot = OutPalette.IndexOfByKey(V->ClimateProfile);
+        if (Slot == INDEX_NONE)
+        {
+            if (OutPalette.Num() > 0xFF)
+            {
+                UE_LOG(LogThermoForge, Warning, TEXT("%s: more than 255 climate profiles overlap one field; ignoring %s"),
+                    *V->GetName(), *GetNameSafe(V->ClimateProfile));
+                continue;
+            }
+            Slot = OutPalette.Add(V->ClimateProfile);
+        }
+        Overrides.Add(V);
+        SlotOf.Add(uint8(Slot));
+    }
+
+    if (Overrides.IsEmpty())
+    {
+        OutPalette.Reset();
+        return;
+    }
+
+    OutBlend.SetNumUninitialized(D.X * D.Y * D.Z);
+    ParallelFor(D.Z, [&](int32 z)
+    {
+        TArray<float> SlotWeight;
+        SlotWeight.SetNumUninitialized(OutPalette.Num());
+
+        for (int32 y = 0; y < D.Y; ++y)
+            for (int32 x = 0; x < D.X; ++x)
+            {
+                const FVector P = Frame.TransformPosition(FVector((x + 0.5f) * Cell, (y + 0.5f) * Cell, (z + 0.5f) * Cell));
+
+                // A profile used by several volumes takes its strongest one; the project climate fills the rest
+                FMemory::Memzero(SlotWeight.GetData(), SlotWeight.Num() * sizeof(float));
+                float MaxW = 0.f;
+                for (int32 k = 0; k < Overrides.Num(); ++k)
+                {
+                    const float w = Overrides[k]->GetClimateWeightAt(P);
+                    SlotWeight[SlotOf[k]] = FMath::Max(SlotWeight[SlotOf[k]], w);
+                    MaxW = FMath::Max(MaxW, w);
+                }
+                SlotWeight[0] = 1.f - MaxW;
+
+                // Keep the two strongest
+                int32 A = 0, B = 0;
+                float WA = -1.f, WB = -1.f;
+                for (int32 s = 0; s < SlotWeight.Num(); ++s)
+                {
+                    if (SlotWeight[s] > WA)      { B = A; WB = WA; A = s; WA = SlotWeight[s]; }
+                    else if (SlotWeight[s] > WB) { B = s; WB = SlotWeight[s]; }
+                }
+                WB = FMath::Max(0.f, WB);
+
+                const float Sum = WA + WB;
+                OutBlend[(z * D.Y + y) * D.X + x] = FThermoForgeClimate::PackBlend(uint8(A), uint8(B), Sum > 0.f ? WB / Sum : 0.f);
+            }
+    });
+}
+
+void UThermoForgeSubsystem::WriteFieldChunks(AThermoForgeVolume* V, const FThermoForgeBakedField& Field, const TArray<uint32>& ClimateBlend,
+    const TArray<TObjectPtr<UThermoForgeClimateProfile>>& ClimatePalette, FThermoForgeBakeVolumeStats& Stats) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::WriteFieldChunks);
+    UWorld* W = GetWorld();
+    if (!W || !V) return;
+
+    const FString    VolName = V->GetName();
+    const FTransform Frame   = V->GetGridFrame();
+    const float      Cell    = Field.CellSizeCm;
+    const FIntVector D       = Field.Dim;
+    const int32      K       = FMath::Max(1, FMath::RoundToInt(V->FieldChunkSizeCm / Cell));
+
+    // Global grid index of the field's first cell; chunk coordinates are global so rebakes hit the same assets
+    const FVector    G0f = Frame.InverseTransformPosition(Field.OriginWS) / Cell;
+    const FIntVector G0(FMath::RoundToInt(G0f.X), FMath::RoundToInt(G0f.Y), FMath::RoundToInt(G0f.Z));
+    auto FloorDiv = [K](int32 X) { return (X >= 0) ? X / K : -((-X + K - 1) / K); };
+
+    // Chunks of this volume are reused or removed. In a partitioned world the unloaded ones are found through their
+    // actor descriptors (labelled after the volume) and pinned loaded until the write is done.
+    TArray<FWorldPartitionReference> Pinned;
+    if (UWorldPartition* WP = W->GetWorldPartition())
+    {
+        const FString LabelPrefix = VolName + TEXT("_Chunk_");
+        FWorldPartitionHelpers::ForEachActorDescInstance<AThermoForgeFieldChunk>(WP, [&](const FWorldPartitionActorDescInstance* Desc)
+        {
+            if (Desc->GetActorLabel().ToString().StartsWith(LabelPrefix))
+                Pinned.Emplace(WP, Desc->GetGuid());
+            return true;
+        });
+    }
+
+    TMap<FIntPoint, AThermoForgeFieldChunk*> Existing;
+    for (TActorIterator<AThermoForgeFieldChunk> It(W); It; ++It)
+        if (It->SourceVolume == V->GetFName())
+            Existing.Add(It->ChunkCoord, *It);
+
+    int32 NumChunks = 0;
+    for (int32 cy = FloorDiv(G0.Y); cy <= FloorDiv(G0.Y + D.Y - 1); ++cy)
+    for (int32 cx = FloorDiv(G0.X); cx <= FloorDiv(G0.X + D.X - 1); ++cx)
+    {
+        const int32 gx0 = FMath::Max(cx * K, G0.X), gx1 = FMath::Min((cx + 1) * K, G0.X + D.X);
+        const int32 gy0 = FMath::Max(cy * K, G0.Y), gy1 = FMath::Min((cy + 1) * K, G0.Y + D.Y);
+        const FIntVector CD(gx1 - gx0, gy1 - gy0, D.Z);
+        const int32 CN = CD.X * CD.Y * CD.Z;
+
+        TArray<float> Sky, Wall, Indoor;
+        TArray<FVector4f> SunVis;
+        TArray<uint32> Climate;
+        Sky.Reserve(CN); Wall.Reserve(CN); Indoor.Reserve(CN);
+        if (Field.SunVisibilityL1.Num() > 0) SunVis.Reserve(CN);
+        if (ClimateBlend.Num() > 0) Climate.Reserve(CN);
+        for (int32 z = 0; z < D.Z; ++z)
+        for (int32 gy = gy0; gy < gy1; ++gy)
+        {
+            const int32 Row = (z * D.Y + (gy - G0.Y)) * D.X + (gx0 - G0.X);
+            Sky.Append(Field.SkyView01.GetData() + Row, CD.X);
+            Wall.Append(Field.WallPermeability01.GetData() + Row, CD.X);
+            Indoor.Append(Field.Indoorness01.GetData() + Row, CD.X);
+            if (Field.SunVisibilityL1.Num() > 0)
+                SunVis.Append(Field.SunVisibilityL1.GetData() + Row, CD.X);
+            if (ClimateBlend.Num() > 0)
+                Climate.Append(ClimateBlend.GetData() + Row, CD.X);
+        }
+
+        const FString ChunkName   = FString::Printf(TEXT("%s_Chunk_%d_%d"), *VolName, cx, cy);
+        const FString PackageName = FString::Printf(TEXT("/Game/ThermoForge/Bakes/%s/%s"), *VolName, *ChunkName);
+        const FVector ChunkOriginWS = Frame.TransformPosition(FVector(gx0, gy0, G0.Z) * Cell);
+        UThermoForgeFieldAsset* Asset = CreateAndSaveFieldAsset(PackageName, CD, Cell, ChunkOriginWS, Field.GridRotation, Sky, Wall, Indoor,
+                                                                SunVis, Climate, Climate.Num() > 0 ? ClimatePalette : TArray<TObjectPtr<UThermoForgeClimateProfile>>());
+        if (!Asset) continue;
+
+        const FIntPoint Coord(cx, cy);
+        const FVector   CenterWS = Frame.TransformPosition((FVector(gx0, gy0, G0.Z) + 0.5 * FVector(CD)) * Cell);
+        AThermoForgeFieldChunk* Chunk = nullptr;
+        Existing.RemoveAndCopyValue(Coord, Chunk);
+        if (!Chunk)
+        {
+            Chunk = W->SpawnActor<AThermoForgeFieldChunk>(CenterWS, Frame.Rotator());
+            if (!Chunk) continue;
+
+            // Chunks follow the volume's data layers
+            for (const UDataLayerInstance* DataLayer : V->GetDataLayerInstances())
+                DataLayer->AddActor(Chunk);
+        }
+
+        Chunk->Modify();
+        Chunk->SetActorLocationAndRotation(CenterWS, Frame.Rotator());
+        Chunk->SourceVolume = V->GetFName();
+        Chunk->LayerFrame   = Frame;
+        Chunk->CellSizeCm   = Cell;
+        Chunk->ChunkCells   = K;
+        Chunk->ChunkCoord   = Coord;
+        Chunk->Field        = Asset;
+        Chunk->SetActorLabel(ChunkName);
+        Chunk->UpdateRegistration();
+        Chunk->MarkPackageDirty();
+        ++NumChunks;
+    }
+
+    // Coordinates no longer covered by the volume
+    for (const TPair<FIntPoint, AThermoForgeFieldChunk*>& Stale : Existing)
+        W->DestroyActor(Stale.Value);
+
+    // The monolithic field is no longer referenced, so nothing outside the loaded chunks stays resident
+    V->SetBakedField(nullptr);
+
+    Stats.AssetPath = FString::Printf(TEXT("/Game/ThermoForge/Bakes/%s (%d chunks)"), *VolName, NumChunks);
+    UE_LOG(LogThermoForge, Log, TEXT("%s: wrote %d field chunks of %d cells, removed %d stale"),
+        *VolName, NumChunks, K, Existing.Num());
+}
+#endif
+
+void UThermoForgeSubsystem::RunBake(const FThermoForgeBakeOptions& Options, FThermoForgeBakeReport& OutReport)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::RunBake);
+    UWorld* W = GetWorld();
+    OutReport = FThermoForgeBakeReport();
+    if (!W || !GetSettings()) return;
+
+    const double StartTime = FPlatformTime::Seconds();
+    OutReport.MapName = W->GetMapName();
+    const bool bShard = Options.NumShards > 1;
+
+    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    {
+        AThermoForgeVolume* V = *It;
+        if (!IsVolumeSelected(V, Options)) continue;
+
+        FThermoForgeBakedField Field;
+        FThermoForgeBakeVolumeStats Stats;
+        if (!BakeVolume(V, Options, Field, Stats))
+            continue;
+
+        if (bShard)
+        {
+            const FString Path = GetBakeShardPath(Options.ShardDir, V->GetName(), Options.ShardIndex, Options.NumShards);
+            if (SaveBakeShard(Path, V->GetName(), Field, Stats))
+                Stats.AssetPath = Path;
+        }
+    #if WITH_EDITOR
+        else if (Options.bSaveAssets)
+        {
+            ApplyBakedField(V, Field, Options, Stats);
+        }
+    #endif
+
+        OutReport.TotalTraces += Stats.NumTraces;
+        OutReport.TotalCells  += Stats.NumCells;
+        OutReport.Volumes.Add(MoveTemp(Stats));
+    }
+
+    OutReport.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+    if (bShard)
+    {
+        UE_LOG(LogThermoForge, Log, TEXT("Bake %s shard %d/%d: volumes=%d cells=%lld traces=%lld time=%.2fs"),
+            *OutReport.MapName, Options.ShardIndex, Options.NumShards, OutReport.Volumes.Num(), OutReport.TotalCells, OutReport.TotalTraces, OutReport.TotalSeconds);
+    }
+    else
+    {
+        UE_LOG(LogThermoForge, Log, TEXT("Bake %s: volumes=%d cells=%lld traces=%lld time=%.2fs"),
+            *OutReport.MapName, OutReport.Volumes.Num(), OutReport.TotalCells, OutReport.TotalTraces, OutReport.TotalSeconds);
+    }
+}
+
+// ---- bake shards ----
+namespace
+{
+    constexpr uint32 TFShardMagic   = 0x44534654; // 'TFSD'
+    constexpr int32  TFShardVersion = 2; // 2: SunVisibilityL1
+}
+
+FString UThermoForgeSubsystem::GetBakeShardPath(const FString& Dir, const FString& VolumeName, int32 ShardIndex, int32 NumShards)
+{
+    return Dir / FString::Printf(TEXT("%s.%dof%d.tfshard"), *VolumeName, ShardIndex, NumShards);
+}
+
+bool UThermoForgeSubsystem::SaveBakeShard(const FString& Path, const FString& VolumeName, FThermoForgeBakedField& Field,
+    FThermoForgeBakeVolumeStats& Stats)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Ar(Bytes);
+
+    uint32  Magic = TFShardMagic;
+    int32   Version = TFShardVersion;
+    FString Name = VolumeName;
+    Ar << Magic << Version << Name;
+    Ar << Stats.NumTraces << Stats.OpenBricks << Stats.SolidBricks << Stats.Seconds;
+    Ar << Field;
+
+    const bool bOk = FFileHelper::SaveArrayToFile(Bytes, *Path);
+    UE_LOG(LogThermoForge, Log, TEXT("Shard %s slices [%d,%d) : %s"),
+        *Path, Field.SliceBegin, Field.SliceEnd, bOk ? TEXT("Saved") : TEXT("FAILED"));
+    return bOk;
+}
+
+bool UThermoForgeSubsystem::LoadBakeShard(const FString& Path, const FString& VolumeName, FThermoForgeBakedField& OutField,
+    FThermoForgeBakeVolumeStats& OutStats)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path)) return false;
+
+    FMemoryReader Ar(Bytes);
+    uint32  Magic = 0;
+    int32   Version = 0;
+    FString Name;
+    Ar << Magic << Version;
+    if (Magic != TFShardMagic || Version != TFShardVersion)
+    {
+        UE_LOG(LogThermoForge, Error, TEXT("%s is not a version %d bake shard"), *Path, TFShardVersion);
+        return false;
+    }
+
+    Ar << Name;
+    Ar << OutStats.NumTraces << OutStats.OpenBricks << OutStats.SolidBricks << OutStats.Seconds;
+    Ar << OutField;
+
+    const int64 SlabCells = (int64)OutField.Dim.X * OutField.Dim.Y * (OutField.SliceEnd - OutField.SliceBegin);
+    if (Ar.IsError() || Name != VolumeName || SlabCells <= 0 || OutField.SliceBegin < 0 || OutField.SliceEnd > OutField.Dim.Z ||
+        OutField.SkyView01.Num() != SlabCells || OutField.WallPermeability01.Num() != SlabCells || OutField.Indoorness01.Num() != SlabCells ||
+        (OutField.SunVisibilityL1.Num() != 0 && OutField.SunVisibilityL1.Num() != SlabCells))
+    {
+        UE_LOG(LogThermoForge, Error, TEXT("Bake shard %s is corrupt or belongs to another volume"), *Path);
+        return false;
+    }
+    return true;
+}
+
+int32 UThermoForgeSubsystem::MergeBakeShards(const FThermoForgeBakeOptions& Options, FThermoForgeBakeReport& OutReport)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::MergeBakeShards);
+    UWorld* W = GetWorld();
+    OutReport = FThermoForgeBakeReport();
+    if (!W) return 0;
+
+    const double StartTime = FPlatformTime::Seconds();
+    OutReport.MapName = W->GetMapName();
+
+    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    {
+        AThermoForgeVolume* V = *It;
+        if (!IsVolumeSelected(V, Options)) continue;
+
+        const FString VolName = V->GetName();
+        TArray<FString> Files;
+        IFileManager::Get().FindFiles(Files, *(Options.ShardDir / (VolName + TEXT(".*of*.tfshard"))), /*Files*/true, /*Dirs*/false);
+        if (Files.Num() == 0) continue;
+
+        const double VolumeStart = FPlatformTime::Seconds();
+
+        // Load every slab, then order by slice range so the stitch does not depend on directory order
+        TArray<FThermoForgeBakedField> Slabs;
+        FThermoForgeBakeVolumeStats Stats;
+        Stats.VolumeName = VolName;
+        bool bValid = true;
+        for (const FString& File : Files)
+        {
+            FThermoForgeBakedField& Slab = Slabs.AddDefaulted_GetRef();
+            FThermoForgeBakeVolumeStats SlabStats;
+            if (!LoadBakeShard(Options.ShardDir / File, VolName, Slab, SlabStats)) { bValid = false; break; }
+
+            Stats.NumTraces   += SlabStats.NumTraces;
+            Stats.OpenBricks  += SlabStats.OpenBricks;
+            Stats.SolidBricks += SlabStats.SolidBricks;
+            Stats.Seconds     += SlabStats.Seconds;
+        }
+        if (!bValid) continue;
+
+        Slabs.Sort([](const FThermoForgeBakedField& A, const FThermoForgeBakedField& B) { return A.SliceBegin < B.SliceBegin; });
+
+        const FThermoForgeBakedField& First = Slabs[0];
+        int32 NextSlice = 0;
+        for (const FThermoForgeBakedField& Slab : Slabs)
+        {
+            const bool bSameGrid = Slab.Dim == First.Dim && Slab.CellSizeCm == First.CellSizeCm &&
+                                   Slab.OriginWS == First.OriginWS && Slab.GridRotation == First.GridRotation;
+            if (!bSameGrid || Slab.SliceBegin != NextSlice)
+            {
+                bValid = false;
+                break;
+            }
+            NextSlice = Slab.SliceEnd;
+        }
+        if (!bValid || NextSlice != First.Dim.Z)
+        {
+            UE_LOG(LogThermoForge, Error, TEXT("%s: shards in %s do not tile one grid (stale or missing files?); skipped"),
+                *VolName, *Options.ShardDir);
+            continue;
+        }
+
+        FThermoForgeBakedField Field;
+        Field.Dim          = First.Dim;
+        Field.CellSizeCm   = First.CellSizeCm;
+        Field.OriginWS     = First.OriginWS;
+        Field.GridRotation = First.GridRotation;
+        Field.SliceBegin   = 0;
+        Field.SliceEnd     = First.Dim.Z;
+        // Sun visibility only if every worker baked it (mixed settings fall back to isotropic solar gain)
+        const bool bSunVis = Slabs.FindByPredicate([](const FThermoForgeBakedField& Slab) { return Slab.SunVisibilityL1.IsEmpty(); }) == nullptr;
+        const int32 NumCells = First.Dim.X * First.Dim.Y * First.Dim.Z;
+        Field.SkyView01.Reserve(NumCells);
+        Field.WallPermeability01.Reserve(NumCells);
+        Field.Indoorness01.Reserve(NumCells);
+        if (bSunVis)
+            Field.SunVisibilityL1.Reserve(NumCells);
+
+        // Each slab is released once copied, so the merge peaks near one full field
+        for (FThermoForgeBakedField& Slab : Slabs)
+        {
+            Field.SkyView01.Append(Slab.SkyView01);
+            Field.WallPermeability01.Append(Slab.WallPermeability01);
+            Field.Indoorness01.Append(Slab.Indoorness01);
+            if (bSunVis)
+                Field.SunVisibilityL1.Append(Slab.SunVisibilityL1);
+            Slab.SkyView01.Empty();
+            Slab.WallPermeability01.Empty();
+            Slab.Indoorness01.Empty();
+            Slab.SunVisibilityL1.Empty();
+        }
+
+        Stats.Dim      = Field.Dim;
+        Stats.NumCells = Field.SkyView01.Num();
+    #if WITH_EDITOR
+        if (Options.bSaveAssets)
+            ApplyBakedField(V, Field, Options, Stats);
+    #endif
+        // Bake time summed over the workers plus this merge
+        Stats.Seconds += FPlatformTime::Seconds() - VolumeStart;
+
+        OutReport.TotalTraces += Stats.NumTraces;
+        OutReport.TotalCells  += Stats.NumCells;
+        OutReport.Volumes.Add(MoveTemp(Stats));
+    }
+
+    OutReport.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+    UE_LOG(LogThermoForge, Log, TEXT("Merged shards for %s: volumes=%d cells=%lld traces=%lld time=%.2fs"),
+        *OutReport.MapName, OutReport.Volumes.Num(), OutReport.TotalCells, OutReport.TotalTraces, OutReport.TotalSeconds);
+    return OutReport.Volumes.Num();
+}
+
+void UThermoForgeSubsystem::KickstartSamplingFromVolumes()
+{
+    FThermoForgeBakeReport Report;
+    RunBake(FThermoForgeBakeOptions(), Report);
+}
+
+// ---------- Public BP entry: nearest baked cell ----------
+bool UThermoForgeSubsystem::VolumeContainsPoint(const AThermoForgeVolume* Vol, const FVector& WorldLocation) const
+{
+    if (!Vol) return false;
+    if (Vol->bUnbounded) return true;
+
+    const FTransform T = Vol->GetActorTransform();
+    const FVector L = T.InverseTransformPosition(WorldLocation);
+    const FVector Min = -Vol->BoxExtent, Max = Vol->BoxExtent;
+    return (L.X >= Min.X && L.X <= Max.X)
+        && (L.Y >= Min.Y && L.Y <= Max.Y)
+        && (L.Z >= Min.Z && L.Z <= Max.Z);
+}
+
+bool UThermoForgeSubsystem::ComputeNearestInVolume(const AThermoForgeVolume* Vol, const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const
+{
+    if (!Vol || !ComputeNearestInField(Vol->BakedField, WorldLocation, OutHit)) return false;
+
+    OutHit.Volume = const_cast<AThermoForgeVolume*>(Vol);
+    return true;
+}
+
+bool UThermoForgeSubsystem::ComputeNearestInField(const UThermoForgeFieldAsset* Field, const FVector& WorldLocation, FThermoForgeGridHit& OutHit)
+{
+    if (!Field) return false;
+
+    const FIntVector D = Field->Dim;
+    if (D.X <= 0 || D.Y <= 0 || D.Z <= 0) return false;
+
+    const float Cell = Field->CellSizeCm;
+    if (Cell <= 0.f) return false;
+
+    // Use the asset's oriented frame (origin + rotation at bake time)
+    const FTransform Frame = Field->GetGridFrame();
+    const FTransform InvFrame = Frame.Inverse();
+
+    // Map world → grid-local (in cell units)
+    const FVector LocalGrid = InvFrame.TransformPosition(WorldLocation) / Cell;
+
+    // Nearest cell indices in grid space
+    const int32 ix = FMath::Clamp(FMath::FloorToInt(LocalGrid.X + 0.5f), 0, D.X - 1);
+    const int32 iy = FMath::Clamp(FMath::FloorToInt(LocalGrid.Y + 0.5f), 0, D.Y - 1);
+    const int32 iz = FMath::Clamp(FMath::FloorToInt(LocalGrid.Z + 0.5f), 0, D.Z - 1);
+
+    const int32 Nx = D.X, Ny = D.Y;
+    const int32 Linear = ix + iy * Nx + iz * Nx * Ny;
+
+    // Reconstruct WORLD cell center via the same frame
+    const FVector CellCenterWS = Frame.TransformPosition(
+        FVector((ix + 0.5f) * Cell, (iy + 0.5f) * Cell, (iz + 0.5f) * Cell));
+
+    const double DistSq = FVector::DistSquared(CellCenterWS, WorldLocation);
+
+    OutHit.bFound       = true;
+    OutHit.Field        = const_cast<UThermoForgeFieldAsset*>(Field);
+    OutHit.GridIndex    = FIntVector(ix, iy, iz);
+    OutHit.LinearIndex  = Linear;
+    OutHit.CellCenterWS = CellCenterWS;
+    OutHit.DistanceSq   = DistSq;
+    OutHit.CellSizeCm   = Cell;
+    return true;
+}
+
+
+
+bool UThermoForgeSubsystem::FindNearestBakedGridPoint(const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const
+{
+    UWorld* World = GetWorld();
+    if (!World) return false;
+
+    // A loaded chunk covering the point is the containing field
+    if (const AThermoForgeFieldChunk* Chunk = FindFieldChunkAt(WorldLocation))
+        if (ComputeNearestInField(Chunk->Field, WorldLocation, OutHit))
+            return true;
+
+    bool FoundInContaining = false;
+
+    for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+    {
+        const AThermoForgeVolume* Vol = *It;
+        if (!Vol || !Vol->BakedField) continue;
+
+        if (!VolumeContainsPoint(Vol, WorldLocation))
+            continue;
+
+        FThermoForgeGridHit Hit;
+        if (ComputeNearestInVolume(Vol, WorldLocation, Hit))
+        {
+            if (!FoundInContaining || Hit.DistanceSq < OutHit.DistanceSq)
+            {
+                OutHit = Hit;
+                FoundInContaining = true;
+            }
+        }
+    }
+
+    if (!FoundInContaining)
+    {
+        for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+        {
+            const AThermoForgeVolume* Vol = *It;
+            if (!Vol || !Vol->BakedField) continue;
+
+            FThermoForgeGridHit Hit;
+            if (ComputeNearestInVolume(Vol, WorldLocation, Hit))
+            {
+                if (!OutHit.bFound || Hit.DistanceSq < OutHit.DistanceSq)
+                {
+                    OutHit = Hit;
+                }
+            }
+        }
+
+        for (const TPair<FName, FThermoForgeChunkLayer>& Layer : ChunkLayers)
+            for (const TPair<FIntPoint, TWeakObjectPtr<AThermoForgeFieldChunk>>& Chunk : Layer.Value.Chunks)
+            {
+                FThermoForgeGridHit Hit;
+                const AThermoForgeFieldChunk* C = Chunk.Value.Get();
+                if (C && ComputeNearestInField(C->Field, WorldLocation, Hit) && (!OutHit.bFound || Hit.DistanceSq < OutHit.DistanceSq))
+                    OutHit = Hit;
+            }
+    }
+
+    return OutHit.bFound;
+}
+
+FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPoint(const FVector& WorldLocation, const FDateTime& QueryTimeUTC) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Query);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::QueryNearestBakedGridPoint);
+    INC_DWORD_STAT(STAT_ThermoForge_Queries);
+
+    FThermoForgeGridHit Best;
+    if (!FindNearestBakedGridPoint(WorldLocation, Best)) return Best;
+
+    Best.QueryTimeUTC = QueryTimeUTC;
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+
+    // Weather field at the cell (DefaultWeatherAlpha01 without a weather actor)
+    const FThermoForgeWeatherSample Weather = SampleWeatherAt(Best.CellCenterWS);
+    const float WeatherAlfa = Weather.GetWeatherAlpha01();
+    const float RainC       = Weather.GetAmbientOffsetC(S ? S->PrecipitationCoolingC : 0.f);
+
+    // Sun position for the query instant; the field's sun visibility (if baked) turns it into exposure
+    const FThermoForgeClimateTerms Terms = QueryTimeUTC == ClockTerms.TimeUTC ? ClockTerms : FThermoForgeClimateTerms::Compute(S, QueryTimeUTC);
+
+    const UThermoForgeFieldAsset* Field = Best.Field;
+    const float Sky      = Field->GetSolarExposureByLinearIdx(Best.LinearIndex, Terms.SunDirection);
+    const float WallPerm = FMath::Clamp(Field->GetWallPermByLinearIdx(Best.LinearIndex), 0.f, 1.f);
+
+    // Season-blended baseline minus its own ambient plus the phase-corrected ambient
+    // reduces to phase-corrected ambient + solar + sources, so compose once.
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
+
+    if (!Field->HasClimateOverrides())
+    {
+        const float AmbientC = ComputeAmbientForUTC(QueryTimeUTC, Best.CellCenterWS.Z) + RainC;
+        Best.CurrentTempC = ComposeTemperature(Best.CellCenterWS, Sky, WallPerm, AmbientC, WeatherAlfa, Sources);
+        return Best;
+    }
+
+    // Volume climate baked into the cell
+    const FThermoForgeClimate Climate = Field->GetClimateByLinearIdx(Best.LinearIndex, S);
+    const float AmbientC = Terms.AmbientAt(Climate, Best.CellCenterWS.Z) + RainC;
+    Best.CurrentTempC = ComposeTemperature(Best.CellCenterWS, Sky, WallPerm, AmbientC, WeatherAlfa, Sources, &Climate);
+
+    return Best;
+}
+
+// --------- Thermal clock ---------
+void UThermoForgeSubsystem::SetSimulationTimeUTC(const FDateTime& TimeUTC)
+{
+    // Recompute right away so queries later this frame see the new instant
+    ClockTerms = FThermoForgeClimateTerms::Compute(GetSettings(), TimeUTC);
+}
+
+void UThermoForgeSubsystem::AdvanceSimulationTime(float Seconds)
+{
+    SetSimulationTimeUTC(ClockTerms.TimeUTC + FTimespan::FromMilliseconds(FMath::RoundToDouble(double(Seconds) * 1000.0)));
+}
+
+void UThermoForgeSubsystem::SetClockMode(EThermoClockMode InMode, float InTimeScale)
+{
+    ClockMode      = InMode;
+    ClockTimeScale = FMath::Max(0.f, InTimeScale);
+}
+
+void UThermoForgeSubsystem::AdvanceClock(float DeltaTime, const UThermoForgeProjectSettings* S)
+{
+    FDateTime Time = ClockTerms.TimeUTC;
+    switch (ClockMode)
+    {
+        case EThermoClockMode::RealTime:
+            // The wall clock differs per machine; deterministic runs hold the clock until it is set
+            if (!(S && S->bDeterministicComposition)) Time = FDateTime::UtcNow();
+            break;
+        case EThermoClockMode::GameTime:
+            // DeltaTime already carries pause and time dilation; FTimespan ticks keep long sessions drift-free
+            Time += FTimespan::FromSeconds(double(DeltaTime) * ClockTimeScale);
+            break;
+        case EThermoClockMode::External:
+            if (ClockProvider.IsBound()) Time = ClockProvider.Execute();
+            break;
+    }
+
+    // Once per tick even when the instant is unchanged: the terms also follow the climate settings
+    ClockTerms = FThermoForgeClimateTerms::Compute(S, Time);
+}
+
+const FThermoForgeClimateTerms& UThermoForgeSubsystem::GetClimateTerms() const
+{
+    // Tick keeps Real Time current; without ticks (editor worlds) the terms would freeze at the last one
+    if (ClockMode == EThermoClockMode::RealTime)
+    {
+        const UThermoForgeProjectSettings* S = GetSettings();
+        const FDateTime Now = FDateTime::UtcNow();
+        if (!(S && S->bDeterministicComposition) && (Now - ClockTerms.TimeUTC).GetTotalSeconds() >= 1.0)
+            ClockTerms = FThermoForgeClimateTerms::Compute(S, Now);
+    }
+    return ClockTerms;
+}
+
+FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPointNow(const FVector& WorldLocation) const
+{
+    const FDateTime Now = GetQueryTimeUTC();
+
+    // Time-sliced mode: plain array read when the brick has been composed. Which bricks are composed depends on the
+    // wall-clock budget, so deterministic runs always compose the cell directly.
+    const UThermoForgeProjectSettings* S = GetSettings();
+    FThermoForgeGridHit Composed;
+    if (!(S && S->bDeterministicComposition) && ReadComposedCell(WorldLocation, Composed))
+    {
+        INC_DWORD_STAT(STAT_ThermoForge_Queries);
+        Composed.QueryTimeUTC = Now;
+        return Composed;
+    }
+
+    return QueryNearestBakedGridPoint(WorldLocation, Now);
+}
+
+bool UThermoForgeSubsystem::SampleComposedTemperatureAt(const FVector& WorldPos, float& OutTempC) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Query);
+    INC_DWORD_STAT(STAT_ThermoForge_Queries);
+
+    FThermoForgeGridHit Hit;
+    if (!ReadComposedCell(WorldPos, Hit)) return false;
+    OutTempC = Hit.CurrentTempC;
+    return true;
+}
+
+float UThermoForgeSubsystem::ComputeAmbientForUTC(const FDateTime& TimeUTC, float WorldZcm) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (TimeUTC == ClockTerms.TimeUTC)
+        return ClockTerms.AmbientAt(S, WorldZcm);
+    return ComputeAmbientForUTC(S, TimeUTC, WorldZcm);
+}
+
+float UThermoForgeSubsystem::ComputeAmbientForUTC(const UThermoForgeProjectSettings* S, const FDateTime& TimeUTC, float WorldZcm)
+{
+    return FThermoForgeClimateTerms::Compute(S, TimeUTC).AmbientAt(S, WorldZcm);
+}
+
+float FThermoForgeClimateTerms::AmbientAt(const UThermoForgeProjectSettings* S, float WorldZcm) const
+{
+    return S ? S->AdjustForAltitude(AmbientSeaC, WorldZcm) : AmbientSeaC;
+}
+
+FThermoForgeClimateTerms FThermoForgeClimateTerms::Compute(const UThermoForgeProjectSettings* S, const FDateTime& TimeUTC)
+{
+    // --- Time of day from UTC (continuous hours) ---
+    const double SecUTC   = TimeUTC.GetTimeOfDay().GetTotalSeconds();
+    const float TimeHours = ([](float h){ float r = FMath::Fmod(h, 24.f); return (r < 0.f) ? r + 24.f : r; })
+                            (static_cast<float>(SecUTC / 3600.0f));
+
+    // --- Smooth seasonal alpha (0 = deep winter, 1 = peak summer), Northern Hemisphere ---
+    // Dec 21 (~355) -> 0, Jun 21 (~172) -> 1, smooth cosine over the year
+    auto Wrap01 = [](float x){ return x - FMath::FloorToFloat(x); };
+    const int32 DOY           = TimeUTC.GetDayOfYear();                 // 1..365/366
+    const float YearPos       = Wrap01((float(DOY) - 355.0f) / 365.0f); // 0..1 starting at Dec 21
+    const bool bTables        = S && S->bDeterministicComposition;
+    auto Cos = [bTables](float x){ return bTables ? FThermoForgeDeterministicMath::Cos(x) : FMath::Cos(x); };
+    const float SeasonAlpha01 = 0.5f * (1.0f - Cos(2.0f * PI * YearPos)); // 0→1→0 yearly
+
+    // 00:00 trough, 12:00 peak
+    const float Phase   = (TimeHours - 12.0f) / 24.0f;
+    const float CosWave = Cos(2.0f * PI * Phase);
+
+    FThermoForgeClimateTerms Terms;
+    Terms.TimeUTC       = TimeUTC;
+    Terms.TimeHours     = TimeHours;
+    Terms.SeasonAlpha01 = SeasonAlpha01;
+    Terms.DiurnalWave   = CosWave;
+    Terms.AmbientSeaC   = FThermoForgeClimate::FromSettings(S).SeaLevelAmbient(SeasonAlpha01, CosWave);
+    Terms.SunDirection  = ComputeSunDirection(S, TimeHours, SeasonAlpha01);
+    return Terms;
+}
+
+FVector FThermoForgeClimateTerms::ComputeSunDirection(const UThermoForgeProjectSettings* S, float TimeHours, float SeasonAlpha01)
+{
+    const bool bTables = S && S->bDeterministicComposition;
+    auto Cos = [bTables](float x){ return bTables ? FThermoForgeDeterministicMath::Cos(x) : FMath::Cos(x); };
+    auto Sin = [&Cos](float x){ return Cos(x - HALF_PI); };
+
+    // Declination follows the same seasonal alpha as the ambient curve; hour angle is 0 at solar noon
+    const float Decl = FMath::DegreesToRadians(FMath::Lerp(-23.44f, 23.44f, FMath::Clamp(SeasonAlpha01, 0.f, 1.f)));
+    const float Lat  = FMath::DegreesToRadians(S ? FMath::Clamp(S->SunLatitudeDeg, -90.f, 90.f) : 45.f);
+    const float Hour = FMath::DegreesToRadians(15.f * (TimeHours - 12.f));
+
+    const float East  = -Cos(Decl) * Sin(Hour);
+    const float North = Cos(Lat) * Sin(Decl) - Sin(Lat) * Cos(Decl) * Cos(Hour);
+    const float Up    = Sin(Lat) * Sin(Decl) + Cos(Lat) * Cos(Decl) * Cos(Hour);
+
+    // North is NorthYawDeg around +Z from world +X, east 90° clockwise of it seen from above (UE is left-handed)
+    const float Yaw = FMath::DegreesToRadians(S ? S->NorthYawDeg : 0.f);
+    const FVector N(Cos(Yaw), Sin(Yaw), 0.f);
+    const FVector E(-Sin(Yaw), Cos(Yaw), 0.f);
+    return (North * N + East * E + FVector(0.f, 0.f, Up)).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+}
+
+// --------- Runtime composition ---------
+float UThermoForgeSubsystem::ComputeCurrentTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Query);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ComputeCurrentTemperatureAt);
+    INC_DWORD_STAT(STAT_ThermoForge_Queries);
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S) return 0.f;
+
+    // Find nearest baked field and read both scalars (and its climate)
+    float Sky = 0.f;
+    float WallPerm = 1.f;
+    FThermoForgeClimate Climate = FThermoForgeClimate::FromSettings(S);
+
+    {
+        UWorld* World = GetWorld();
+        FThermoForgeGridHit Best;
+        if (const AThermoForgeFieldChunk* Chunk = FindFieldChunkAt(WorldPos))
+        {
+            ComputeNearestInField(Chunk->Field, WorldPos, Best);
+        }
+        else if (World)
+        {
+            for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+            {
+                const AThermoForgeVolume* Vol = *It;
+                if (!Vol || !Vol->BakedField) continue;
+
+                FThermoForgeGridHit Hit;
+                if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) continue;
+
+                if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
+                    Best = Hit;
+            }
+        }
+
+        if (Best.bFound && Best.Field)
+        {
+            const FVector SunDir = FThermoForgeClimateTerms::ComputeSunDirection(S, TimeHours, bWinter ? 0.f : 1.f);
+            Sky      = Best.Field->GetSolarExposureByLinearIdx(Best.LinearIndex, SunDir);
+            WallPerm = FMath::Clamp(Best.Field->GetWallPermByLinearIdx(Best.LinearIndex), 0.f, 1.f);
+            if (Best.Field->HasClimateOverrides())
+                Climate = Best.Field->GetClimateByLinearIdx(Best.LinearIndex, S);
+        }
+    }
+
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
+
+    // Ambient + altitude
+    const float AmbientC = Climate.GetAmbientCelsiusAt(bWinter, TimeHours, WorldPos.Z, S->bDeterministicComposition);
+    return ComposeTemperature(WorldPos, Sky, WallPerm, AmbientC, WeatherAlpha01, Sources, &Climate);
+}
+
+FThermoForgeTemperatureGradient UThermoForgeSubsystem::SampleTemperatureGradient(const FVector& WorldPos, bool bWinter,
+    float TimeHours, float WeatherAlpha01) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Query);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::SampleTemperatureGradient);
+    INC_DWORD_STAT(STAT_ThermoForge_Queries);
+
+    FThermoForgeTemperatureGradient Out;
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S) return Out;
+
+    float Sky = 0.f, WallPerm = 1.f;
+    FVector SkyGrad = FVector::ZeroVector, WallGrad = FVector::ZeroVector;
+    FThermoForgeClimate Climate = FThermoForgeClimate::FromSettings(S);
+
+    FThermoForgeGridHit Hit;
+    if (FindNearestBakedGridPoint(WorldPos, Hit) && Hit.Field)
+    {
+        // Outside the interpolable grid (last half cell, or away from any volume) the nearest cell is flat
+        if (!Hit.Field->SampleSkyWallWithGradient(WorldPos, Sky, SkyGrad, WallPerm, WallGrad))
+        {
+            Sky      = Hit.Field->GetSkyViewByLinearIdx(Hit.LinearIndex);
+            WallPerm = Hit.Field->GetWallPermByLinearIdx(Hit.LinearIndex);
+        }
+        Sky      = FMath::Clamp(Sky, 0.f, 1.f);
+        WallPerm = FMath::Clamp(WallPerm, 0.f, 1.f);
+        Out.bInField = true;
+
+        // Sun visibility: scale the interpolated sky (and its slope) by the nearest cell's exposure/openness ratio
+        if (Hit.Field->HasSunVisibility())
+        {
+            const FVector SunDir = FThermoForgeClimateTerms::ComputeSunDirection(S, TimeHours, bWinter ? 0.f : 1.f);
+            const float CellSky  = FMath::Clamp(Hit.Field->GetSkyViewByLinearIdx(Hit.LinearIndex), 0.f, 1.f);
+            const float Ratio    = CellSky > UE_KINDA_SMALL_NUMBER
+                                 ? Hit.Field->GetSolarExposureByLinearIdx(Hit.LinearIndex, SunDir) / CellSky : 0.f;
+            Sky     *= Ratio;
+            SkyGrad *= Ratio;
+        }
+
+        // Nearest cell's climate; the blend itself is not differentiated
+        if (Hit.Field->HasClimateOverrides())
+            Climate = Hit.Field->GetClimateByLinearIdx(Hit.LinearIndex, S);
+    }
+
+    // Same terms as ComposeTemperature, each with its derivative
+    float TempC = Climate.GetAmbientCelsiusAt(bWinter, TimeHours, WorldPos.Z, S->bDeterministicComposition);
+    FVector Grad(0.f, 0.f, Climate.LapseRateCPerKm > 0.f ? -Climate.LapseRateCPerKm / 100000.f : 0.f); // lapse is linear in Z (°C/cm)
+
+    const float SolarScale = Climate.SolarGainScaleC * (1.f - FMath::Clamp(WeatherAlpha01, 0.f, 1.f));
+    TempC += SolarScale * Sky;
+    Grad  += SolarScale * SkyGrad;
+
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
+    INC_DWORD_STAT(STAT_ThermoForge_ComposedCells);
+    INC_DWORD_STAT_BY(STAT_ThermoForge_SourceEvals, Sources.Num());
+
+    if (Sources.Num() > 0)
+    {
+        FThermoForgeTraceContext Ctx = MakeTraceContext();
+        for (const FThermoForgeSourceState& Sc : Sources)
+        {
+            FVector SourceGrad;
+            const float Intensity = Sc.SampleAt(WorldPos, SourceGrad);
+            if (Intensity == 0.f) continue;
+
+            const float Occ = S->bDeterministicComposition ? 1.f : Ctx.OcclusionBetween(WorldPos, Sc.GetLocation(), S->DefaultCellSizeCm);
+            TempC += Intensity * Occ * WallPerm;
+            Grad  += Occ * (SourceGrad * WallPerm + Intensity * WallGrad);
+        }
+        Ctx.EmitStats();
+    }
+
+    Out.TemperatureC      = TempC;
+    Out.GradientCPerCm    = Grad;
+    Out.DirectionToWarmth = Grad.GetSafeNormal();
+    return Out;
+}
+
+void UThermoForgeSubsystem::ComputeFieldTemperatures(const UThermoForgeFieldAsset* Field, int32 Count, bool bWinter,
+    float TimeHours, float WeatherAlpha01, TArray<float>& OutTempC) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Composition);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ComputeFieldTemperatures);
+    OutTempC.Reset();
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!Field || !S) return;
+
+    const FIntVector D = Field->Dim;
+    if (D.X <= 0 || D.Y <= 0 || D.Z <= 0) return;
+
+    Count = FMath::Clamp(Count, 0, D.X * D.Y * D.Z);
+    OutTempC.SetNumZeroed(Count);
+    if (Count == 0) return;
 
-    if (UPrimitiveComponent* PC = Hit.GetComponent())
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
+    const FVector SunDir = FThermoForgeClimateTerms::ComputeSunDirection(S, TimeHours, bWinter ? 0.f : 1.f);
+
+    ParallelFor(Count, [&](int32 i)
     {
-        if (PC->BodyInstance.GetSimplePhysicalMaterial())
-            return PC->BodyInstance.GetSimplePhysicalMaterial();
-        if (UBodySetup* BS = PC->GetBodySetup())
-            if (BS->PhysMaterial)
-                return BS->PhysMaterial;
-    }
-    return nullptr;
+        OutTempC[i] = ComposeFieldCell(Field, i, bWinter, TimeHours, SunDir, WeatherAlpha01, Sources);
+    });
 }
 
-static float TF_GetHitDensityKgM3(const FHitResult& Hit, const UThermoForgeProjectSettings* S)
+void UThermoForgeSubsystem::ComputeFieldCellTemperatures(const UThermoForgeFieldAsset* Field, TConstArrayView<int32> Cells,
+    bool bWinter, float TimeHours, float WeatherAlpha01, TArray<float>& OutTempC) const
 {
-    if (!S) return 1.f;
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Composition);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ComputeFieldCellTemperatures);
+    OutTempC.Reset();
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!Field || !S) return;
+
+    const FIntVector D = Field->Dim;
+    const int32 N = D.X * D.Y * D.Z;
+    if (D.X <= 0 || D.Y <= 0 || D.Z <= 0) return;
+
+    OutTempC.SetNumZeroed(Cells.Num());
+    if (Cells.IsEmpty()) return;
 
-    if (S->bUsePhysicsMaterialForDensity)
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
+    const FVector SunDir = FThermoForgeClimateTerms::ComputeSunDirection(S, TimeHours, bWinter ? 0.f : 1.f);
+
+    ParallelFor(Cells.Num(), [&](int32 k)
     {
-        if (UPhysicalMaterial* PM = TF_ResolvePhysicalMaterial(Hit))
-        {
-            const float Found = PM->Density;
-            return FMath::Max(0.f, Found);
-        }
-    }
-    return S->bTreatMissingPhysMatAsAir ? S->AirDensityKgM3 : S->UnknownHitDensityKgM3;
+        if (Cells[k] >= 0 && Cells[k] < N)
+            OutTempC[k] = ComposeFieldCell(Field, Cells[k], bWinter, TimeHours, SunDir, WeatherAlpha01, Sources);
+    });
 }
 
-// ---- single ray permeability (Beer–Lambert on hit) ----
-float UThermoForgeSubsystem::TraceAmbientRay01(const FVector& P, const FVector& Dir, float MaxLen) const
+float UThermoForgeSubsystem::ComposeFieldCell(const UThermoForgeFieldAsset* Field, int32 Linear, bool bWinter, float TimeHours,
+    const FVector& SunDir, float WeatherAlpha01, TConstArrayView<FThermoForgeSourceState> Sources) const
 {
-    const UWorld* W = GetWorld();
     const UThermoForgeProjectSettings* S = GetSettings();
-    if (!W || !S) return 1.f;
+    const FIntVector D = Field->Dim;
+    const float Cell = Field->CellSizeCm;
+
+    const int32 x = Linear % D.X;
+    const int32 y = (Linear / D.X) % D.Y;
+    const int32 z = Linear / (D.X * D.Y);
+    const FVector P = Field->GetGridFrame().TransformPosition(FVector((x + 0.5f) * Cell, (y + 0.5f) * Cell, (z + 0.5f) * Cell));
+
+    const float Sky      = Field->GetSolarExposureByLinearIdx(Linear, SunDir);
+    const float WallPerm = FMath::Clamp(Field->GetWallPermByLinearIdx(Linear), 0.f, 1.f);
+    if (!Field->HasClimateOverrides())
+        return ComposeTemperature(P, Sky, WallPerm, S->GetAmbientCelsiusAt(bWinter, TimeHours, P.Z), WeatherAlpha01, Sources);
 
-    FHitResult Hit;
-    FCollisionQueryParams Q(SCENE_QUERY_STAT(ThermoAmbient), S->bTraceComplex);
-    Q.bReturnPhysicalMaterial = true;
+    const FThermoForgeClimate Climate = Field->GetClimateByLinearIdx(Linear, S);
+    const float AmbientC = Climate.GetAmbientCelsiusAt(bWinter, TimeHours, P.Z, S->bDeterministicComposition);
+    return ComposeTemperature(P, Sky, WallPerm, AmbientC, WeatherAlpha01, Sources, &Climate);
+}
+
+void UThermoForgeSubsystem::ComputeTemperaturesAt(TConstArrayView<FVector> Points, TConstArrayView<float> Sky,
+    TConstArrayView<float> WallPerm, bool bWinter, float TimeHours, float WeatherAlpha01, TArray<float>& OutTempC) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Composition);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ComputeTemperaturesAt);
+    OutTempC.Reset();
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S || Sky.Num() != Points.Num() || WallPerm.Num() != Points.Num()) return;
 
-    const bool bHit = W->LineTraceSingleByChannel(
-        Hit, P, P + Dir * MaxLen,
-        static_cast<ECollisionChannel>(S->TraceChannel.GetValue()),
-        Q);
+    OutTempC.SetNumZeroed(Points.Num());
 
-    if (!bHit) return 1.f;
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
 
-    const float rho   = TF_GetHitDensityKgM3(Hit, S);
-    const float Lfrac = S->FaceThicknessFactor;
-    return S->DensityToPermeability(rho, Lfrac);
+    ParallelFor(Points.Num(), [&](int32 i)
+    {
+        const FVector& P = Points[i];
+        const float AmbientC = S->GetAmbientCelsiusAt(bWinter, TimeHours, P.Z);
+        OutTempC[i] = ComposeTemperature(P, FMath::Clamp(Sky[i], 0.f, 1.f), FMath::Clamp(WallPerm[i], 0.f, 1.f),
+                                         AmbientC, WeatherAlpha01, Sources);
+    });
 }
 
-float UThermoForgeSubsystem::OcclusionBetween(const FVector& A, const FVector& B, float CellSizeCm) const
+float UThermoForgeSubsystem::ComposeTemperature(const FVector& WorldPos, float Sky, float WallPerm, float AmbientC,
+    float WeatherAlpha01, TConstArrayView<FThermoForgeSourceState> Sources, const FThermoForgeClimate* Climate) const
 {
-    const UWorld* W = GetWorld();
     const UThermoForgeProjectSettings* S = GetSettings();
-    if (!W || !S) return 1.f;
+    if (Sources.IsEmpty() || (S && S->bDeterministicComposition))
+        return ComposeTemperature(S, nullptr, WorldPos, Sky, WallPerm, AmbientC, WeatherAlpha01, Sources, Climate);
+
+    FThermoForgeTraceContext Ctx = MakeTraceContext();
+    const float TempC = ComposeTemperature(S, &Ctx, WorldPos, Sky, WallPerm, AmbientC, WeatherAlpha01, Sources, Climate);
+    Ctx.EmitStats();
+    return TempC;
+}
 
-    FHitResult Hit;
-    FCollisionQueryParams Q(SCENE_QUERY_STAT(ThermoSource), S->bTraceComplex);
-    Q.bReturnPhysicalMaterial = true;
+float UThermoForgeSubsystem::ComposeTemperature(const UThermoForgeProjectSettings* S, FThermoForgeTraceContext* TraceContext,
+    const FVector& WorldPos, float Sky, float WallPerm, float AmbientC, float WeatherAlpha01,
+    TConstArrayView<FThermoForgeSourceState> Sources, const FThermoForgeClimate* Climate)
+{
+    if (!S) return AmbientC;
 
-    const bool bHit = W->LineTraceSingleByChannel(
-        Hit, A, B,
-        static_cast<ECollisionChannel>(S->TraceChannel.GetValue()),
-        Q);
+    INC_DWORD_STAT(STAT_ThermoForge_ComposedCells);
+    INC_DWORD_STAT_BY(STAT_ThermoForge_SourceEvals, Sources.Num());
 
-    if (!bHit) return 1.f; // open
+    // Solar gain (reduced by weather)
+    const float SolarScale = Climate ? Climate->SolarGainScaleC : S->SolarGainScaleC;
+    const float Solar = SolarScale * Sky * (1.f - FMath::Clamp(WeatherAlpha01, 0.f, 1.f));
 
-    const float rho   = TF_GetHitDensityKgM3(Hit, S);
-    const float Dist  = FVector::Distance(A, B);
-    const float Cell  = FMath::Max(1.f, CellSizeCm);
-    const float Lfrac = (Dist / Cell) * S->FaceThicknessFactor;
+    // Dynamic sources (attenuated by LOS * local wall permeability)
+    float SourceSum = 0.f;
+    for (const FThermoForgeSourceState& Sc : Sources)
+    {
+        const float Intensity = Sc.SampleAt(WorldPos); // °C delta
+        if (Intensity == 0.f) continue;
+
+        // Deterministic mode is field-only: trace hits depend on physics state that is not part of the inputs
+        const float CellSize = S->DefaultCellSizeCm;
+        const float Occ = (TraceContext && !S->bDeterministicComposition) ? TraceContext->OcclusionBetween(WorldPos, Sc.GetLocation(), CellSize) : 1.f;
+        // WallPerm scales local transmissivity
+        SourceSum += Intensity * Occ * WallPerm;
+    }
 
-    return S->DensityToPermeability(rho, Lfrac);
+    return AmbientC + Solar + SourceSum;
 }
 
-// ---- main bake: SkyView01 + WallPermeability01 (+ Indoorness01) ----
-void UThermoForgeSubsystem::KickstartSamplingFromVolumes()
+// --------- Time-sliced composition ---------
+void UThermoForgeSubsystem::Tick(float DeltaTime)
 {
-    UWorld* W = GetWorld();
     const UThermoForgeProjectSettings* S = GetSettings();
-    if (!W || !S) return;
 
-    // Small, deterministic hemisphere (sky openness)
-    TArray<FVector> HemiDirs;
+    // Everything below (snapshot, watches, composition) reads this tick's clock
+    AdvanceClock(DeltaTime, S);
+    if (S) UpdateWeather(DeltaTime, S);
+
+    if (S && S->bPublishQuerySnapshot)
     {
-        const FVector base[12] = {
-            { 0, 0, 1}, { 0.5, 0, 0.866f}, {-0.5, 0, 0.866f}, {0, 0.5, 0.866f}, {0, -0.5, 0.866f},
-            { 0.707f, 0.707f, 0}, {-0.707f, 0.707f, 0}, {0.707f,-0.707f, 0}, {-0.707f,-0.707f, 0},
-            { 0.923f, 0, 0.382f}, {-0.923f, 0, 0.382f}, {0, 0.923f, 0.382f}
-        };
-        HemiDirs.Append(base, UE_ARRAY_COUNT(base));
-        for (FVector& d : HemiDirs) d.Normalize();
+        PublishSnapshot();
+    }
+    else if (PublishedSnapshot.IsValid())
+    {
+        TSharedPtr<const FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> Previous;
+        {
+            FWriteScopeLock Lock(SnapshotLock);
+            Swap(PublishedSnapshot, Previous);
+        }
+        FieldSnapshots.Empty();
     }
 
-    auto FloorDiv = [](double X, double Step, double Origin) -> int32
-    { return FMath::FloorToInt((X - Origin) / Step); };
-    auto CeilDiv = [](double X, double Step, double Origin) -> int32
-    { return FMath::CeilToInt((X - Origin) / Step); };
+    if (S) UpdateWatches(DeltaTime, S);
 
-    int32 VolumeCount = 0;
-    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    if (!S || !S->bEnableTimeSlicedComposition)
     {
-        AThermoForgeVolume* V = *It; ++VolumeCount;
-        const FTransform Frame = V->GetGridFrame();
-        const FTransform InvFrame = Frame.Inverse();
-        
-        const FBox Bounds = V->GetWorldBounds();
-        const float   Cell   = V->GetEffectiveCellSize();
-        const FVector Origin = V->GetEffectiveGridOrigin();
-
-        // Transform world AABB corners into grid space (so indices align to the rotated grid)
-        FVector Corners[8] = {
-            FVector(Bounds.Min.X, Bounds.Min.Y, Bounds.Min.Z),
-            FVector(Bounds.Min.X, Bounds.Min.Y, Bounds.Max.Z),
-            FVector(Bounds.Min.X, Bounds.Max.Y, Bounds.Min.Z),
-            FVector(Bounds.Min.X, Bounds.Max.Y, Bounds.Max.Z),
-            FVector(Bounds.Max.X, Bounds.Min.Y, Bounds.Min.Z),
-            FVector(Bounds.Max.X, Bounds.Min.Y, Bounds.Max.Z),
-            FVector(Bounds.Max.X, Bounds.Max.Y, Bounds.Min.Z),
-            FVector(Bounds.Max.X, Bounds.Max.Y, Bounds.Max.Z),
-        };
-        FBox GridBox(ForceInit);
-        for (int i=0; i<8; ++i)
+        if (!ComposedChannels.IsEmpty() && PendingCompositionTask.IsCompleted())
         {
-            GridBox += InvFrame.TransformPosition(Corners[i]); // world → grid (rotate & translate)
+            PendingComposition.Reset();
+            ComposedChannels.Empty();
         }
+        return;
+    }
 
-        // Index range in grid space
-        auto FloorDiv0 = [](double X, double Step)->int32 { return FMath::FloorToInt(X / Step); };
-        auto CeilDiv0  = [](double X, double Step)->int32 { return FMath::CeilToInt (X / Step); };
+    ApplyCompletedComposition();
 
-        const int32 ix0 = FloorDiv0(GridBox.Min.X, Cell);
-        const int32 iy0 = FloorDiv0(GridBox.Min.Y, Cell);
-        const int32 iz0 = FloorDiv0(GridBox.Min.Z, Cell);
+    // One pass in flight at a time; channel indices stay stable until it is applied.
+    if (PendingComposition.IsValid()) return;
 
-        const int32 ix1 = CeilDiv0 (GridBox.Max.X, Cell) - 1;
-        const int32 iy1 = CeilDiv0 (GridBox.Max.Y, Cell) - 1;
-        const int32 iz1 = CeilDiv0 (GridBox.Max.Z, Cell) - 1;
+    SyncComposedChannels();
+    ScheduleComposition();
+}
 
-        const FIntVector Dim(
-            FMath::Max(0, ix1 - ix0 + 1),
-            FMath::Max(0, iy1 - iy0 + 1),
-            FMath::Max(0, iz1 - iz0 + 1)
-        );
+// --------- Query snapshot ---------
+TSharedPtr<const FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> UThermoForgeSubsystem::AcquireSnapshot() const
+{
+    // The copy takes its reference while the writer is excluded, so the snapshot cannot be released in between
+    FReadScopeLock Lock(SnapshotLock);
+    return PublishedSnapshot;
+}
 
-        const int32 Nx = Dim.X, Ny = Dim.Y, Nz = Dim.Z;
-        const int32 N  = Nx * Ny * Nz;
-        if (N <= 0) continue;
+void UThermoForgeSubsystem::PublishSnapshot()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::PublishSnapshot);
 
-        // World origin of the [ix0,iy0,iz0] corner via the frame
-        const FVector FieldOriginWS = Frame.TransformPosition(FVector(ix0 * Cell, iy0 * Cell, iz0 * Cell));
+    const TSharedRef<FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> Snapshot = BuildSnapshot();
 
-        auto Index = [&](int32 x,int32 y,int32 z)->int32 { return (z * Ny + y) * Nx + x; };
+    // Swap under the lock, release the previous one outside it (its last reference may free a lot of memory)
+    TSharedPtr<const FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> Previous = Snapshot;
+    {
+        FWriteScopeLock Lock(SnapshotLock);
+        Swap(PublishedSnapshot, Previous);
+    }
+}
 
-        // Center of a cell in WORLD space: go LS → WS through the frame
-        auto Center = [&](int32 x,int32 y,int32 z)
-        {
-            const FVector CenterLS(
-                (ix0 + x + 0.5f) * Cell,
-                (iy0 + y + 0.5f) * Cell,
-                (iz0 + z + 0.5f) * Cell
-            );
-            return Frame.TransformPosition(CenterLS);
-        };
-        
-        TArray<float> Sky;   Sky.SetNumZeroed(N);
-        TArray<float> Wall;  Wall.SetNumZeroed(N);
-        TArray<float> Indoor;Indoor.SetNumZeroed(N);
+TSharedRef<FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> UThermoForgeSubsystem::BuildSnapshot()
+{
+    check(IsInGameThread());
 
-        const float RayLen = 100000.f; // 1km
+    const UThermoForgeProjectSettings* S = GetSettings();
+    UWorld* World = GetWorld();
 
-        for (int32 z=0; z<Nz; ++z)
-        for (int32 y=0; y<Ny; ++y)
-        for (int32 x=0; x<Nx; ++x)
+    TSharedRef<FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FThermoForgeWorldSnapshot, ESPMode::ThreadSafe>();
+    Snapshot->FrameNumber    = GFrameCounter;
+    Snapshot->TimeUTC        = ClockTerms.TimeUTC;
+    Snapshot->Climate        = ClockTerms;
+    Snapshot->DefaultClimate = FThermoForgeClimate::FromSettings(S);
+    Snapshot->WeatherAlpha01 = S ? S->DefaultWeatherAlpha01 : 0.3f;
+    Snapshot->Weather        = WeatherField;
+    Snapshot->World          = World;
+    Snapshot->Settings       = S;
+    Snapshot->DensityCache   = DensityCache;
+    GatherSourceStates(Snapshot->Sources);
+
+    TMap<FObjectKey, FCachedFieldSnapshot> InUse;
+
+    // Chunks first: a containing chunk wins, as in FindNearestBakedGridPoint
+    for (const TPair<FName, FThermoForgeChunkLayer>& Layer : ChunkLayers)
+        for (const TPair<FIntPoint, TWeakObjectPtr<AThermoForgeFieldChunk>>& It : Layer.Value.Chunks)
         {
-            const int32 idx = Index(x,y,z);
-            const FVector P = Center(x,y,z);
-
-            // Sky openness (hemisphere)
-            float openness = 0.f;
-            for (const FVector& d : HemiDirs)
-                openness += TraceAmbientRay01(P, d, RayLen);
-            openness /= (float)HemiDirs.Num();
-            openness = FMath::Clamp(openness, 0.f, 1.f);
-            Sky[idx] = openness;
-
-            // Wall permeability: average occlusion to 6 neighbor centers
-            float sumPerm = 0.f; int32 cnt = 0;
-            const int32 nx[6] = { x-1, x+1, x,   x,   x,   x   };
-            const int32 ny[6] = { y,   y,   y-1, y+1, y,   y   };
-            const int32 nz[6] = { z,   z,   z,   z,   z-1, z+1 };
-
-            for (int i=0;i<6;++i)
-            {
-                const int32 xx = nx[i], yy = ny[i], zz = nz[i];
-                if (xx<0 || yy<0 || zz<0 || xx>=Nx || yy>=Ny || zz>=Nz) continue;
-
-                const FVector Q = Center(xx,yy,zz);
-                const float perm = OcclusionBetween(P, Q, Cell); // 0..1, uses physmat density
-                sumPerm += FMath::Clamp(perm, 0.f, 1.f);
-                ++cnt;
-            }
-            const float wallPerm = (cnt>0) ? (sumPerm / cnt) : 1.f;
-            Wall[idx] = wallPerm;
-
-            // Composite indoor proxy
-            Indoor[idx] = (1.f - Sky[idx]) * (1.f - Wall[idx]);
+            const AThermoForgeFieldChunk* Chunk = It.Value.Get();
+            TSharedPtr<const FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> Field = Chunk ? GetFieldSnapshot(Chunk->Field, InUse) : nullptr;
+            if (!Field) continue;
+
+            // The chunk covers exactly its field's cells
+            const FVector Half = FVector(Field->Dim) * (0.5f * Field->CellSizeCm);
+            FThermoForgeSnapshotVolume& V = Snapshot->Volumes.AddDefaulted_GetRef();
+            V.Transform = FTransform(Field->Frame.GetRotation(), Field->Frame.TransformPosition(Half));
+            V.BoxExtent = Half;
+            V.bChunk    = true;
+            V.Field     = Field;
         }
 
-    #if WITH_EDITOR
-        if (UThermoForgeFieldAsset* Saved = CreateAndSaveFieldAsset(V, Dim, Cell, FieldOriginWS, Frame.Rotator(), Sky, Wall, Indoor))
+    if (World)
+    {
+        for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
         {
-            V->Modify();
-            V->BakedField = Saved;
-        #if WITH_EDITORONLY_DATA
-            V->GridPreviewISM->SetVisibility(true);
-        #endif
-            V->BuildHeatPreviewFromField();
-            V->MarkPackageDirty();
+            const AThermoForgeVolume* Vol = *It;
+            TSharedPtr<const FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> Field = Vol ? GetFieldSnapshot(Vol->BakedField, InUse) : nullptr;
+            if (!Field) continue;
+
+            FThermoForgeSnapshotVolume& V = Snapshot->Volumes.AddDefaulted_GetRef();
+            V.Transform  = Vol->GetActorTransform();
+            V.BoxExtent  = Vol->BoxExtent;
+            V.bUnbounded = Vol->bUnbounded;
+            V.Field      = Field;
         }
-    #endif
     }
 
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] KickstartSamplingFromVolumes (with wall traces): volumes=%d"), VolumeCount);
+    // Fields no longer referenced drop out of the cache here
+    FieldSnapshots = MoveTemp(InUse);
+    return Snapshot;
 }
-// ---------- Public BP entry: nearest baked cell ----------
-bool UThermoForgeSubsystem::VolumeContainsPoint(const AThermoForgeVolume* Vol, const FVector& WorldLocation) const
+
+// --------- Watches ---------
+void UThermoForgeSubsystem::UpdateWatches(float DeltaTime, const UThermoForgeProjectSettings* S)
 {
-    if (!Vol) return false;
-    if (Vol->bUnbounded) return true;
+    // Delegates fire on the game thread, one tick after the pass was gathered
+    if (PendingWatchPass.IsValid())
+    {
+        if (!PendingWatchTask.IsCompleted()) return;
 
-    const FTransform T = Vol->GetActorTransform();
-    const FVector L = T.InverseTransformPosition(WorldLocation);
-    const FVector Min = -Vol->BoxExtent, Max = Vol->BoxExtent;
-    return (L.X >= Min.X && L.X <= Max.X)
-        && (L.Y >= Min.Y && L.Y <= Max.Y)
-        && (L.Z >= Min.Z && L.Z <= Max.Z);
-}
+        TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ApplyWatches);
+        const FWatchPass& Pass = *PendingWatchPass;
+        for (int32 i = 0; i < Pass.Watches.Num(); ++i)
+        {
+            UThermoForgeWatchComponent* Watch = Pass.Watches[i].Get();
+            if (Watch && Watch->bWatchEnabled)
+                Watch->ApplyTemperature(Pass.TempC[i]);
+        }
+        PendingWatchPass.Reset();
+        PendingWatchTask = UE::Tasks::FTask();
+    }
 
-bool UThermoForgeSubsystem::ComputeNearestInVolume(const AThermoForgeVolume* Vol, const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const
-{
-    if (!Vol || !Vol->BakedField) return false;
+    WatchAccumulator += DeltaTime;
+    const float Interval = 1.f / FMath::Max(0.1f, S->WatchUpdateRateHz);
+    if (WatchAccumulator < Interval) return;
+    WatchAccumulator = FMath::Fmod(WatchAccumulator, Interval);
 
-    const UThermoForgeFieldAsset* Field = Vol->BakedField;
-    const FIntVector D = Field->Dim;
-    if (D.X <= 0 || D.Y <= 0 || D.Z <= 0) return false;
+    Watches.RemoveAllSwap([](const TWeakObjectPtr<UThermoForgeWatchComponent>& W) { return !W.IsValid(); });
+    SET_DWORD_STAT(STAT_ThermoForge_Watches, Watches.Num());
 
-    const float Cell = Field->CellSizeCm;
-    if (Cell <= 0.f) return false;
+    TSharedPtr<FWatchPass, ESPMode::ThreadSafe> Pass = MakeShared<FWatchPass, ESPMode::ThreadSafe>();
+    for (const TWeakObjectPtr<UThermoForgeWatchComponent>& W : Watches)
+    {
+        const UThermoForgeWatchComponent* Watch = W.Get();
+        if (!Watch->bWatchEnabled) continue;
+        Pass->Watches.Add(W);
+        Pass->Points.Add(Watch->GetWatchLocation());
+    }
+    if (Pass->Points.IsEmpty()) return;
 
-    // Use the asset's oriented frame (origin + rotation at bake time)
-    const FTransform Frame = Field->GetGridFrame();
-    const FTransform InvFrame = Frame.Inverse();
+    // The published snapshot if there is one, else a private one for this pass
+    TSharedPtr<const FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> Snapshot = AcquireSnapshot();
+    if (!Snapshot.IsValid())
+        Snapshot = BuildSnapshot();
 
-    // Map world → grid-local (in cell units)
-    const FVector LocalGrid = InvFrame.TransformPosition(WorldLocation) / Cell;
+    PendingWatchPass = Pass;
+    PendingWatchTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Pass, Snapshot]()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::EvaluateWatches);
+        Pass->TempC.SetNumUninitialized(Pass->Points.Num());
 
-    // Nearest cell indices in grid space
-    const int32 ix = FMath::Clamp(FMath::FloorToInt(LocalGrid.X + 0.5f), 0, D.X - 1);
-    const int32 iy = FMath::Clamp(FMath::FloorToInt(LocalGrid.Y + 0.5f), 0, D.Y - 1);
-    const int32 iz = FMath::Clamp(FMath::FloorToInt(LocalGrid.Z + 0.5f), 0, D.Z - 1);
+        TArray<FThermoForgeTraceContext> Contexts;
+        ParallelForWithTaskContext(Contexts, Pass->Points.Num(),
+            [&Snapshot](int32, int32) { return Snapshot->MakeTraceContext(); },
+            [&Pass, &Snapshot](FThermoForgeTraceContext& Ctx, int32 i)
+            {
+                Pass->TempC[i] = Snapshot->ComputeTemperatureAt(Pass->Points[i], &Ctx);
+            });
 
-    const int32 Nx = D.X, Ny = D.Y;
-    const int32 Linear = ix + iy * Nx + iz * Nx * Ny;
+        for (const FThermoForgeTraceContext& Ctx : Contexts)
+            Ctx.EmitStats();
+    });
+}
 
-    // Reconstruct WORLD cell center via the same frame
-    const FVector CellCenterWS = Frame.TransformPosition(
-        FVector((ix + 0.5f) * Cell, (iy + 0.5f) * Cell, (iz + 0.5f) * Cell));
+TSharedPtr<const FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> UThermoForgeSubsystem::GetFieldSnapshot(const UThermoForgeFieldAsset* Field,
+    TMap<FObjectKey, FCachedFieldSnapshot>& InUse)
+{
+    if (!Field) return nullptr;
 
-    const double DistSq = FVector::DistSquared(CellCenterWS, WorldLocation);
+    const FObjectKey Key(Field);
+    if (const FCachedFieldSnapshot* Used = InUse.Find(Key))
+        return Used->Snapshot;
 
-    OutHit.bFound       = true;
-    OutHit.Volume       = const_cast<AThermoForgeVolume*>(Vol);
-    OutHit.GridIndex    = FIntVector(ix, iy, iz);
-    OutHit.LinearIndex  = Linear;
-    OutHit.CellCenterWS = CellCenterWS;
-    OutHit.DistanceSq   = DistSq;
-    OutHit.CellSizeCm   = Cell;
-    return true;
+    const FCachedFieldSnapshot* Cached = FieldSnapshots.Find(Key);
+    if (Cached && Cached->Revision == Field->GetDataRevision())
+        return InUse.Add(Key, *Cached).Snapshot;
+
+    // (Re)build the channel copy; fields with mismatched channel sizes are left out of the snapshot
+    const FIntVector D = Field->Dim;
+    const int32 N = (D.X > 0 && D.Y > 0 && D.Z > 0) ? D.X * D.Y * D.Z : 0;
+    FCachedFieldSnapshot& Entry = InUse.Add(Key);
+    Entry.Revision = Field->GetDataRevision();
+    if (N == 0 || Field->CellSizeCm <= 0.f || Field->SkyView01.Num() != N || Field->WallPermeability01.Num() != N)
+        return nullptr;
+
+    TSharedRef<FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> Copy = MakeShared<FThermoForgeFieldSnapshot, ESPMode::ThreadSafe>();
+    Copy->Dim                = D;
+    Copy->CellSizeCm         = Field->CellSizeCm;
+    Copy->Frame              = Field->GetGridFrame();
+    Copy->InvFrame           = Copy->Frame.Inverse();
+    Copy->SkyView01          = Field->SkyView01;
+    Copy->WallPermeability01 = Field->WallPermeability01;
+    if (Field->SunVisibilityL1.Num() == N)
+        Copy->SunVisibilityL1 = Field->SunVisibilityL1;
+    if (Field->ClimateBlend.Num() == N)
+    {
+        Copy->ClimateBlend = Field->ClimateBlend;
+        Field->ResolveClimatePalette(GetSettings(), Copy->ClimatePalette);
+    }
+    Entry.Snapshot = Copy;
+    return Entry.Snapshot;
 }
 
+void UThermoForgeSubsystem::SyncComposedChannels()
+{
+    UWorld* W = GetWorld();
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!W || !S) return;
+
+    const int32 BrickSize = FMath::Clamp(S->CompositionBrickSize, 2, 32);
 
+    // Drop channels whose volume, field or layout changed (a rebake reuses the same asset)
+    ComposedChannels.RemoveAll([BrickSize](const FThermoForgeComposedChannel& Ch)
+    {
+        const AThermoForgeVolume* V = Ch.Volume.Get();
+        const UThermoForgeFieldAsset* F = Ch.Field.Get();
+        return !V || !F || V->BakedField != F || F->Dim != Ch.Dim || Ch.BrickSize != BrickSize;
+    });
 
-FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPoint(const FVector& WorldLocation, const FDateTime& QueryTimeUTC) const
+    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    {
+        const AThermoForgeVolume* V = *It;
+        const UThermoForgeFieldAsset* F = V ? V->BakedField : nullptr;
+        if (!F || F->Dim.X <= 0 || F->Dim.Y <= 0 || F->Dim.Z <= 0) continue;
+
+        const bool bKnown = ComposedChannels.ContainsByPredicate(
+            [V](const FThermoForgeComposedChannel& Ch){ return Ch.Volume.Get() == V; });
+        if (bKnown) continue;
+
+        FThermoForgeComposedChannel& Ch = ComposedChannels.AddDefaulted_GetRef();
+        Ch.Volume    = V;
+        Ch.Field     = F;
+        Ch.Dim       = F->Dim;
+        Ch.BrickSize = BrickSize;
+        Ch.BrickDim  = FIntVector(
+            FMath::DivideAndRoundUp(F->Dim.X, BrickSize),
+            FMath::DivideAndRoundUp(F->Dim.Y, BrickSize),
+            FMath::DivideAndRoundUp(F->Dim.Z, BrickSize));
+        Ch.TempC.SetNumZeroed(F->Dim.X * F->Dim.Y * F->Dim.Z);
+        Ch.BrickRefreshedAt.Init(-1.0, Ch.BrickDim.X * Ch.BrickDim.Y * Ch.BrickDim.Z);
+    }
+}
+
+void UThermoForgeSubsystem::ScheduleComposition()
 {
-    FThermoForgeGridHit Best;
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ScheduleComposition);
+    UWorld* W = GetWorld();
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!W || !S || ComposedChannels.IsEmpty()) return;
 
-    UWorld* World = GetWorld();
-    if (!World) return Best;
+    // Scheduling runs on the game thread and is charged to the same budget as the job
+    const double ScheduleStart = FPlatformTime::Seconds();
+    const double Now = W->GetTimeSeconds();
 
-    bool FoundInContaining = false;
+    // Player viewpoints drive proximity priority
+    TArray<FVector, TInlineAllocator<4>> Viewpoints;
+    for (FConstPlayerControllerIterator It = W->GetPlayerControllerIterator(); It; ++It)
+    {
+        if (const APlayerController* PC = It->Get())
+        {
+            FVector L; FRotator R;
+            PC->GetPlayerViewPoint(L, R);
+            Viewpoints.Add(L);
+        }
+    }
 
-    for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+    TArray<FThermoForgeSourceState> Sources;
+    GatherSourceStates(Sources);
+
+    TArray<FBox> SourceBounds;
+    SourceBounds.Reserve(Sources.Num());
+    for (const FThermoForgeSourceState& Src : Sources)
+        if (Src.IntensityCelsius != 0.f)
+            SourceBounds.Add(Src.GetBoundsWS());
+
+    // Active sources per brick, indexed from each source's footprint instead of testing every brick against every source
+    TArray<TArray<uint16>> ActivePerBrick;
+    ActivePerBrick.SetNum(ComposedChannels.Num());
+    for (int32 c = 0; c < ComposedChannels.Num(); ++c)
     {
-        const AThermoForgeVolume* Vol = *It;
-        if (!Vol || !Vol->BakedField) continue;
+        const FThermoForgeComposedChannel& Ch = ComposedChannels[c];
+        const UThermoForgeFieldAsset* F = Ch.Field.Get();
+        if (!F || SourceBounds.IsEmpty()) continue;
 
-        if (!VolumeContainsPoint(Vol, WorldLocation))
-            continue;
+        TArray<uint16>& Active = ActivePerBrick[c];
+        Active.SetNumZeroed(Ch.BrickDim.X * Ch.BrickDim.Y * Ch.BrickDim.Z);
 
-        FThermoForgeGridHit Hit;
-        if (ComputeNearestInVolume(Vol, WorldLocation, Hit))
+        const FTransform Frame = F->GetGridFrame();
+        const double BrickCm = Ch.BrickSize * F->CellSizeCm;
+        for (const FBox& SB : SourceBounds)
         {
-            Hit.QueryTimeUTC = QueryTimeUTC;
-            if (!FoundInContaining || Hit.DistanceSq < Best.DistanceSq)
+            const FBox LS = SB.InverseTransformBy(Frame);
+            const FIntVector Lo(
+                FMath::Max(0, FMath::FloorToInt(LS.Min.X / BrickCm)),
+                FMath::Max(0, FMath::FloorToInt(LS.Min.Y / BrickCm)),
+                FMath::Max(0, FMath::FloorToInt(LS.Min.Z / BrickCm)));
+            const FIntVector Hi(
+                FMath::Min(Ch.BrickDim.X - 1, FMath::FloorToInt(LS.Max.X / BrickCm)),
+                FMath::Min(Ch.BrickDim.Y - 1, FMath::FloorToInt(LS.Max.Y / BrickCm)),
+                FMath::Min(Ch.BrickDim.Z - 1, FMath::FloorToInt(LS.Max.Z / BrickCm)));
+
+            for (int32 bz = Lo.Z; bz <= Hi.Z; ++bz)
+            for (int32 by = Lo.Y; by <= Hi.Y; ++by)
+            for (int32 bx = Lo.X; bx <= Hi.X; ++bx)
             {
-                Best = Hit;
-                FoundInContaining = true;
+                uint16& Count = Active[Ch.BrickIndex(bx, by, bz)];
+                Count = uint16(FMath::Min<int32>(Count + 1, MAX_uint16));
             }
         }
     }
 
-    if (!FoundInContaining)
+    // Only the top CompositionBricksPerTick survive: a bounded min-heap keeps them without sorting every brick
+    struct FCandidate { int32 Channel; int32 Brick; FIntVector Coord; double Priority; };
+    const int32 MaxBricks = FMath::Max(1, S->CompositionBricksPerTick);
+    auto LowestFirst = [](const FCandidate& A, const FCandidate& B) { return A.Priority < B.Priority; };
+    TArray<FCandidate> Candidates;
+    Candidates.Reserve(MaxBricks);
+
+    const double ProxFalloff = FMath::Max(1.f, S->CompositionProximityFalloffCm);
+
+    for (int32 c = 0; c < ComposedChannels.Num(); ++c)
     {
-        for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+        const FThermoForgeComposedChannel& Ch = ComposedChannels[c];
+        const UThermoForgeFieldAsset* F = Ch.Field.Get();
+        if (!F) continue;
+
+        const FTransform Frame = F->GetGridFrame();
+        const float Cell = F->CellSizeCm;
+
+        for (int32 bz = 0; bz < Ch.BrickDim.Z; ++bz)
+        for (int32 by = 0; by < Ch.BrickDim.Y; ++by)
+        for (int32 bx = 0; bx < Ch.BrickDim.X; ++bx)
         {
-            const AThermoForgeVolume* Vol = *It;
-            if (!Vol || !Vol->BakedField) continue;
+            const int32 bi = Ch.BrickIndex(bx, by, bz);
 
-            FThermoForgeGridHit Hit;
-            if (ComputeNearestInVolume(Vol, WorldLocation, Hit))
+            // Never-composed bricks go first, then the stalest
+            const double Last = Ch.BrickRefreshedAt[bi];
+            const double Age  = (Last < 0.0) ? 1e6 : FMath::Max(0.0, Now - Last);
+
+            const FVector MinLS(bx * Ch.BrickSize * Cell, by * Ch.BrickSize * Cell, bz * Ch.BrickSize * Cell);
+            const FVector MaxLS(
+                FMath::Min((bx + 1) * Ch.BrickSize, Ch.Dim.X) * Cell,
+                FMath::Min((by + 1) * Ch.BrickSize, Ch.Dim.Y) * Cell,
+                FMath::Min((bz + 1) * Ch.BrickSize, Ch.Dim.Z) * Cell);
+            const FBox BoxWS = FBox(MinLS, MaxLS).TransformBy(Frame);
+
+            double Proximity = 1.0;
+            if (Viewpoints.Num() > 0)
             {
-                Hit.QueryTimeUTC = QueryTimeUTC;
-                if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
-                {
-                    Best = Hit;
-                }
+                double MinDistSq = TNumericLimits<double>::Max();
+                for (const FVector& V : Viewpoints)
+                    MinDistSq = FMath::Min(MinDistSq, BoxWS.ComputeSquaredDistanceToPoint(V));
+                Proximity = 1.0 / (1.0 + FMath::Sqrt(MinDistSq) / ProxFalloff);
+            }
+
+            const int32  Active   = ActivePerBrick[c].IsEmpty() ? 0 : ActivePerBrick[c][bi];
+            const double Activity = 1.0 + S->CompositionSourceActivityWeight * Active;
+            const FCandidate Cand{ c, bi, FIntVector(bx, by, bz), (Age + 1e-3) * Proximity * Activity };
+            if (Candidates.Num() < MaxBricks)
+            {
+                Candidates.HeapPush(Cand, LowestFirst);
+            }
+            else if (Cand.Priority > Candidates.HeapTop().Priority)
+            {
+                Candidates.HeapPopDiscard(LowestFirst, EAllowShrinking::No);
+                Candidates.HeapPush(Cand, LowestFirst);
             }
         }
     }
 
-   // Fill composed temperature (derived from QueryTimeUTC) with post-process ambient fix
-if (Best.bFound)
-{
-    const UThermoForgeProjectSettings* S = GetSettings();
+    if (Candidates.IsEmpty()) return;
 
-    // Weather alpha: keep using the preview knob unless you have a live feed
-    const float WeatherAlfa = S ? S->PreviewWeatherAlpha : 0.3f;
+    // Highest priority first, so the budget cut drops the least urgent bricks
+    Candidates.Sort([](const FCandidate& A, const FCandidate& B){ return A.Priority > B.Priority; });
 
-    // --- Time of day from UTC (continuous hours) ---
-    const double SecUTC   = Best.QueryTimeUTC.GetTimeOfDay().GetTotalSeconds();
-    auto Wrap24 = [](float h){ float r = FMath::Fmod(h, 24.f); return (r < 0.f) ? r + 24.f : r; };
-    const float TimeHours = ([](float h){ float r = FMath::Fmod(h, 24.f); return (r < 0.f) ? r + 24.f : r; })
-                            (static_cast<float>(SecUTC / 3600.0f));
+    TSharedPtr<FThermoForgeCompositionJob, ESPMode::ThreadSafe> Job = MakeShared<FThermoForgeCompositionJob, ESPMode::ThreadSafe>();
+    Job->Climate        = ClockTerms;
+    Job->DefaultClimate = FThermoForgeClimate::FromSettings(S);
+    Job->Weather        = WeatherField;
+    if (!Sources.IsEmpty() && !S->bDeterministicComposition)
+        Job->Trace = MakeTraceContext();
+    Job->WeatherAlpha01 = S->DefaultWeatherAlpha01;
+    Job->WorldTime      = Now;
+    Job->BudgetSeconds  = S->CompositionBudgetMs / 1000.0;
+    Job->Sources        = MoveTemp(Sources);
 
-    // --- Smooth seasonal alpha (0 = deep winter, 1 = peak summer), Northern Hemisphere ---
-    // Dec 21 (~355) -> 0, Jun 21 (~172) -> 1, smooth cosine over the year
-    auto Wrap01 = [](float x){ return x - FMath::FloorToFloat(x); };
-    const int32 DOY           = Best.QueryTimeUTC.GetDayOfYear();      // 1..365/366
-    const float YearPos       = Wrap01((float(DOY) - 355.0f) / 365.0f); // 0..1 starting at Dec 21
-    const float SeasonAlpha01 = 0.5f * (1.0f - FMath::Cos(2.0f * PI * YearPos)); // 0→1→0 yearly
+    // Climate palettes resolved once per channel, not per brick
+    TArray<TArray<FThermoForgeClimate>> Palettes;
+    TBitArray<> PaletteResolved(false, ComposedChannels.Num());
+    Palettes.SetNum(ComposedChannels.Num());
 
-    // --- Compute BASELINE using the SAME season (blend winter/summer) to avoid steps ---
-    // We re-use your existing composition path for both seasons and blend:
-    const float BaseWinter = ComputeCurrentTemperatureAt(Best.CellCenterWS, /*bWinter=*/true , TimeHours, WeatherAlfa);
-    const float BaseSummer = ComputeCurrentTemperatureAt(Best.CellCenterWS, /*bWinter=*/false, TimeHours, WeatherAlfa);
-    const float BaselineTotalC = FMath::Lerp(BaseWinter, BaseSummer, SeasonAlpha01);
+    for (const FCandidate& Cand : Candidates)
+    {
+        const FThermoForgeComposedChannel& Ch = ComposedChannels[Cand.Channel];
+        const UThermoForgeFieldAsset* F = Ch.Field.Get();
+        const FTransform Frame = F->GetGridFrame();
+        const float Cell = F->CellSizeCm;
 
-    // Extract the ambient part used by baseline (also blended), so we can phase-correct it:
-    const float AmbWinter = S ? S->GetAmbientCelsiusAt(/*bWinter=*/true , TimeHours, Best.CellCenterWS.Z) : 0.0f;
-    const float AmbSummer = S ? S->GetAmbientCelsiusAt(/*bWinter=*/false, TimeHours, Best.CellCenterWS.Z) : 0.0f;
-    const float BaselineAmbientC = FMath::Lerp(AmbWinter, AmbSummer, SeasonAlpha01);
+        FThermoForgeCompositionJob::FBrick& B = Job->Bricks.AddDefaulted_GetRef();
+        B.Channel = Cand.Channel;
+        B.Brick   = Cand.Brick;
 
-    // --- Desired ambient with new phase: coldest at 00:00, hottest at 12:00 (also seasonal blend) ---
-    const float WinterAvg   = S ? S->WinterAverageC       : 5.0f;
-    const float SummerAvg   = S ? S->SummerAverageC       : 28.0f;
-    const float WinterDelta = S ? S->WinterDayNightDeltaC : 8.0f;
-    const float SummerDelta = S ? S->SummerDayNightDeltaC : 10.0f;
+        const int32 x0 = Cand.Coord.X * Ch.BrickSize, x1 = FMath::Min(x0 + Ch.BrickSize, Ch.Dim.X);
+        const int32 y0 = Cand.Coord.Y * Ch.BrickSize, y1 = FMath::Min(y0 + Ch.BrickSize, Ch.Dim.Y);
+        const int32 z0 = Cand.Coord.Z * Ch.BrickSize, z1 = FMath::Min(z0 + Ch.BrickSize, Ch.Dim.Z);
+        const int32 Count = (x1 - x0) * (y1 - y0) * (z1 - z0);
 
-    const float AvgC   = FMath::Lerp(WinterAvg,   SummerAvg,   SeasonAlpha01);
-    const float DeltaC = FMath::Lerp(WinterDelta, SummerDelta, SeasonAlpha01);
+        B.Cells.Reserve(Count); B.Centers.Reserve(Count);
+        B.Sky.Reserve(Count);   B.Wall.Reserve(Count);
 
-    // 00:00 trough, 12:00 peak
-    const float Phase   = (TimeHours - 12.0f) / 24.0f;
-    const float CosWave = FMath::Cos(2.0f * PI * Phase);
-    const float DesiredAmbientSeaC = AvgC + 0.5f * DeltaC * CosWave;
+        TArray<FThermoForgeClimate>& Palette = Palettes[Cand.Channel];
+        if (F->HasClimateOverrides())
+        {
+            if (!PaletteResolved[Cand.Channel])
+            {
+                F->ResolveClimatePalette(S, Palette);
+                PaletteResolved[Cand.Channel] = true;
+            }
+            B.Climate.Reserve(Count);
+        }
 
-    // Altitude adjustment
-    const float DesiredAmbientC = S ? S->AdjustForAltitude(DesiredAmbientSeaC, Best.CellCenterWS.Z)
-                                    : DesiredAmbientSeaC;
+        for (int32 z = z0; z < z1; ++z)
+        for (int32 y = y0; y < y1; ++y)
+        for (int32 x = x0; x < x1; ++x)
+        {
+            const int32 idx = F->Index(x, y, z);
+            B.Cells.Add(idx);
+            B.Centers.Add(Frame.TransformPosition(FVector((x + 0.5f) * Cell, (y + 0.5f) * Cell, (z + 0.5f) * Cell)));
+            B.Sky.Add (F->GetSolarExposureByLinearIdx(idx, Job->Climate.SunDirection));
+            B.Wall.Add(FMath::Clamp(F->GetWallPermByLinearIdx(idx), 0.f, 1.f));
+            if (Palette.Num() > 0)
+                B.Climate.Add(F->ClimateBlend.IsValidIndex(idx) ? FThermoForgeClimate::UnpackBlend(F->ClimateBlend[idx], Palette) : Job->DefaultClimate);
+        }
+    }
 
-    // --- Apply phase correction without jumps ---
-    const float AmbientDelta = DesiredAmbientC - BaselineAmbientC;
-    Best.CurrentTempC = BaselineTotalC + AmbientDelta;
+    // What scheduling spent comes off the job's budget (the job still finishes its top brick)
+    Job->BudgetSeconds = FMath::Max(0.0, Job->BudgetSeconds - (FPlatformTime::Seconds() - ScheduleStart));
 
+    PendingComposition = Job;
+    PendingCompositionTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Job]()
+    {
+        RunCompositionJob(this, *Job);
+    });
 }
 
+void UThermoForgeSubsystem::RunCompositionJob(const UThermoForgeSubsystem* Self, FThermoForgeCompositionJob& Job)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Composition);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::RunCompositionJob);
+    const double Start = FPlatformTime::Seconds();
+    const UThermoForgeProjectSettings* S = Self->GetSettings();
+    FThermoForgeTraceContext* Trace = Job.Trace.IsValid() ? &Job.Trace : nullptr;
 
-    return Best;
-}
+    for (int32 b = 0; b < Job.Bricks.Num(); ++b)
+    {
+        // Always finish the top brick so the channel makes progress under any budget
+        if (b > 0 && FPlatformTime::Seconds() - Start > Job.BudgetSeconds) break;
 
-FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPointNow(const FVector& WorldLocation) const
-{
-    return QueryNearestBakedGridPoint(WorldLocation, FDateTime::UtcNow());
+        FThermoForgeCompositionJob::FBrick& B = Job.Bricks[b];
+        B.OutTempC.SetNumUninitialized(B.Cells.Num());
+
+        for (int32 i = 0; i < B.Cells.Num(); ++i)
+        {
+            const FVector& P = B.Centers[i];
+            const FThermoForgeClimate& C = B.Climate.IsEmpty() ? Job.DefaultClimate : B.Climate[i];
+            float AmbientC = Job.Climate.AmbientAt(C, P.Z);
+            float WeatherAlpha01 = Job.WeatherAlpha01;
+            if (Job.Weather.IsValid())
+            {
+                const FThermoForgeWeatherSample W = Job.Weather->Sample(P);
+                AmbientC      += W.GetAmbientOffsetC(S->PrecipitationCoolingC);
+                WeatherAlpha01 = W.GetWeatherAlpha01();
+            }
+            B.OutTempC[i] = ComposeTemperature(S, Trace, P, B.Sky[i], B.Wall[i], AmbientC, WeatherAlpha01, Job.Sources, &C);
+        }
+        B.bDone = true;
+    }
+
+    if (Trace) Trace->EmitStats();
 }
 
-// --------- Runtime composition ---------
-float UThermoForgeSubsystem::ComputeCurrentTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const
+void UThermoForgeSubsystem::ApplyCompletedComposition()
 {
-    const UThermoForgeProjectSettings* S = GetSettings();
-    if (!S) return 0.f;
-
-    // Find nearest baked field and read both scalars
-    float Sky = 0.f;
-    float WallPerm = 1.f;
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::ApplyCompletedComposition);
+    if (!PendingComposition.IsValid() || !PendingCompositionTask.IsCompleted()) return;
 
+    const FThermoForgeCompositionJob& Job = *PendingComposition;
+    for (const FThermoForgeCompositionJob::FBrick& B : Job.Bricks)
     {
-        UWorld* World = GetWorld();
-        FThermoForgeGridHit Best;
-        if (World)
-        {
-            for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
-            {
-                const AThermoForgeVolume* Vol = *It;
-                if (!Vol || !Vol->BakedField) continue;
+        if (!B.bDone || !ComposedChannels.IsValidIndex(B.Channel)) continue;
 
-                FThermoForgeGridHit Hit;
-                if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) continue;
+        FThermoForgeComposedChannel& Ch = ComposedChannels[B.Channel];
+        if (!Ch.BrickRefreshedAt.IsValidIndex(B.Brick)) continue;
 
-                if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
-                    Best = Hit;
-            }
-        }
+        for (int32 i = 0; i < B.Cells.Num(); ++i)
+            if (Ch.TempC.IsValidIndex(B.Cells[i]))
+                Ch.TempC[B.Cells[i]] = B.OutTempC[i];
 
-        if (Best.bFound && Best.Volume && Best.Volume->BakedField)
-        {
-            Sky      = FMath::Clamp(Best.Volume->BakedField->GetSkyViewByLinearIdx(Best.LinearIndex), 0.f, 1.f);
-            WallPerm = FMath::Clamp(Best.Volume->BakedField->GetWallPermByLinearIdx(Best.LinearIndex), 0.f, 1.f);
-        }
+        Ch.BrickRefreshedAt[B.Brick] = Job.WorldTime;
     }
 
-    // Ambient + altitude
-    float AmbientC = S->GetAmbientCelsiusAt(bWinter, TimeHours, WorldPos.Z);
+    PendingComposition.Reset();
+    PendingCompositionTask = UE::Tasks::FTask();
+}
 
-    // Solar gain (reduced by weather)
-    const float Solar = S->SolarGainScaleC * Sky * (1.f - FMath::Clamp(WeatherAlpha01, 0.f, 1.f));
+bool UThermoForgeSubsystem::ReadComposedCell(const FVector& WorldPos, FThermoForgeGridHit& OutHit) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S || !S->bEnableTimeSlicedComposition) return false;
 
-    // Dynamic sources (attenuated by LOS * local wall permeability)
-    float SourceSum = 0.f;
+    const FThermoForgeComposedChannel* BestCh = nullptr;
+    for (const FThermoForgeComposedChannel& Ch : ComposedChannels)
     {
-        for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
-        {
-            const UThermoForgeSourceComponent* Sc = W.Get();
-            if (!Sc || !Sc->bEnabled) continue;
+        const AThermoForgeVolume* Vol = Ch.Volume.Get();
+        if (!Vol || Vol->BakedField != Ch.Field.Get() || !VolumeContainsPoint(Vol, WorldPos)) continue;
 
-            const float Intensity = Sc->SampleAt(WorldPos); // °C delta
-            if (Intensity == 0.f) continue;
+        FThermoForgeGridHit Hit;
+        if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) continue;
 
-            const float CellSize = S->DefaultCellSizeCm;
-            const float Occ = OcclusionBetween(WorldPos, Sc->GetOwnerLocationSafe(), CellSize);
-            // WallPerm scales local transmissivity
-            SourceSum += Intensity * Occ * WallPerm;
+        if (!BestCh || Hit.DistanceSq < OutHit.DistanceSq)
+        {
+            OutHit = Hit;
+            BestCh = &Ch;
         }
     }
+    if (!BestCh) return false;
 
-    return AmbientC + Solar + SourceSum;
+    const FIntVector& G = OutHit.GridIndex;
+    const int32 Brick = BestCh->BrickOfCell(G.X, G.Y, G.Z);
+    if (!BestCh->BrickRefreshedAt.IsValidIndex(Brick) || BestCh->BrickRefreshedAt[Brick] < 0.0) return false;
+    if (!BestCh->TempC.IsValidIndex(OutHit.LinearIndex)) return false;
+
+    OutHit.CurrentTempC = BestCh->TempC[OutHit.LinearIndex];
+    return true;
 }
 
 // ---- Save helpers ----
 #if WITH_EDITOR
-UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(AThermoForgeVolume* Volume,
+UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(const FString& PackageName,
     const FIntVector& Dim, float Cell, const FVector& FieldOriginWS, const FRotator& GridRotation,
-    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01) const
+    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01,
+    const TArray<FVector4f>& SunVisibilityL1, const TArray<uint32>& ClimateBlend, const TArray<TObjectPtr<UThermoForgeClimateProfile>>& ClimatePalette) const
 {
-    if (!Volume) return nullptr;
-
-    const FString VolName     = Volume->GetName();
-    const FString PackageName = FString::Printf(TEXT("/Game/ThermoForge/Bakes/%s_Field"), *VolName);
     const FString AssetName   = FPackageName::GetLongPackageAssetName(PackageName);
 
     UPackage* Pkg = CreatePackage(*PackageName);
@@ -569,6 +2848,10 @@ UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(AThermoFo
     Saved->SkyView01         = SkyView01;
     Saved->WallPermeability01= WallPerm01;
     Saved->Indoorness01      = Indoor01;
+    Saved->SunVisibilityL1   = SunVisibilityL1;
+    Saved->ClimateBlend      = ClimateBlend;
+    Saved->ClimatePalette    = ClimatePalette;
+    Saved->InvalidateDerivedData();
 
     Saved->MarkPackageDirty();
     Pkg->MarkPackageDirty();
@@ -584,7 +2867,7 @@ UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(AThermoFo
     SaveArgs.Error         = GWarn;
 
     const bool bOk = UPackage::SavePackage(Pkg, Saved, *Filename, SaveArgs);
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Asset %s : %s"),
+    UE_LOG(LogThermoForge, Log, TEXT("Asset %s : %s"),
            *Filename, bOk ? TEXT("Saved") : TEXT("FAILED"));
 
     if (!bOk) return nullptr;
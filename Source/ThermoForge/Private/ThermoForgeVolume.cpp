@@ -3,10 +3,14 @@
 #include "ThermoForgeFieldAsset.h"
 #include "ThermoForgeProjectSettings.h"
 #include "ThermoForgeSubsystem.h"
+#include "ThermoForgeStats.h"
 
 #include "Components/BoxComponent.h"
 #include "Engine/LevelBounds.h"
 #include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/VolumeTexture.h"
+#include "Async/ParallelFor.h"
 
 #if WITH_EDITOR
 #include "Components/InstancedStaticMeshComponent.h"
@@ -29,20 +33,10 @@ AThermoForgeVolume::AThermoForgeVolume()
     Bounds->SetMobility(EComponentMobility::Static);
 
 #if WITH_EDITORONLY_DATA
-    GridPreviewISM = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("GridPreviewISM"));
-    GridPreviewISM->SetupAttachment(RootComponent);
-    GridPreviewISM->SetIsVisualizationComponent(true);
-    GridPreviewISM->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-    GridPreviewISM->SetGenerateOverlapEvents(false);
-    GridPreviewISM->bHiddenInGame = true;
-    GridPreviewISM->SetMobility(EComponentMobility::Static);
-    GridPreviewISM->SetCastShadow(false);
-    GridPreviewISM->SetReceivesDecals(false);
-    GridPreviewISM->bSelectable = false;
+    GridPreviewISM  = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("GridPreviewISM"));
+    GridPreviewHISM = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("GridPreviewHISM"));
 
     static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube.Cube"));
-    if (CubeMesh.Succeeded())
-        GridPreviewISM->SetStaticMesh(CubeMesh.Object);
 
     if (!GridPreviewMaterial)
     {
@@ -51,8 +45,30 @@ AThermoForgeVolume::AThermoForgeVolume()
         if (TransMat.Succeeded())
             GridPreviewMaterial = TransMat.Object;
     }
-    if (GridPreviewMaterial)
-        GridPreviewISM->SetMaterial(0, GridPreviewMaterial);
+
+    for (UInstancedStaticMeshComponent* ISM : { static_cast<UInstancedStaticMeshComponent*>(GridPreviewISM), static_cast<UInstancedStaticMeshComponent*>(GridPreviewHISM) })
+    {
+        ISM->SetupAttachment(RootComponent);
+        ISM->SetIsVisualizationComponent(true);
+        ISM->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        ISM->SetGenerateOverlapEvents(false);
+        ISM->bHiddenInGame = true;
+        ISM->SetMobility(EComponentMobility::Static);
+        ISM->SetCastShadow(false);
+        ISM->SetReceivesDecals(false);
+        ISM->bSelectable = false;
+
+        if (CubeMesh.Succeeded())
+            ISM->SetStaticMesh(CubeMesh.Object);
+        if (GridPreviewMaterial)
+            ISM->SetMaterial(0, GridPreviewMaterial);
+    }
+    GridPreviewHISM->SetVisibility(false);
+
+    // Editor-only tick refreshes camera-dependent previews (culling radius / LOD)
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = true;
+    PrimaryActorTick.TickInterval = 0.25f;
 #endif
 
     Bounds->InitBoxExtent(BoxExtent);
@@ -60,6 +76,7 @@ AThermoForgeVolume::AThermoForgeVolume()
 void AThermoForgeVolume::BeginPlay()
 {
     Super::BeginPlay();
+    SetActorTickEnabled(false); // preview refresh is editor-only
 
     if (!BakedField)
     {
@@ -100,6 +117,23 @@ FBox AThermoForgeVolume::GetWorldBounds() const
     return FBox::BuildAABB(T.GetLocation(), BoxExtent);
 }
 
+float AThermoForgeVolume::GetClimateWeightAt(const FVector& WorldPos) const
+{
+    if (!ClimateProfile) return 0.f;
+    if (bUnbounded) return 1.f;
+
+    // Distance to the nearest side face in world cm (the actor scale stretches the box); top and bottom only on request
+    const FTransform T = GetActorTransform();
+    const FVector L = T.InverseTransformPosition(WorldPos);
+    const FVector Scale = T.GetScale3D().GetAbs();
+    const float InsideZ = (BoxExtent.Z - FMath::Abs(L.Z)) * Scale.Z;
+    float Inside = FMath::Min((BoxExtent.X - FMath::Abs(L.X)) * Scale.X,
+                              (BoxExtent.Y - FMath::Abs(L.Y)) * Scale.Y);
+    if (bClimateBlendVertical) Inside = FMath::Min(Inside, InsideZ);
+    if (Inside < 0.f || InsideZ < 0.f) return 0.f;
+    return ClimateBlendDistanceCm > KINDA_SMALL_NUMBER ? FMath::Min(1.f, Inside / ClimateBlendDistanceCm) : 1.f;
+}
+
 float AThermoForgeVolume::GetEffectiveCellSize() const
 {
 #if WITH_EDITORONLY_DATA
@@ -147,27 +181,53 @@ FTransform AThermoForgeVolume::GetGridFrame() const
     return FTransform(R, Origin, FVector::OneVector);
 }
 
+UInstancedStaticMeshComponent* AThermoForgeVolume::GetPreviewComponent() const
+{
+    if (bUseHierarchicalPreview && GridPreviewHISM) return GridPreviewHISM;
+    return GridPreviewISM;
+}
+
+void AThermoForgeVolume::SetPreviewVisibility(bool bVisible)
+{
+    UInstancedStaticMeshComponent* Active = GetPreviewComponent();
+    for (UInstancedStaticMeshComponent* ISM : { static_cast<UInstancedStaticMeshComponent*>(GridPreviewISM), static_cast<UInstancedStaticMeshComponent*>(GridPreviewHISM) })
+    {
+        if (!ISM) continue;
+        if (ISM == Active)
+        {
+            ISM->SetVisibility(bVisible, true);
+        }
+        else if (ISM->GetInstanceCount() > 0 || ISM->IsVisible())
+        {
+            ISM->ClearInstances();
+            ISM->SetVisibility(false, true);
+        }
+    }
+}
+
 void AThermoForgeVolume::ApplyBasePreviewMaterialIfNeeded()
 {
-    if (!GridPreviewISM) return;
+    UInstancedStaticMeshComponent* ISM = GetPreviewComponent();
+    if (!ISM) return;
     if (GridPreviewMaterial)
     {
-        UMaterialInterface* Current = GridPreviewISM->GetMaterial(0);
+        UMaterialInterface* Current = ISM->GetMaterial(0);
         if (Current != GridPreviewMaterial && !Cast<UMaterialInstanceDynamic>(Current))
-            GridPreviewISM->SetMaterial(0, GridPreviewMaterial);
+            ISM->SetMaterial(0, GridPreviewMaterial);
     }
 }
 
 void AThermoForgeVolume::ApplyHeatMaterialIfPossible()
 {
-    if (!GridPreviewISM) return;
+    UInstancedStaticMeshComponent* ISM = GetPreviewComponent();
+    if (!ISM) return;
 
-    UMaterialInterface* Parent = GridPreviewMaterial ? GridPreviewMaterial : GridPreviewISM->GetMaterial(0)->GetBaseMaterial();
+    UMaterialInterface* Parent = GridPreviewMaterial ? GridPreviewMaterial : ISM->GetMaterial(0)->GetBaseMaterial();
     if (!Parent) return;
 
-    HeatPreviewMID = GridPreviewISM->CreateDynamicMaterialInstance(0, Parent);
-    GridPreviewISM->SetMaterial(0, HeatPreviewMID);
-    GridPreviewISM->MarkRenderStateDirty();
+    HeatPreviewMID = ISM->CreateDynamicMaterialInstance(0, Parent);
+    ISM->SetMaterial(0, HeatPreviewMID);
+    ISM->MarkRenderStateDirty();
 }
 
 void AThermoForgeVolume::OnConstruction(const FTransform& Xform)
@@ -175,11 +235,10 @@ void AThermoForgeVolume::OnConstruction(const FTransform& Xform)
     Super::OnConstruction(Xform);
     Bounds->SetBoxExtent(BoxExtent);
 
-    if (GridPreviewISM) GridPreviewISM->SetVisibility(true, true);
+    SetPreviewVisibility(true);
 
     if (BakedField && BakedField->Dim.X>0 && BakedField->Dim.Y>0 && BakedField->Dim.Z>0)
     {
-        if (GridPreviewISM) GridPreviewISM->SetVisibility(true, true);
         BuildHeatPreviewFromField();
         return;
     }
@@ -189,6 +248,49 @@ void AThermoForgeVolume::OnConstruction(const FTransform& Xform)
         RebuildPreviewGrid();
 }
 
+bool AThermoForgeVolume::UsesVolumeTexturePreview() const
+{
+    return bUseVolumeTexturePreview && VolumeTexturePreviewMaterial != nullptr;
+}
+
+bool AThermoForgeVolume::UsesViewDependentPreview() const
+{
+    return !UsesVolumeTexturePreview() && (PreviewCulling == EThermoPreviewCulling::CameraRadius || bPreviewUseLOD);
+}
+
+bool AThermoForgeVolume::ShouldTickIfViewportsOnly() const
+{
+    return UsesViewDependentPreview();
+}
+
+FVector AThermoForgeVolume::GetPreviewViewLocation() const
+{
+    if (const UWorld* W = GetWorld())
+        if (W->ViewLocationsRenderedLastFrame.Num() > 0)
+            return W->ViewLocationsRenderedLastFrame[0];
+    return GetActorLocation();
+}
+
+void AThermoForgeVolume::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+#if WITH_EDITOR
+    const UWorld* W = GetWorld();
+    if (!W || W->IsGameWorld() || !BakedField || !UsesViewDependentPreview()) return;
+
+    const UInstancedStaticMeshComponent* ISM = GetPreviewComponent();
+    if (!ISM || !ISM->IsVisible()) return;
+
+    // Rebuild once the camera moved a meaningful fraction of the culling / LOD distance
+    const float Reach = (PreviewCulling == EThermoPreviewCulling::CameraRadius) ? PreviewCameraRadiusCm : PreviewLODDistanceCm;
+    const float RefreshDist = FMath::Max(100.f, 0.25f * Reach);
+    if (FVector::DistSquared(GetPreviewViewLocation(), LastPreviewViewLocation) < FMath::Square(RefreshDist)) return;
+
+    BuildHeatPreviewFromField();
+#endif
+}
+
 #if WITH_EDITOR
 void AThermoForgeVolume::PostEditChangeProperty(FPropertyChangedEvent& E)
 {
@@ -201,20 +303,31 @@ void AThermoForgeVolume::PostEditChangeProperty(FPropertyChangedEvent& E)
         Bounds->SetBoxExtent(BoxExtent);
 
     const bool bPreviewRelevant =
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUnbounded)          ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUseGlobalGrid)      ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridCellSize)        ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridCellGap)         ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridOriginMode)      ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridOriginWS)        ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, MaxPreviewInstances) ||
-        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridPreviewMaterial) ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUnbounded)              ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUseGlobalGrid)          ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridCellSize)            ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridCellGap)             ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridOriginMode)          ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridOriginWS)            ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, MaxPreviewInstances)     ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridPreviewMaterial)     ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewCulling)          ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewCameraRadiusCm)   ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewSliceAxis)        ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewSliceOffsetCm)    ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bPreviewUseLOD)          ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewLODDistanceCm)    ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewMaxLOD)           ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUseHierarchicalPreview) ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUseVolumeTexturePreview) ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, VolumeTexturePreviewMaterial) ||
+        N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, FieldTextureFormat)      ||
         N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, BakedField);
 
-    if (bPreviewRelevant && GridPreviewISM)
+    if (bPreviewRelevant && GetPreviewComponent())
     {
         const bool bShow = !bUnbounded;
-        GridPreviewISM->SetVisibility(bShow, true);
+        SetPreviewVisibility(bShow);
 
         if (BakedField && bShow)
             BuildHeatPreviewFromField();
@@ -231,11 +344,15 @@ void AThermoForgeVolume::PostEditChangeProperty(FPropertyChangedEvent& E)
 
 void AThermoForgeVolume::RebuildPreviewGrid()
 {
-    if (!GridPreviewISM || !GridPreviewISM->GetStaticMesh()) return;
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Preview);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::RebuildPreviewGrid);
+
+    UInstancedStaticMeshComponent* ISM = GetPreviewComponent();
+    if (!ISM || !ISM->GetStaticMesh()) return;
 
-    GridPreviewISM->ClearInstances();
-    GridPreviewISM->SetVisibility(true, true);
-    GridPreviewISM->NumCustomDataFloats = 1;
+    ISM->ClearInstances();
+    SetPreviewVisibility(true);
+    ISM->SetNumCustomDataFloats(1); // preview color slot, zero-initialized
 
     const float Cell = GetEffectiveCellSize();
     if (Cell <= KINDA_SMALL_NUMBER) return;
@@ -287,10 +404,10 @@ void AThermoForgeVolume::RebuildPreviewGrid()
                (L.Z >= Min.Z && L.Z <= Max.Z);
     };
 
-    int32 Count = 0;
-    for (int32 iz = iz0; iz <= iz1 && Count < MaxPreviewInstances; ++iz)
-    for (int32 iy = iy0; iy <= iy1 && Count < MaxPreviewInstances; ++iy)
-    for (int32 ix = ix0; ix <= ix1 && Count < MaxPreviewInstances; ++ix)
+    TArray<FTransform> Xfs;
+    for (int32 iz = iz0; iz <= iz1 && Xfs.Num() < MaxPreviewInstances; ++iz)
+    for (int32 iy = iy0; iy <= iy1 && Xfs.Num() < MaxPreviewInstances; ++iy)
+    for (int32 ix = ix0; ix <= ix1 && Xfs.Num() < MaxPreviewInstances; ++ix)
     {
         const FVector CenterLS( (ix + 0.5f) * Cell, (iy + 0.5f) * Cell, (iz + 0.5f) * Cell );
         const FVector CenterWS = Frame.TransformPosition(CenterLS);
@@ -298,106 +415,303 @@ void AThermoForgeVolume::RebuildPreviewGrid()
 
         Xf.SetLocation(CenterWS);
         Xf.SetRotation(Frame.GetRotation());
-
-        const int32 InstanceIndex = GridPreviewISM->AddInstance(Xf,true);
-        if (InstanceIndex >= 0)
-            GridPreviewISM->SetCustomDataValue(InstanceIndex, 0, 0.f, false); // preview color slot
-        ++Count;
+        Xfs.Add(Xf);
     }
 
-    GridPreviewISM->MarkRenderStateDirty();
+    ISM->AddInstances(Xfs, /*bShouldReturnIndices*/false, /*bWorldSpace*/true, /*bUpdateNavigation*/false);
+    ISM->MarkRenderStateDirty();
 }
 
 void AThermoForgeVolume::HidePreview()
 {
-    GridPreviewISM->SetVisibility(false, true);
+    SetPreviewVisibility(false);
 }
 
 
+/** One emitted preview cell: a base-cell range [Min, Max) at a mip level. */
+struct FThermoPreviewCell
+{
+    int32      Level = 0;
+    FIntVector Min   = FIntVector::ZeroValue;
+    FIntVector Max   = FIntVector::ZeroValue;
+};
+
+void AThermoForgeVolume::GatherHeatPreviewCells(const FVector& ViewLocation, TArray<FThermoPreviewCell>& OutCells) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::GatherHeatPreviewCells);
+
+    OutCells.Reset();
+
+    const FIntVector D = BakedField->Dim;
+    const float Cell = BakedField->CellSizeCm;
+    const int32 Cap  = FMath::Max(0, MaxPreviewInstances);
+
+    // Everything below runs in grid space (cm); the frame is rigid so distances are preserved
+    const FTransform InvFrame = BakedField->GetGridFrame().Inverse();
+    const FVector ViewGS  = InvFrame.TransformPosition(ViewLocation);
+    const int32   Axis    = static_cast<int32>(PreviewSliceAxis);
+    const double  SliceGS = InvFrame.TransformPosition(GetActorLocation())[Axis] + PreviewSliceOffsetCm;
+    const double  RadiusSq = FMath::Square(double(PreviewCameraRadiusCm));
+    const double  LODDist  = FMath::Max(1.f, PreviewLODDistanceCm);
+
+    const int32 TopLevel = bPreviewUseLOD ? FMath::Min(PreviewMaxLOD, BakedField->GetNumMips()) : 0;
+
+    auto Passes = [&](const FBox& BoxGS) -> bool
+    {
+        switch (PreviewCulling)
+        {
+            case EThermoPreviewCulling::CameraRadius: return BoxGS.ComputeSquaredDistanceToPoint(ViewGS) <= RadiusSq;
+            case EThermoPreviewCulling::SlicePlane:   return BoxGS.Min[Axis] <= SliceGS && SliceGS <= BoxGS.Max[Axis];
+            case EThermoPreviewCulling::AllCells:
+            default:                                  return true;
+        }
+    };
+
+    auto DesiredLevel = [&](const FBox& BoxGS) -> int32
+    {
+        const double Dist = FMath::Sqrt(BoxGS.ComputeSquaredDistanceToPoint(ViewGS));
+        if (Dist <= LODDist) return 0;
+        return FMath::Min(TopLevel, FMath::FloorToInt(FMath::Log2(Dist / LODDist)) + 1);
+    };
+
+    TFunction<void(int32, int32, int32, int32)> Visit = [&](int32 L, int32 cx, int32 cy, int32 cz)
+    {
+        if (OutCells.Num() >= Cap) return;
+
+        const FIntVector Min(cx << L, cy << L, cz << L);
+        const FIntVector Max(
+            FMath::Min((cx + 1) << L, D.X),
+            FMath::Min((cy + 1) << L, D.Y),
+            FMath::Min((cz + 1) << L, D.Z));
+        if (Min.X >= Max.X || Min.Y >= Max.Y || Min.Z >= Max.Z) return;
+
+        const FBox BoxGS(FVector(Min) * Cell, FVector(Max) * Cell);
+        if (!Passes(BoxGS)) return;
+
+        if (L > 0 && DesiredLevel(BoxGS) < L)
+        {
+            for (int32 dz = 0; dz < 2; ++dz)
+            for (int32 dy = 0; dy < 2; ++dy)
+            for (int32 dx = 0; dx < 2; ++dx)
+                Visit(L - 1, 2*cx + dx, 2*cy + dy, 2*cz + dz);
+            return;
+        }
+
+        OutCells.Add({ L, Min, Max });
+    };
+
+    const int32 Nx = FMath::DivideAndRoundUp(D.X, 1 << TopLevel);
+    const int32 Ny = FMath::DivideAndRoundUp(D.Y, 1 << TopLevel);
+    const int32 Nz = FMath::DivideAndRoundUp(D.Z, 1 << TopLevel);
+
+    for (int32 z = 0; z < Nz && OutCells.Num() < Cap; ++z)
+    for (int32 y = 0; y < Ny && OutCells.Num() < Cap; ++y)
+    for (int32 x = 0; x < Nx && OutCells.Num() < Cap; ++x)
+        Visit(TopLevel, x, y, z);
+}
+
 void AThermoForgeVolume::BuildHeatPreviewFromField()
 {
-    if (!GridPreviewISM) return;
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Preview);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::BuildHeatPreviewFromField);
+
+    UInstancedStaticMeshComponent* ISM = GetPreviewComponent();
+    if (!ISM) return;
     if (!BakedField || BakedField->Dim.X<=0 || BakedField->Dim.Y<=0 || BakedField->Dim.Z<=0) return;
 
-    if (!GridPreviewISM->GetStaticMesh())
+    if (!ISM->GetStaticMesh())
+    {
+        if (UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")))
+            ISM->SetStaticMesh(CubeMesh);
+    }
+
+    if (UsesVolumeTexturePreview())
     {
-        static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube.Cube"));
-        if (CubeMesh.Succeeded()) GridPreviewISM->SetStaticMesh(CubeMesh.Object);
+        BuildVolumeTexturePreview();
+        return;
+    }
+    if (bUseVolumeTexturePreview)
+    {
+        UE_LOG(LogThermoForge, Warning, TEXT("%s: volume-texture preview needs VolumeTexturePreviewMaterial; using the instanced preview"), *GetName());
     }
 
     ApplyHeatMaterialIfPossible();
 
-    GridPreviewISM->ClearInstances();
-    GridPreviewISM->NumCustomDataFloats = 1; // slot0 = normalized current temp
+    ISM->ClearInstances();
+    ISM->SetNumCustomDataFloats(1); // slot0 = normalized current temp
+
+    // Select cells (culling + LOD, capped by MaxPreviewInstances) before any temperature work
+    LastPreviewViewLocation = GetPreviewViewLocation();
+    TArray<FThermoPreviewCell> Cells;
+    GatherHeatPreviewCells(LastPreviewViewLocation, Cells);
+
+    const int32 Count = Cells.Num();
+    if (Count == 0)
+    {
+        ISM->MarkRenderStateDirty();
+        return;
+    }
 
-    const FIntVector D = BakedField->Dim;
-    const int32 Nx = D.X, Ny = D.Y, Nz = D.Z;
     const float Cell = BakedField->CellSizeCm;
+    const float Gap  = ClampVisualGap(Cell, GridCellGap);
 
     // Asset’s oriented frame at bake time
     const FTransform Frame = BakedField->GetGridFrame();
+    const FQuat      Rot   = Frame.GetRotation();
 
-    const float Gap        = ClampVisualGap(Cell, GridCellGap);
-    const float VisualEdge = FMath::Max(1.f, Cell - Gap);
-    const FVector Scale(VisualEdge / 100.f);
-    FTransform Xf(FQuat::Identity, FVector::ZeroVector, Scale);
+    // Make sure every level we touch exists before going parallel
+    for (const FThermoPreviewCell& C : Cells)
+        if (C.Level > 0) BakedField->GetMip(C.Level);
 
-    auto Index = [&](int32 x,int32 y,int32 z){ return (z*Ny + y)*Nx + x; };
+    TArray<FTransform> Xfs;   Xfs.SetNumUninitialized(Count);
+    TArray<FVector>    Points; Points.SetNumUninitialized(Count);
+    TArray<float>      Sky;    Sky.SetNumUninitialized(Count);
+    TArray<float>      Wall;   Wall.SetNumUninitialized(Count);
 
-    // Compose temps using subsystem preview knobs
-    float TMin = -100.f, TMax = 100.f; 
-    TArray<float> Temp; Temp.SetNumZeroed(Nx*Ny*Nz);
+    ParallelFor(Count, [&](int32 i)
+    {
+        const FThermoPreviewCell& C = Cells[i];
+
+        const FVector CenterLS = FVector(C.Min + C.Max) * (0.5f * Cell);
+        const FVector Extent   = FVector(C.Max - C.Min) * Cell;
+        const FVector Scale(
+            FMath::Max(1.f, Extent.X - Gap) / 100.f,
+            FMath::Max(1.f, Extent.Y - Gap) / 100.f,
+            FMath::Max(1.f, Extent.Z - Gap) / 100.f);
+
+        Points[i] = Frame.TransformPosition(CenterLS);
+        Xfs[i]    = FTransform(Rot, Points[i], Scale);
+
+        if (C.Level == 0)
+        {
+            const int32 Idx = BakedField->Index(C.Min.X, C.Min.Y, C.Min.Z);
+            Sky[i]  = BakedField->GetSkyViewByLinearIdx(Idx);
+            Wall[i] = BakedField->GetWallPermByLinearIdx(Idx);
+        }
+        else
+        {
+            const FThermoForgeFieldMip* Mip = BakedField->GetMip(C.Level);
+            const int32 Idx = Mip->Index(C.Min.X >> C.Level, C.Min.Y >> C.Level, C.Min.Z >> C.Level);
+            Sky[i]  = Mip->SkyView01[Idx];
+            Wall[i] = Mip->WallPermeability01[Idx];
+        }
+    });
+
+    // Compose temps using subsystem preview knobs (batched, parallel)
+    const float TMin = -100.f, TMax = 100.f;
+    TArray<float> Temp;
 
     const UThermoForgeProjectSettings* Settings = GetDefault<UThermoForgeProjectSettings>();
     const bool  bWinter     = Settings ? Settings->PreviewSeasonIsWinter : false;
     const float TimeHours   = Settings ? Settings->PreviewTimeOfDayHours : 15.f;
     const float WeatherAlfa = Settings ? Settings->PreviewWeatherAlpha   : 0.3f;
 
-    UThermoForgeSubsystem* Sub = GetWorld() ? GetWorld()->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (UThermoForgeSubsystem* Sub = GetWorld() ? GetWorld()->GetSubsystem<UThermoForgeSubsystem>() : nullptr)
+        Sub->ComputeTemperaturesAt(Points, Sky, Wall, bWinter, TimeHours, WeatherAlfa, Temp);
 
-    for (int32 z=0; z<Nz; ++z)
-    for (int32 y=0; y<Ny; ++y)
-    for (int32 x=0; x<Nx; ++x)
-    {
-        const int32 i = Index(x,y,z);
-        const FVector CenterLS((x+0.5f)*Cell, (y+0.5f)*Cell, (z+0.5f)*Cell);
-        const FVector CenterWS = Frame.TransformPosition(CenterLS); // <-- FIX
+    if (Temp.Num() != Count)
+        Temp.SetNumZeroed(Count);
 
-        const float T = (Sub)
-            ? Sub->ComputeCurrentTemperatureAt(CenterWS, bWinter, TimeHours, WeatherAlfa)
-            : 0.f;
+    ISM->AddInstances(Xfs, /*bShouldReturnIndices*/false, /*bWorldSpace*/true, /*bUpdateNavigation*/false);
 
-        Temp[i] = T;
+    const float Range = FMath::Max(1e-6f, TMax - TMin);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        const float Heat01 = FMath::Clamp((Temp[i] - TMin) / Range, 0.f, 1.f);
+        ISM->SetCustomData(i, MakeArrayView(&Heat01, 1), /*bMarkRenderStateDirty*/false);
     }
 
-    const float Range = FMath::Max(1e-6f, TMax - TMin);
+    ISM->MarkRenderStateDirty();
+}
 
-    int32 Count = 0;
-    for (int32 z=0; z<Nz; ++z)
-    for (int32 y=0; y<Ny; ++y)
-    for (int32 x=0; x<Nx; ++x)
-    {
-        if (Count >= MaxPreviewInstances) break;
+// ---- volume-texture preview ----
+static constexpr float TF_PreviewTMin = -100.f;
+static constexpr float TF_PreviewTMax =  100.f;
 
-        const int32 i = Index(x,y,z);
-        const float Heat01 = FMath::Clamp((Temp[i] - TMin) / Range, 0.f, 1.f);
+void AThermoForgeVolume::BuildFieldTextures()
+{
+    SCOPE_CYCLE_COUNTER(STAT_ThermoForge_Preview);
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::BuildFieldTextures);
 
-        // Place in the baked field’s rotated frame
-        const FVector CenterLS( (x + 0.5f)*Cell, (y + 0.5f)*Cell, (z + 0.5f)*Cell );
-        const FVector CenterWS = Frame.TransformPosition(CenterLS);
+    HeatVolumeTexture = nullptr;
+    if (!BakedField || BakedField->Dim.X<=0 || BakedField->Dim.Y<=0 || BakedField->Dim.Z<=0) return;
 
-        Xf.SetLocation(CenterWS);
-        Xf.SetRotation(Frame.GetRotation());
+    const FIntVector D = BakedField->Dim;
+    const int32 N = D.X * D.Y * D.Z;
+
+    const UThermoForgeProjectSettings* Settings = GetDefault<UThermoForgeProjectSettings>();
+    const bool  bWinter     = Settings ? Settings->PreviewSeasonIsWinter : false;
+    const float TimeHours   = Settings ? Settings->PreviewTimeOfDayHours : 15.f;
+    const float WeatherAlfa = Settings ? Settings->PreviewWeatherAlpha   : 0.3f;
 
-        const int32 InstanceIndex = GridPreviewISM->AddInstance(Xf,true);
-        if (InstanceIndex >= 0)
-            GridPreviewISM->SetCustomDataValue(InstanceIndex, 0, Heat01, false);
-            GridPreviewISM->SetCustomDataValue(InstanceIndex, 1, 0,     false);
+    TArray<float> Temp;
+    if (UThermoForgeSubsystem* Sub = GetWorld() ? GetWorld()->GetSubsystem<UThermoForgeSubsystem>() : nullptr)
+        Sub->ComputeFieldTemperatures(BakedField, N, bWinter, TimeHours, WeatherAlfa, Temp);
+    if (Temp.Num() != N)
+        Temp.SetNumZeroed(N);
 
-        ++Count;
+    const float Range = FMath::Max(1e-6f, TF_PreviewTMax - TF_PreviewTMin);
+    for (float& T : Temp)
+        T = FMath::Clamp((T - TF_PreviewTMin) / Range, 0.f, 1.f);
+
+    HeatVolumeTexture = UThermoForgeFieldAsset::CreateVolumeTexture01(Temp, D, FieldTextureFormat);
+}
+
+void AThermoForgeVolume::ApplyFieldTextureParameters(UMaterialInstanceDynamic* MID)
+{
+    if (!MID || !BakedField) return;
+
+    const FIntVector D = BakedField->Dim;
+    const float Cell = BakedField->CellSizeCm;
+    const FTransform Frame = BakedField->GetGridFrame();
+    const FVector Size = FVector(D) * Cell;
+
+    MID->SetTextureParameterValue(TEXT("TF_Heat"),     HeatVolumeTexture);
+    MID->SetScalarParameterValue (TEXT("TF_HasHeat"),  HeatVolumeTexture ? 1.f : 0.f);
+    MID->SetTextureParameterValue(TEXT("TF_SkyView"),  BakedField->GetChannelTexture(EThermoFieldChannel::SkyView,          FieldTextureFormat));
+    MID->SetTextureParameterValue(TEXT("TF_WallPerm"), BakedField->GetChannelTexture(EThermoFieldChannel::WallPermeability, FieldTextureFormat));
+    MID->SetTextureParameterValue(TEXT("TF_Indoor"),   BakedField->GetChannelTexture(EThermoFieldChannel::Indoorness,       FieldTextureFormat));
+
+    MID->SetVectorParameterValue(TEXT("TF_GridOrigin"), FLinearColor(Frame.GetLocation()));
+    MID->SetVectorParameterValue(TEXT("TF_GridAxisX"),  FLinearColor(Frame.GetUnitAxis(EAxis::X)));
+    MID->SetVectorParameterValue(TEXT("TF_GridAxisY"),  FLinearColor(Frame.GetUnitAxis(EAxis::Y)));
+    MID->SetVectorParameterValue(TEXT("TF_GridAxisZ"),  FLinearColor(Frame.GetUnitAxis(EAxis::Z)));
+    MID->SetVectorParameterValue(TEXT("TF_GridInvSize"), FLinearColor(
+        1.f / FMath::Max(1.0, Size.X), 1.f / FMath::Max(1.0, Size.Y), 1.f / FMath::Max(1.0, Size.Z), 0.f));
+    MID->SetVectorParameterValue(TEXT("TF_TempRange"), FLinearColor(TF_PreviewTMin, TF_PreviewTMax, 0.f, 0.f));
+
+    // Field-only composition terms at the preview knobs (project climate)
+    if (const UThermoForgeProjectSettings* S = GetDefault<UThermoForgeProjectSettings>())
+    {
+        const float AmbientSeaC = S->GetAmbientCelsius(S->PreviewSeasonIsWinter, S->PreviewTimeOfDayHours);
+        const float LapsePerCm  = (S->bEnableAltitudeLapse && S->LapseRateCPerKm > 0.f) ? -S->LapseRateCPerKm / 100000.f : 0.f;
+        const float SolarC      = S->SolarGainScaleC * (1.f - FMath::Clamp(S->PreviewWeatherAlpha, 0.f, 1.f));
+        MID->SetVectorParameterValue(TEXT("TF_Climate"), FLinearColor(AmbientSeaC, LapsePerCm, SolarC, S->SeaLevelZcm));
     }
+}
+
+void AThermoForgeVolume::BuildVolumeTexturePreview()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ThermoForge::BuildVolumeTexturePreview);
+
+    UInstancedStaticMeshComponent* ISM = GetPreviewComponent();
+    if (!ISM || !BakedField || !VolumeTexturePreviewMaterial) return;
+
+    // No CPU composition here: the material composes field-only heat from the channel textures and TF_Climate
+    HeatPreviewMID = ISM->CreateDynamicMaterialInstance(0, VolumeTexturePreviewMaterial);
+    ISM->SetMaterial(0, HeatPreviewMID);
+    ApplyFieldTextureParameters(HeatPreviewMID);
+
+    // A single box spanning the grid; the material does the per-texel work
+    ISM->ClearInstances();
+    ISM->SetNumCustomDataFloats(0);
+
+    const FTransform Frame = BakedField->GetGridFrame();
+    const FVector SizeLS = FVector(BakedField->Dim) * BakedField->CellSizeCm;
+    const FTransform Xf(Frame.GetRotation(), Frame.TransformPosition(0.5f * SizeLS), SizeLS / 100.f);
+    ISM->AddInstance(Xf, /*bWorldSpace*/true);
 
-    GridPreviewISM->MarkRenderStateDirty();
+    ISM->MarkRenderStateDirty();
 }
 
 void AThermoForgeVolume::SetVolumeParameters(
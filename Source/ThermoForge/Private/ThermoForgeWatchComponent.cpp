@@ -0,0 +1,64 @@
+﻿#include "ThermoForgeWatchComponent.h"
+
+#include "ThermoForgeSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+UThermoForgeWatchComponent::UThermoForgeWatchComponent()
+{
+    // Sampled by the subsystem's batched pass, never on its own
+    PrimaryComponentTick.bCanEverTick = false;
+}
+
+FVector UThermoForgeWatchComponent::GetWatchLocation() const
+{
+    if (const AActor* A = GetOwner()) return A->GetActorTransform().TransformPosition(LocationOffset);
+    return LocationOffset;
+}
+
+void UThermoForgeWatchComponent::ApplyTemperature(float TemperatureC)
+{
+    LastTemperatureC = TemperatureC;
+
+    EThermoWatchZone NewZone = Zone;
+    switch (Zone)
+    {
+        case EThermoWatchZone::Hot:
+            if (TemperatureC < HotThresholdC - HysteresisC) NewZone = EThermoWatchZone::Normal;
+            break;
+        case EThermoWatchZone::Cold:
+            if (TemperatureC > ColdThresholdC + HysteresisC) NewZone = EThermoWatchZone::Normal;
+            break;
+        default:
+            break;
+    }
+
+    // From Normal (or just released), the plain thresholds apply; a jump straight across both zones lands here too
+    if (NewZone == EThermoWatchZone::Normal)
+    {
+        if (TemperatureC >= HotThresholdC)       NewZone = EThermoWatchZone::Hot;
+        else if (TemperatureC <= ColdThresholdC) NewZone = EThermoWatchZone::Cold;
+    }
+
+    if (NewZone == Zone) return;
+
+    const EThermoWatchZone OldZone = Zone;
+    Zone = NewZone;
+    OnZoneChanged.Broadcast(NewZone, OldZone, TemperatureC);
+}
+
+void UThermoForgeWatchComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    if (UWorld* W = GetWorld())
+        if (auto* SS = W->GetSubsystem<UThermoForgeSubsystem>())
+            SS->RegisterWatch(this);
+}
+
+void UThermoForgeWatchComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UWorld* W = GetWorld())
+        if (auto* SS = W->GetSubsystem<UThermoForgeSubsystem>())
+            SS->UnregisterWatch(this);
+    Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,87 @@
+﻿#include "ThermoForgeWeatherActor.h"
+
+#include "ThermoForgeStats.h"
+#include "ThermoForgeSubsystem.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+
+AThermoForgeWeatherActor::AThermoForgeWeatherActor()
+{
+    // Stepped by the subsystem
+    PrimaryActorTick.bCanEverTick = false;
+    SetCanBeDamaged(false);
+
+    USceneComponent* Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+    SetRootComponent(Root);
+}
+
+void AThermoForgeWeatherActor::AddFront(const FThermoForgeWeatherFront& Front)
+{
+    PendingFronts.Add(Front);
+}
+
+FThermoForgeWeatherStamp AThermoForgeWeatherActor::ToStamp(const FThermoForgeWeatherFront& Front) const
+{
+    FThermoForgeWeatherStamp Stamp;
+    Stamp.CenterXY              = FVector2D(GetActorLocation()) + Front.OffsetCm;
+    Stamp.RadiusCm              = Front.RadiusCm;
+    Stamp.Value.CloudCover01    = Front.CloudCover01;
+    Stamp.Value.Precipitation01 = Front.Precipitation01;
+    return Stamp;
+}
+
+FThermoForgeWeatherField AThermoForgeWeatherActor::MakeInitialField() const
+{
+    FThermoForgeWeatherSample Background;
+    Background.CloudCover01    = FMath::Clamp(BackgroundCloudCover01,    0.f, 1.f);
+    Background.Precipitation01 = FMath::Clamp(BackgroundPrecipitation01, 0.f, 1.f);
+
+    const FVector2D Size = FVector2D(Resolution) * CellSizeCm;
+    FThermoForgeWeatherField Field;
+    Field.Init(FVector2D(GetActorLocation()) - 0.5 * Size, Resolution, CellSizeCm, Background);
+
+    for (const FThermoForgeWeatherFront& Front : Fronts)
+        Field.Stamp(ToStamp(Front));
+
+    if (FrontTable)
+    {
+        if (FrontTable->GetRowStruct() && FrontTable->GetRowStruct()->IsChildOf(FThermoForgeWeatherFront::StaticStruct()))
+        {
+            FrontTable->ForeachRow<FThermoForgeWeatherFront>(TEXT("ThermoForgeWeather"), [&](const FName&, const FThermoForgeWeatherFront& Front)
+            {
+                Field.Stamp(ToStamp(Front));
+            });
+        }
+        else
+        {
+            UE_LOG(LogThermoForge, Warning, TEXT("%s: FrontTable %s does not use FThermoForgeWeatherFront rows; ignored"),
+                *GetName(), *FrontTable->GetName());
+        }
+    }
+    return Field;
+}
+
+void AThermoForgeWeatherActor::TakePendingStamps(TArray<FThermoForgeWeatherStamp>& OutStamps)
+{
+    OutStamps.Reset(PendingFronts.Num());
+    for (const FThermoForgeWeatherFront& Front : PendingFronts)
+        OutStamps.Add(ToStamp(Front));
+    PendingFronts.Reset();
+}
+
+void AThermoForgeWeatherActor::BeginPlay()
+{
+    Super::BeginPlay();
+    if (UWorld* W = GetWorld())
+        if (auto* SS = W->GetSubsystem<UThermoForgeSubsystem>())
+            SS->RegisterWeather(this);
+}
+
+void AThermoForgeWeatherActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UWorld* W = GetWorld())
+        if (auto* SS = W->GetSubsystem<UThermoForgeSubsystem>())
+            SS->UnregisterWeather(this);
+    Super::EndPlay(EndPlayReason);
+}
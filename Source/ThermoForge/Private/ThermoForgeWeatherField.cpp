@@ -0,0 +1,76 @@
+﻿#include "ThermoForgeWeatherField.h"
+
+void FThermoForgeWeatherField::Init(const FVector2D& InOrigin, const FIntPoint& InDim, float InCellSizeCm, const FThermoForgeWeatherSample& InBackground)
+{
+    Origin     = InOrigin;
+    Dim        = FIntPoint(FMath::Max(1, InDim.X), FMath::Max(1, InDim.Y));
+    CellSizeCm = FMath::Max(1.f, InCellSizeCm);
+    Background = InBackground;
+
+    CloudCover01.Init(Background.CloudCover01, Dim.X * Dim.Y);
+    Precipitation01.Init(Background.Precipitation01, Dim.X * Dim.Y);
+}
+
+FThermoForgeWeatherSample FThermoForgeWeatherField::Sample(const FVector2D& WorldXY) const
+{
+    if (!IsValid()) return Background;
+
+    // Cell-center space: (0,0) is the center of the first cell
+    const FVector2D G = (WorldXY - Origin) / CellSizeCm - FVector2D(0.5);
+    const int32 x0 = FMath::FloorToInt(G.X);
+    const int32 y0 = FMath::FloorToInt(G.Y);
+    const float fx = float(G.X - x0);
+    const float fy = float(G.Y - y0);
+
+    const FThermoForgeWeatherSample A = Fetch(x0, y0),     B = Fetch(x0 + 1, y0);
+    const FThermoForgeWeatherSample C = Fetch(x0, y0 + 1), D = Fetch(x0 + 1, y0 + 1);
+
+    FThermoForgeWeatherSample Out;
+    Out.CloudCover01    = FMath::BiLerp(A.CloudCover01,    B.CloudCover01,    C.CloudCover01,    D.CloudCover01,    fx, fy);
+    Out.Precipitation01 = FMath::BiLerp(A.Precipitation01, B.Precipitation01, C.Precipitation01, D.Precipitation01, fx, fy);
+    return Out;
+}
+
+void FThermoForgeWeatherField::Stamp(const FThermoForgeWeatherStamp& Front)
+{
+    if (!IsValid() || Front.RadiusCm <= 0.f) return;
+
+    const float Inner = 0.5f * Front.RadiusCm;
+    const FIntPoint Min(FMath::Max(0, FMath::FloorToInt((Front.CenterXY.X - Front.RadiusCm - Origin.X) / CellSizeCm)),
+                        FMath::Max(0, FMath::FloorToInt((Front.CenterXY.Y - Front.RadiusCm - Origin.Y) / CellSizeCm)));
+    const FIntPoint Max(FMath::Min(Dim.X - 1, FMath::FloorToInt((Front.CenterXY.X + Front.RadiusCm - Origin.X) / CellSizeCm)),
+                        FMath::Min(Dim.Y - 1, FMath::FloorToInt((Front.CenterXY.Y + Front.RadiusCm - Origin.Y) / CellSizeCm)));
+
+    for (int32 y = Min.Y; y <= Max.Y; ++y)
+        for (int32 x = Min.X; x <= Max.X; ++x)
+        {
+            const FVector2D P = Origin + FVector2D(x + 0.5, y + 0.5) * CellSizeCm;
+            const float w = 1.f - FMath::SmoothStep(Inner, Front.RadiusCm, float(FVector2D::Distance(P, Front.CenterXY)));
+            if (w <= 0.f) continue;
+
+            const int32 i = y * Dim.X + x;
+            CloudCover01[i]    = FMath::Lerp(CloudCover01[i],    FMath::Clamp(Front.Value.CloudCover01,    0.f, 1.f), w);
+            Precipitation01[i] = FMath::Lerp(Precipitation01[i], FMath::Clamp(Front.Value.Precipitation01, 0.f, 1.f), w);
+        }
+}
+
+void FThermoForgeWeatherField::Advect(const FThermoForgeWeatherField& In, const FVector2D& WindCmPerSec, float DtSeconds,
+    float RelaxAlpha01, FThermoForgeWeatherField& Out)
+{
+    Out.Init(In.Origin, In.Dim, In.CellSizeCm, In.Background);
+    if (!In.IsValid()) return;
+
+    const FVector2D Back  = WindCmPerSec * DtSeconds;
+    const float     Relax = FMath::Clamp(RelaxAlpha01, 0.f, 1.f);
+
+    for (int32 y = 0; y < In.Dim.Y; ++y)
+        for (int32 x = 0; x < In.Dim.X; ++x)
+        {
+            const FVector2D P = In.Origin + FVector2D(x + 0.5, y + 0.5) * In.CellSizeCm;
+            const FThermoForgeWeatherSample Up = In.Sample(P - Back);
+
+            const int32 i = y * In.Dim.X + x;
+            Out.CloudCover01[i]    = FMath::Lerp(Up.CloudCover01,    In.Background.CloudCover01,    Relax);
+            Out.Precipitation01[i] = FMath::Lerp(Up.Precipitation01, In.Background.Precipitation01, Relax);
+        }
+}
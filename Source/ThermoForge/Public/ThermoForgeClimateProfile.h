@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ThermoForgeClimateProfile.generated.h"
+
+class UThermoForgeProjectSettings;
+
+/**
+ * Climate parameters as plain data. The project settings are the default climate; UThermoForgeClimateProfile
+ * overrides them per volume. Ambient is linear in every field, so lerping two climates lerps their temperatures.
+ */
+struct THERMOFORGE_API FThermoForgeClimate
+{
+    float WinterAverageC       = 5.f;
+    float SummerAverageC       = 28.f;
+    float WinterDayNightDeltaC = 8.f;
+    float SummerDayNightDeltaC = 10.f;
+    float SolarGainScaleC      = 6.f;
+    float LapseRateCPerKm      = 10.f; // 0 = no altitude lapse
+    float SeaLevelZcm          = 0.f;
+
+    static FThermoForgeClimate FromSettings(const UThermoForgeProjectSettings* S);
+    static FThermoForgeClimate Lerp(const FThermoForgeClimate& A, const FThermoForgeClimate& B, float Alpha);
+
+    /** Cell blend as stored by the bake: palette index A (bits 0-7), index B (8-15), weight of B (16-31). */
+    static uint32 PackBlend(uint8 A, uint8 B, float WeightB01);
+    static FThermoForgeClimate UnpackBlend(uint32 Packed, TConstArrayView<FThermoForgeClimate> Palette);
+
+    /** Sea-level ambient for a season blend (0 winter … 1 summer) and diurnal wave (-1 trough … 1 peak). */
+    FORCEINLINE float SeaLevelAmbient(float SeasonAlpha01, float DiurnalWave) const
+    {
+        return FMath::Lerp(WinterAverageC, SummerAverageC, SeasonAlpha01)
+             + 0.5f * FMath::Lerp(WinterDayNightDeltaC, SummerDayNightDeltaC, SeasonAlpha01) * DiurnalWave;
+    }
+
+    FORCEINLINE float AdjustForAltitude(float BaseCelsius, float WorldZcm) const
+    {
+        return LapseRateCPerKm > 0.f ? BaseCelsius - LapseRateCPerKm * (WorldZcm - SeaLevelZcm) / 100000.0f : BaseCelsius;
+    }
+
+    /** Fixed-season sea-level ambient for the bWinter / TimeHours API (warmest ~15:00). */
+    float GetAmbientCelsius(bool bWinter, float TimeOfDayHours, bool bDeterministic = false) const;
+
+    FORCEINLINE float GetAmbientCelsiusAt(bool bWinter, float TimeOfDayHours, float WorldZcm, bool bDeterministic = false) const
+    {
+        return AdjustForAltitude(GetAmbientCelsius(bWinter, TimeOfDayHours, bDeterministic), WorldZcm);
+    }
+};
+
+/**
+ * Climate override for a region (desert, snowy mountain, ...). Assign to AThermoForgeVolume::ClimateProfile; the
+ * bake stores per-cell blend weights against the project climate, so the runtime cost is one lookup per query.
+ * Sea level stays the project's.
+ */
+UCLASS(BlueprintType)
+class THERMOFORGE_API UThermoForgeClimateProfile : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate", meta=(ClampMin="-100", ClampMax="100"))
+    float WinterAverageC = 5.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate", meta=(ClampMin="0", ClampMax="60"))
+    float WinterDayNightDeltaC = 8.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate", meta=(ClampMin="-100", ClampMax="100"))
+    float SummerAverageC = 28.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate", meta=(ClampMin="0", ClampMax="60"))
+    float SummerDayNightDeltaC = 10.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate", meta=(ClampMin="0", ClampMax="50"))
+    float SolarGainScaleC = 6.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate|Altitude")
+    bool bEnableAltitudeLapse = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Climate|Altitude", meta=(EditCondition="bEnableAltitudeLapse", ClampMin="0.0", ClampMax="40.0"))
+    float LapseRateCPerKm = 10.f;
+
+    FThermoForgeClimate MakeClimate(const UThermoForgeProjectSettings* S) const;
+};
@@ -0,0 +1,17 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Table-driven Cos / Exp for the deterministic composition mode (Runtime|Determinism in project settings).
+ * Tables are filled from plain double series (adds and multiplies only), not the platform libm, and looked up with
+ * float lerps, so every machine gets bit-identical results as long as the module is built without fast-math.
+ */
+struct THERMOFORGE_API FThermoForgeDeterministicMath
+{
+    /** cos(Radians); max abs error ~3e-7. */
+    static float Cos(float Radians);
+
+    /** exp(X) for X <= 0 (clamped to 0 below -16); max abs error ~2e-6. Positive X is treated as 0. */
+    static float ExpNeg(float X);
+};
@@ -2,8 +2,48 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "ThermoForgeClimateProfile.h"
 #include "ThermoForgeFieldAsset.generated.h"
 
+class UVolumeTexture;
+
+UENUM(BlueprintType)
+enum class EThermoFieldChannel : uint8
+{
+    SkyView          UMETA(DisplayName="Sky View"),
+    WallPermeability UMETA(DisplayName="Wall Permeability"),
+    Indoorness       UMETA(DisplayName="Indoorness")
+};
+
+UENUM(BlueprintType)
+enum class EThermoFieldTextureFormat : uint8
+{
+    R8  UMETA(DisplayName="R8 (8-bit)"),
+    R16 UMETA(DisplayName="R16 (16-bit)")
+};
+
+/** Box-filtered level of a field: level L averages up to 2^L cells per axis. */
+struct FThermoForgeFieldMip
+{
+    FIntVector    Dim = FIntVector::ZeroValue;
+    TArray<float> SkyView01;
+    TArray<float> WallPermeability01;
+
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+};
+
+/** Evaluation of the baked L1 sun visibility. */
+struct FThermoForgeSunVisibility
+{
+    /** Visibility toward the sun times sin(elevation); 0 with the sun below the horizon. */
+    static FORCEINLINE float Exposure(const FVector4f& L1, const FVector& SunDir)
+    {
+        if (SunDir.Z <= 0.0) return 0.f;
+        const float Vis = L1.X + L1.Y * float(SunDir.X) + L1.Z * float(SunDir.Y) + L1.W * float(SunDir.Z);
+        return FMath::Clamp(Vis, 0.f, 1.f) * float(SunDir.Z);
+    }
+};
+
 /**
  * Geometry-invariant bake per volume.
  * Channels:
@@ -17,6 +57,9 @@ class THERMOFORGE_API UThermoForgeFieldAsset : public UDataAsset
     GENERATED_BODY()
 public:
     UThermoForgeFieldAsset();
+
+    virtual void PostLoad() override;
+    virtual void BeginDestroy() override;
     
     /** Grid metadata */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Field")
@@ -45,8 +88,39 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Field", meta=(ToolTip="Indoor proxy = (1 - SkyView01) * (1 - WallPermeability01)"))
     TArray<float> Indoorness01;
 
+    /**
+     * Directional sky visibility, an L1 fit over the bake's sky rays: Vis(dir) ~ X + (Y,Z,W) . dir, dir in world space.
+     * Empty when baked without Bake|Sky > Bake Sun Visibility.
+     */
+    UPROPERTY()
+    TArray<FVector4f> SunVisibilityL1;
+
+    /**
+     * Baked climate blend per cell (FThermoForgeClimate::PackBlend): up to two ClimatePalette entries and the
+     * weight between them. Empty when no overlapping volume overrides the climate.
+     */
+    UPROPERTY()
+    TArray<uint32> ClimateBlend;
+
+    /** Entry 0 is the project climate (null); the rest are the volume profiles the blend refers to. */
+    UPROPERTY(VisibleAnywhere, Category="Field")
+    TArray<TObjectPtr<UThermoForgeClimateProfile>> ClimatePalette;
+
     FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
 
+    FORCEINLINE bool HasClimateOverrides() const { return ClimateBlend.Num() > 0; }
+
+    FORCEINLINE bool HasSunVisibility() const { return SunVisibilityL1.Num() > 0; }
+
+    /** Sky factor of the solar term for a sun direction: sun exposure with sun visibility, SkyView01 without. */
+    float GetSolarExposureByLinearIdx(int32 Linear, const FVector& SunDir) const;
+
+    /** Palette as plain data, [0] = project climate (for copies read off the game thread). */
+    void ResolveClimatePalette(const UThermoForgeProjectSettings* S, TArray<FThermoForgeClimate>& OutPalette) const;
+
+    /** Blended climate of one cell; the project climate when the field has no overrides. */
+    FThermoForgeClimate GetClimateByLinearIdx(int32 Linear, const UThermoForgeProjectSettings* S) const;
+
     /** Trilinear; returns false if outside grid. */
     bool WorldToCellTrilinear(const FVector& P, int32& ix, int32& iy, int32& iz, FVector& Alpha) const;
 
@@ -60,6 +134,9 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Field")
     float SampleIndoorness01(const FVector& WorldPos) const;
 
+    /** Trilinear sky view and wall permeability with their analytic world-space gradients (per cm); false outside the grid. */
+    bool SampleSkyWallWithGradient(const FVector& WorldPos, float& OutSky, FVector& OutSkyGradient, float& OutWall, FVector& OutWallGradient) const;
+
     /** Safe linear-index fetchers */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Field")
     float GetSkyViewByLinearIdx(int32 Linear) const;
@@ -74,4 +151,44 @@ public:
     {
         return FTransform(GridRotation, OriginWS, FVector::OneVector);
     }
+
+    /** Mip level >= 1, built on first use (level 0 is the asset itself). nullptr past the coarsest level. */
+    const FThermoForgeFieldMip* GetMip(int32 Level);
+
+    /** Number of mip levels above level 0 that GetMip can return. */
+    int32 GetNumMips();
+
+    /** Drop transient derived data after the channels were rewritten (e.g. a rebake into the same asset). */
+    void InvalidateDerivedData();
+
+    /** Bumped by InvalidateDerivedData; copies of the channels (query snapshots) rebuild when it changes. */
+    uint32 GetDataRevision() const { return DataRevision; }
+
+    /**
+     * Channel packed into a transient single-channel volume texture (texel = cell, x fastest).
+     * Built on first use and cached per channel/format until the field changes.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Field")
+    UVolumeTexture* GetChannelTexture(EThermoFieldChannel Channel, EThermoFieldTextureFormat Format = EThermoFieldTextureFormat::R8);
+
+    /** Quantize 0..1 values into a new transient R8/R16 volume texture. Values.Num() must equal Dim.X*Dim.Y*Dim.Z. */
+    static UVolumeTexture* CreateVolumeTexture01(TConstArrayView<float> Values01, const FIntVector& InDim,
+                                                 EThermoFieldTextureFormat Format, FName Name = NAME_None);
+
+private:
+    void BuildMips();
+
+    /** Re-report channel + mip bytes to STAT_ThermoForge_FieldMemory. */
+    void UpdateMemoryStat();
+    int64 ReportedMemoryBytes = 0;
+
+    /** Indexed by Channel * 2 + Format. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UVolumeTexture>> ChannelTextures;
+
+    /** Mips[i] is level i + 1. Transient. */
+    TArray<FThermoForgeFieldMip> Mips;
+    bool bMipsBuilt = false;
+
+    uint32 DataRevision = 0;
 };
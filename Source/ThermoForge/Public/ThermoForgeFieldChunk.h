@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ThermoForgeFieldChunk.generated.h"
+
+class UThermoForgeFieldAsset;
+
+/**
+ * One streamed piece of a partitioned volume bake (see AThermoForgeVolume::bStreamWithWorldPartition).
+ * Spatially loaded like any other actor, so its field is only resident while its World Partition cell
+ * (or data layer) is; it registers with the subsystem while its components are registered.
+ *
+ * Chunks of one volume share a layer frame: chunk (X,Y) covers grid cells [X*ChunkCells, (X+1)*ChunkCells)
+ * along the frame's X axis (same for Y) and the volume's full height.
+ */
+UCLASS(NotPlaceable, HideCategories=(Collision, Input, HLOD, Cooking, Replication, Rendering, Actor, LOD))
+class THERMOFORGE_API AThermoForgeFieldChunk : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AThermoForgeFieldChunk();
+
+    /** Name of the volume this chunk was baked from (chunks of one volume form one layer). */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Thermo Forge Chunk")
+    FName SourceVolume;
+
+    /** Grid frame of the whole volume (global grid origin + rotation). */
+    UPROPERTY(VisibleAnywhere, Category="Thermo Forge Chunk")
+    FTransform LayerFrame = FTransform::Identity;
+
+    UPROPERTY(VisibleAnywhere, Category="Thermo Forge Chunk", meta=(Units="cm"))
+    float CellSizeCm = 100.f;
+
+    /** Chunk edge length in cells (X and Y). */
+    UPROPERTY(VisibleAnywhere, Category="Thermo Forge Chunk")
+    int32 ChunkCells = 256;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Thermo Forge Chunk")
+    FIntPoint ChunkCoord = FIntPoint::ZeroValue;
+
+    /** Hard reference: the field loads and unloads with the chunk. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Thermo Forge Chunk")
+    TObjectPtr<UThermoForgeFieldAsset> Field = nullptr;
+
+    /** World-space box of the chunk's cells. */
+    FBox GetChunkBounds() const;
+
+    /** Sync the subsystem registry after Field or the layout changed (the bake calls this on rewritten chunks). */
+    void UpdateRegistration();
+
+    virtual void PostRegisterAllComponents() override;
+    virtual void PostUnregisterAllComponents() override;
+
+#if WITH_EDITOR
+    virtual FBox GetStreamingBounds() const override;
+#endif
+
+private:
+    bool bRegistered = false;
+};
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "NavAreas/NavArea.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "ThermoForgeNavAreas.generated.h"
+
+/** Cells composed above UThermoForgeNavCostComponent::HotThresholdC. */
+UCLASS(Config=Engine)
+class THERMOFORGE_API UThermoForgeNavArea_Hot : public UNavArea
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeNavArea_Hot();
+};
+
+/** Cells composed below UThermoForgeNavCostComponent::ColdThresholdC. */
+UCLASS(Config=Engine)
+class THERMOFORGE_API UThermoForgeNavArea_Cold : public UNavArea
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeNavArea_Cold();
+};
+
+/** Summer behaviour: hot areas are expensive, cold areas cost nothing extra. */
+UCLASS()
+class THERMOFORGE_API UThermoForgeNavFilter_AvoidHeat : public UNavigationQueryFilter
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeNavFilter_AvoidHeat();
+};
+
+/** Winter behaviour: cold areas are expensive, warm areas are preferred. */
+UCLASS()
+class THERMOFORGE_API UThermoForgeNavFilter_SeekWarmth : public UNavigationQueryFilter
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeNavFilter_SeekWarmth();
+};
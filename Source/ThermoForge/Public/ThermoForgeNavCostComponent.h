@@ -0,0 +1,144 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "NavRelevantComponent.h"
+#include "AI/NavigationModifier.h"
+#include "ThermoForgeSourceComponent.h"
+#include "ThermoForgeNavCostComponent.generated.h"
+
+class AThermoForgeVolume;
+class UThermoForgeFieldAsset;
+class UNavArea;
+
+/** One XY tile of a UThermoForgeNavCostComponent's modifiers, so a change only refreshes the navmesh tiles it touches. */
+UCLASS(Transient, NotBlueprintable, ClassGroup=(ThermoForge))
+class THERMOFORGE_API UThermoForgeNavCostTileComponent : public UNavRelevantComponent
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeNavCostTileComponent();
+
+    // UNavRelevantComponent
+    virtual void GetNavigationData(FNavigationRelevantData& Data) const override;
+    virtual void CalcAndCacheBounds() const override;
+
+    /** World bounds of the tile's cell columns. */
+    FBox TileBounds = FBox(ForceInit);
+
+    TArray<FAreaNavModifier> Modifiers;
+};
+
+/**
+ * Projects composed temperature onto the navmesh as nav areas: cells above HotThresholdC become HotArea,
+ * cells below ColdThresholdC become ColdArea, so path costs come from the navmesh (see
+ * UThermoForgeNavFilter_AvoidHeat / _SeekWarmth) instead of per-node subsystem queries.
+ *
+ * Every RefreshIntervalSeconds the source registry is compared with the last pass; only cells inside the old or
+ * new bounds of added, removed or changed sources are recomposed. Modifiers live in TileCells x TileCells column
+ * tiles (one child component each): equal-band cells merge into boxes per slice and identical boxes of consecutive
+ * slices collapse into one, and only tiles with a cell that changed band are re-sent. Needs a navmesh with runtime generation "Dynamic Modifiers Only" (or "Dynamic").
+ * Reads the volume's BakedField (streamed chunks are not projected).
+ */
+UCLASS(ClassGroup=(ThermoForge), BlueprintType, meta=(BlueprintSpawnableComponent))
+class THERMOFORGE_API UThermoForgeNavCostComponent : public UNavRelevantComponent
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeNavCostComponent();
+
+    /** Volume whose field is projected; empty = the owner, if it is a volume. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Nav")
+    TObjectPtr<AThermoForgeVolume> Volume = nullptr;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Nav")
+    float HotThresholdC = 35.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Nav")
+    float ColdThresholdC = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Nav")
+    TSubclassOf<UNavArea> HotArea;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Nav")
+    TSubclassOf<UNavArea> ColdArea;
+
+    /** Climate the cells are composed for; change through SetClimate. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Nav|Climate")
+    bool bWinter = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Nav|Climate", meta=(ClampMin="0", ClampMax="24"))
+    float TimeHours = 15.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Nav|Climate", meta=(ClampMin="0", ClampMax="1"))
+    float WeatherAlpha01 = 0.3f;
+
+    /** Seconds between source checks. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Nav", meta=(ClampMin="0.0", Units="s"))
+    float RefreshIntervalSeconds = 0.5f;
+
+    /** Edge of a modifier tile in cells; smaller tiles refresh less navmesh per change but export more boxes. */
+    UPROPERTY(EditAnywhere, Category="Thermo Nav", meta=(ClampMin="1", ClampMax="256"))
+    int32 TileCells = 16;
+
+    /** Recompose every cell and re-send the modifiers. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Nav")
+    void RebuildAll();
+
+    /** Change the climate; recomposes everything if anything differs. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Nav")
+    void SetClimate(bool bInWinter, float InTimeHours, float InWeatherAlpha01);
+
+    /** Hot / cold boxes currently exported. */
+    UFUNCTION(BlueprintPure, Category="Thermo Nav")
+    int32 GetNumModifiers() const;
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    enum class EBand : uint8 { Neutral, Hot, Cold };
+
+    /** Resolve the field; false if there is none. Resets the cell cache when the field or its data changed. */
+    bool BindField();
+
+    /** Recompose the given cells (all when empty); tiles of cells that changed band are set in DirtyTiles. */
+    void RecomposeCells(TConstArrayView<int32> Cells);
+
+    /** Create / drop tile components to match the field; marks every tile dirty. */
+    void SyncTiles();
+
+    /** Rebuild and re-send the modifiers of the dirty tiles. */
+    void RefreshDirtyTiles();
+
+    /** Equal-band rectangles per slice, collapsed across slices, for one tile. */
+    void BuildTileModifiers(int32 Tile, TArray<FAreaNavModifier>& OutModifiers) const;
+
+    int32 TileOfCell(int32 CellIndex) const;
+    void DestroyTiles();
+
+    /** Cells whose centers lie in one of the world boxes. */
+    void GatherCellsInBoxes(TConstArrayView<FBox> Boxes, TArray<int32>& OutCells) const;
+
+    /** Diff the registry against LastSources; fills the bounds that need recomposing. */
+    void CollectSourceChanges(TArray<FBox>& OutDirty);
+
+    TWeakObjectPtr<const UThermoForgeFieldAsset> BoundField;
+    uint32 BoundRevision = 0;
+
+    TArray<EBand> Bands;
+
+    FIntPoint NumTiles = FIntPoint::ZeroValue;
+    int32 BoundTileCells = 0;
+    TBitArray<> DirtyTiles;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UThermoForgeNavCostTileComponent>> Tiles;
+
+    TMap<TWeakObjectPtr<UThermoForgeSourceComponent>, FThermoForgeSourceState> LastSources;
+    float TimeSinceRefresh = 0.f;
+};
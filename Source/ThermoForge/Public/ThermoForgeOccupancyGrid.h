@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class UThermoForgeProjectSettings;
+
+/**
+ * Collision occupancy voxelized in a bake grid's frame (voxel bake backend).
+ * Each voxel holds a slot into a small density palette (0 = empty), so the
+ * sky and wall passes become DDA marches over a byte array instead of scene queries.
+ */
+struct THERMOFORGE_API FThermoForgeOccupancyGrid
+{
+    /** Grid space → world (rotation + translation, no scale). */
+    FTransform Frame = FTransform::Identity;
+
+    /** Grid-space min corner of voxel (0,0,0). */
+    FVector OriginLS = FVector::ZeroVector;
+
+    float      VoxelSize = 50.f;
+    FIntVector Dim = FIntVector::ZeroValue;
+
+    /** Thickness reference for multi-hit optical depth (bake cell size). */
+    float CellSizeCm = 100.f;
+
+    /** Palette slot per voxel; 0 = empty, k = DensityPalette[k-1]. */
+    TArray<uint8> Occupancy;
+
+    /** Distinct densities (kg/m^3) seen while rasterizing. */
+    TArray<float> DensityPalette;
+
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+
+    void Init(const FTransform& InFrame, const FVector& InOriginLS, float InVoxelSize, const FIntVector& InDim, float InCellSizeCm);
+
+    /**
+     * Rasterize blocking collision on the trace channel (game thread).
+     * Simple shapes (box, sphere, capsule, convex) are filled exactly at voxel centers.
+     * Components without simple shapes (landscape, complex-as-simple meshes) are voxelized as a surface shell from
+     * component traces along the three grid axes, so hollow meshes stay hollow as they do for the trace backend.
+     */
+    void Rasterize(const UWorld* World, const UThermoForgeProjectSettings* S);
+
+    /** Density of the first occupied voxel from P along Dir within MaxLen (world space). False if the path is clear. */
+    bool FirstHit(const FVector& PWS, const FVector& DirWS, float MaxLen, float& OutDensityKgM3) const;
+
+    /** Optical depth summed over every occupied voxel from P along Dir within MaxLen, capped at MaxDepth. */
+    float OpticalDepthAlong(const FVector& PWS, const FVector& DirWS, float MaxLen, float MaxDepth, const UThermoForgeProjectSettings* S) const;
+
+    /** Same mapping as FThermoForgeTraceContext::AmbientRay01, from the voxel march. */
+    float AmbientRay01(const FVector& P, const FVector& Dir, float MaxLen, const UThermoForgeProjectSettings* S) const;
+
+    /** Same mapping as FThermoForgeTraceContext::OcclusionBetween, from the voxel march. */
+    float OcclusionBetween(const FVector& A, const FVector& B, float InCellSizeCm, const UThermoForgeProjectSettings* S) const;
+
+    int32 NumOccupied() const;
+
+private:
+    uint8 FindOrAddDensity(float DensityKgM3);
+};
@@ -3,8 +3,62 @@
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
 #include "Engine/EngineTypes.h" // ECollisionChannel
+#include "PhysicalMaterials/PhysicalMaterial.h"
 #include "ThermoForgeProjectSettings.generated.h"
 
+UENUM(BlueprintType)
+enum class EThermoBakeQuality : uint8
+{
+    Draft     UMETA(DisplayName="Draft (4 rays)"),
+    Standard  UMETA(DisplayName="Standard (fixed 12 rays)"),
+    Shipping  UMETA(DisplayName="Shipping (adaptive 8..64 rays)"),
+    Custom    UMETA(DisplayName="Custom")
+};
+
+UENUM(BlueprintType)
+enum class EThermoSkyDirections : uint8
+{
+    Fixed12    UMETA(DisplayName="Fixed 12 (legacy table)"),
+    Stratified UMETA(DisplayName="Stratified (jittered grid)"),
+    Fibonacci  UMETA(DisplayName="Fibonacci spiral")
+};
+
+UENUM(BlueprintType)
+enum class EThermoBakeBackend : uint8
+{
+    Traces UMETA(DisplayName="Scene Traces"),
+    Voxels UMETA(DisplayName="Occupancy Voxels (trace-free)")
+};
+
+UENUM(BlueprintType)
+enum class EThermoClockMode : uint8
+{
+    RealTime UMETA(DisplayName="Real Time (UTC now)"),
+    GameTime UMETA(DisplayName="Game Time (scaled world time)"),
+    External UMETA(DisplayName="External (provider / SetSimulationTimeUTC)")
+};
+
+/** Sky-openness sampling resolved from the bake quality tier. */
+struct THERMOFORGE_API FThermoForgeSkySampling
+{
+    EThermoSkyDirections Directions = EThermoSkyDirections::Fixed12;
+    int32 NumDirections   = 12;
+    bool  bCosineWeighted = false;
+    float MaxRayLengthCm  = 100000.f;
+
+    /** Trace NumDirections first; cells whose rays spread more than AdaptiveSpread get AdaptiveMaxDirections. */
+    bool  bAdaptive = false;
+    int32 AdaptiveMaxDirections = 64;
+    float AdaptiveSpread = 0.25f;
+
+    /**
+     * Deterministic upper-hemisphere directions (+Z up) with weights summing to 1: exactly Count for the generated
+     * sets, always 12 for Fixed12.
+     * Cosine weighting uses cosine-distributed directions for the generated sets and per-ray weights for Fixed12.
+     */
+    void BuildDirections(int32 Count, TArray<FVector>& OutDirs, TArray<float>& OutWeights) const;
+};
+
 /**
  * Project-wide Thermo Forge settings.
  * Bake is geometry-only (sky view / wall permeability),
@@ -35,14 +89,22 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="60"))
     float SummerDayNightDeltaC = 10.f;
 
-    /** Default weather factor (0 clear … 1 overcast). */
+    /** Default weather factor (0 clear … 1 overcast); runtime queries use it when no weather actor is present. */
     UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="1"))
     float DefaultWeatherAlpha01 = 0.3f;
 
-    /** °C contribution for full sun at sea level (before weather scaling). */
+    /** °C contribution for full sun at sea level (before weather scaling); overhead sun for fields with sun visibility. */
     UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="50", ToolTip="How many °C does full sun add at SkyView=1, Weather=0"))
     float SolarGainScaleC = 6.f;
 
+    /** Latitude of the sun path (degrees, south negative); used with baked sun visibility. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Sun", meta=(ClampMin="-90", ClampMax="90"))
+    float SunLatitudeDeg = 45.f;
+
+    /** World yaw of north (0 = +X north, +Y east). */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Sun", meta=(ClampMin="-180", ClampMax="180"))
+    float NorthYawDeg = 0.f;
+
     // ======== ALTITUDE ========
     /** Apply environmental lapse rate with altitude. */
     UPROPERTY(EditAnywhere, Config, Category="Climate|Altitude")
@@ -73,6 +135,10 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Permeability", meta=(ClampMin="1000", ClampMax="20000"))
     float MaxSolidDensityKgM3 = 3000.f;
 
+    /** Per-physmat densities (kg/m^3) used instead of the material's own Density, so physmats stay untouched. */
+    UPROPERTY(EditAnywhere, Config, Category="Permeability", meta=(ForceInlineRow))
+    TMap<TSoftObjectPtr<UPhysicalMaterial>, float> DensityOverridesKgM3;
+
     /** Density to assume when PhysMat is missing and not treated as air. */
     UPROPERTY(EditAnywhere, Config, Category="Permeability", meta=(ClampMin="100", ClampMax="5000"))
     float UnknownHitDensityKgM3 = 700.f;
@@ -100,6 +166,90 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Permeability", meta=(ClampMin="0", ClampMax="1"))
     float MaxPermeabilityClamp = 1.f;
 
+    /**
+     * Integrate density x thickness over every solid a ray crosses (entry/exit pairs) instead of
+     * attenuating by the first hit only. A thin fence and a thick wall then differ.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Permeability")
+    bool bMultiHitOcclusion = false;
+
+    /** Stop integrating once transmittance drops below this. */
+    UPROPERTY(EditAnywhere, Config, Category="Permeability", meta=(EditCondition="bMultiHitOcclusion", ClampMin="0.0001", ClampMax="0.5"))
+    float TransmittanceEpsilon = 0.01f;
+
+    /** Upper bound of solids integrated per ray. */
+    UPROPERTY(EditAnywhere, Config, Category="Permeability", meta=(EditCondition="bMultiHitOcclusion", ClampMin="1", ClampMax="64"))
+    int32 MaxOcclusionCrossings = 16;
+
+    // ======== BAKE ========
+    /** Spread the bake over worker threads (one z-slice per task). Off = single thread, same results. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake")
+    bool bParallelBake = true;
+
+    /**
+     * Traces: scene queries per ray (reference). Voxels: rasterize collision into an occupancy grid
+     * and march it instead; much faster on large grids, geometry beyond VoxelMarginCm is ignored.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Bake")
+    EThermoBakeBackend BakeBackend = EThermoBakeBackend::Traces;
+
+    /** Voxels per cell edge for the occupancy grid. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake", meta=(EditCondition="BakeBackend==EThermoBakeBackend::Voxels", ClampMin="1", ClampMax="8"))
+    int32 VoxelsPerCell = 2;
+
+    /** Occupancy grid padding around the volume (sideways and above) that sky rays can still hit. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake", meta=(EditCondition="BakeBackend==EThermoBakeBackend::Voxels", ClampMin="0", Units="cm"))
+    float VoxelMarginCm = 5000.f;
+
+    /**
+     * Before tracing, resolve bricks with no geometry in reach (open; one box sweep per sky direction replaces the
+     * per-cell rays) or buried in one solid (that solid's one-cell transmittance).
+     * Overlap tests use simple collision; meshes whose simple collision misses their traced geometry may be misclassified.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Bake")
+    bool bSkipUniformBricks = true;
+
+    /** Brick edge length in cells for the pre-pass. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake", meta=(EditCondition="bSkipUniformBricks", ClampMin="2", ClampMax="32"))
+    int32 BakeBrickSize = 8;
+
+    /** Sky-openness sampling preset. Standard matches the original fixed 12-ray table. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky")
+    EThermoBakeQuality BakeQuality = EThermoBakeQuality::Standard;
+
+    /** Max length of sky rays; anything farther counts as open sky. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(ClampMin="100", Units="cm"))
+    float SkyMaxRayLengthCm = 100000.f;
+
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(EditCondition="BakeQuality==EThermoBakeQuality::Custom"))
+    EThermoSkyDirections SkyDirections = EThermoSkyDirections::Fibonacci;
+
+    /** Rays per cell (initial rays when adaptive). Ignored by Fixed12. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(EditCondition="BakeQuality==EThermoBakeQuality::Custom", ClampMin="1", ClampMax="256"))
+    int32 SkyDirectionCount = 16;
+
+    /** Weight rays by cos(angle to zenith), i.e. irradiance-style openness instead of plain solid angle. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(EditCondition="BakeQuality==EThermoBakeQuality::Custom"))
+    bool bSkyCosineWeighted = false;
+
+    /** Fire SkyDirectionCount rays, then resample with SkyAdaptiveMaxDirections where they disagree. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(EditCondition="BakeQuality==EThermoBakeQuality::Custom"))
+    bool bSkyAdaptive = false;
+
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(EditCondition="BakeQuality==EThermoBakeQuality::Custom && bSkyAdaptive", ClampMin="1", ClampMax="256"))
+    int32 SkyAdaptiveMaxDirections = 64;
+
+    /** Max-min permeability among the initial rays above which a cell is resampled. */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky", meta=(EditCondition="BakeQuality==EThermoBakeQuality::Custom && bSkyAdaptive", ClampMin="0", ClampMax="1"))
+    float SkyAdaptiveSpread = 0.25f;
+
+    /**
+     * Also store directional sky visibility (an L1 fit over the sky rays, 4 floats per cell) so solar gain follows
+     * the sun through the day. Off = isotropic SkyView01 solar gain.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Bake|Sky")
+    bool bBakeSunVisibility = true;
+
     // ======== GRID DEFAULTS ========
     /** Default cell size (cm) for volumes using global grid. */
     UPROPERTY(EditAnywhere, Config, Category="Grid", meta=(ClampMin="10", ClampMax="1000", Units="cm"))
@@ -126,6 +276,81 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Preview", meta=(ClampMin="0", ClampMax="1"))
     float PreviewWeatherAlpha = 0.3f;
 
+    // ======== RUNTIME COMPOSITION ========
+    /** Keep a composed current-temperature channel per volume, refreshed brick by brick in a background task. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Composition")
+    bool bEnableTimeSlicedComposition = false;
+
+    /** Brick edge length in cells; bricks are the unit of refresh. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Composition", meta=(EditCondition="bEnableTimeSlicedComposition", ClampMin="2", ClampMax="32"))
+    int32 CompositionBrickSize = 8;
+
+    /** Upper bound of bricks handed to the background task per tick. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Composition", meta=(EditCondition="bEnableTimeSlicedComposition", ClampMin="1", ClampMax="1024"))
+    int32 CompositionBricksPerTick = 16;
+
+    /** Wall-clock budget (ms) for one refresh pass, game-thread scheduling included; bricks past the budget wait for the next pass. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Composition", meta=(EditCondition="bEnableTimeSlicedComposition", ClampMin="0.05", ClampMax="16", Units="ms"))
+    float CompositionBudgetMs = 0.5f;
+
+    /** Distance at which player proximity halves a brick's refresh priority. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Composition", meta=(EditCondition="bEnableTimeSlicedComposition", ClampMin="100", Units="cm"))
+    float CompositionProximityFalloffCm = 5000.f;
+
+    /** Extra priority per active source overlapping a brick. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Composition", meta=(EditCondition="bEnableTimeSlicedComposition", ClampMin="0", ClampMax="100"))
+    float CompositionSourceActivityWeight = 4.f;
+
+    // ======== RUNTIME SNAPSHOT ========
+    /** Publish an immutable query snapshot every tick for worker-thread readers (UThermoForgeSubsystem::AcquireSnapshot). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Snapshot")
+    bool bPublishQuerySnapshot = true;
+
+    // ======== RUNTIME WATCHES ========
+    /** Batched passes per second over all UThermoForgeWatchComponents. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Watches", meta=(ClampMin="0.1", ClampMax="60", Units="Hz"))
+    float WatchUpdateRateHz = 4.f;
+
+    // ======== RUNTIME CLOCK ========
+    /** What drives the subsystem's thermal clock (season and diurnal terms are derived from it once per tick). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clock")
+    EThermoClockMode ClockMode = EThermoClockMode::RealTime;
+
+    /** Clock at world start for Game Time / External (and Real Time in deterministic mode). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clock")
+    FDateTime ClockStartUTC = FDateTime(2000, 6, 21, 12);
+
+    /** Game seconds per world second in Game Time mode (60 = one day in 24 minutes). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clock", meta=(EditCondition="ClockMode==EThermoClockMode::GameTime", ClampMin="0"))
+    float ClockTimeScale = 1.f;
+
+    // ======== RUNTIME DETERMINISM ========
+    /**
+     * Bit-reproducible composition for lockstep and replays: results depend only on the baked field, the sources and
+     * the subsystem's thermal clock (Real Time mode never reads the wall clock here). Source occlusion traces are
+     * skipped, Cos / Exp come from fixed tables and sources are summed in a stable order.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Determinism")
+    bool bDeterministicComposition = false;
+
+    // ======== RUNTIME REPLICATION ========
+    /** Servers spawn an AThermoForgeStateReplicator that sends the source table to clients. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Replication")
+    bool bReplicateThermalState = true;
+
+    /** Source table diffs per second; only sources whose quantized state changed are sent. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Replication", meta=(EditCondition="bReplicateThermalState", ClampMin="0.5", ClampMax="60", Units="Hz"))
+    float ReplicationRateHz = 10.f;
+
+    // ======== RUNTIME WEATHER ========
+    /** Advection steps per second of the AThermoForgeWeatherActor field (each step runs on a worker). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Weather", meta=(ClampMin="0.1", ClampMax="30", Units="Hz"))
+    float WeatherUpdateRateHz = 2.f;
+
+    /** Ambient drop (°C) under full precipitation. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Weather", meta=(ClampMin="0", ClampMax="20"))
+    float PrecipitationCoolingC = 3.f;
+
     // ======== Helpers ========
     /** Diurnal ambient at sea level (°C). */
     UFUNCTION(BlueprintPure, Category="Thermo Forge")
@@ -139,7 +364,19 @@ public:
     UFUNCTION(BlueprintPure, Category="Thermo Forge")
     float GetAmbientCelsiusAt(bool bWinter, float TimeOfDayHours, float WorldZcm) const;
 
+    /** Sky sampling for the current BakeQuality. */
+    FThermoForgeSkySampling GetSkySampling() const;
+
     /** Map material density & path thickness to permeability [0..1]. */
     UFUNCTION(BlueprintPure, Category="Thermo Forge")
     float DensityToPermeability(float DensityKgM3, float ThicknessFraction) const;
+
+    /** Density override for a physmat, if one is set. */
+    bool FindDensityOverride(const UPhysicalMaterial* PhysMat, float& OutDensityKgM3) const;
+
+    /** Beer–Lambert optical depth of one crossing: beta * normalized density * thickness (cell fractions). */
+    float OpticalDepth(float DensityKgM3, float ThicknessFraction) const;
+
+    /** exp(-depth), clamped to the permeability range. */
+    float OpticalDepthToPermeability(float Depth) const;
 };
@@ -0,0 +1,115 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ThermoForgeSubsystem.h"
+
+class UWorld;
+class UThermoForgeProjectSettings;
+
+/** Nearest-cell result of a snapshot query (plain data, no UObjects). */
+struct FThermoForgeSnapshotSample
+{
+    bool       bFound = false;
+    FIntVector GridIndex = FIntVector::ZeroValue;
+    int32      LinearIndex = -1;
+    FVector    CellCenterWS = FVector::ZeroVector;
+    double     DistanceSq = TNumericLimits<double>::Max();
+    float      Sky = 0.f;
+    float      WallPerm = 1.f;
+
+    /** Baked volume climate of the cell; only meaningful when bClimateOverride. */
+    bool                bClimateOverride = false;
+    FThermoForgeClimate Climate;
+
+    /** Baked sun visibility of the cell; only meaningful when bSunVisibility. */
+    bool      bSunVisibility = false;
+    FVector4f SunVisibilityL1 = FVector4f::Zero();
+};
+
+/**
+ * Copy of one field's grid frame and the channels composition reads.
+ * Shared by every snapshot until the asset's data revision changes.
+ */
+struct THERMOFORGE_API FThermoForgeFieldSnapshot
+{
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 100.f;
+    FTransform Frame    = FTransform::Identity;
+    FTransform InvFrame = FTransform::Identity;
+
+    TArray<float> SkyView01;
+    TArray<float> WallPermeability01;
+    TArray<FVector4f> SunVisibilityL1; // empty without baked sun visibility
+
+    /** Packed per-cell blend and its resolved palette; both empty without climate overrides. */
+    TArray<uint32>              ClimateBlend;
+    TArray<FThermoForgeClimate> ClimatePalette;
+
+    /** Nearest cell (clamped to the grid), as UThermoForgeSubsystem::ComputeNearestInField. */
+    bool FindNearestCell(const FVector& WorldPos, FThermoForgeSnapshotSample& Out) const;
+};
+
+/** A volume or a streamed chunk: oriented box plus its field. */
+struct FThermoForgeSnapshotVolume
+{
+    FTransform Transform = FTransform::Identity;
+    FVector    BoxExtent = FVector::ZeroVector;
+    bool       bUnbounded = false;
+    bool       bChunk = false;
+    TSharedPtr<const FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> Field;
+
+    bool Contains(const FVector& WorldPos) const;
+};
+
+/**
+ * Everything a temperature query needs, frozen on the game thread once per tick and never modified afterwards,
+ * so any thread (Mass processors, async pathfinding, StateTree tasks) can query it without locks.
+ * Get one from UThermoForgeSubsystem::AcquireSnapshot. Acquiring is not lock-free: it copies the published pointer
+ * under a shared read lock (UE has no atomic shared pointer; the game thread takes the write side once per tick for
+ * one pointer swap). Readers never wait on each other, and on the publisher for at most that swap.
+ *
+ * Occlusion traces still go to the physics scene, which must outlive the read; pass no trace context from work
+ * that can outlive the world.
+ */
+class THERMOFORGE_API FThermoForgeWorldSnapshot
+{
+public:
+    /** GFrameCounter at publish. */
+    uint64    FrameNumber = 0;
+    FDateTime TimeUTC = FDateTime(0);
+    float     WeatherAlpha01 = 0.f; // cloud cover without a weather field
+
+    /** Season / diurnal terms of the thermal clock at publish. */
+    FThermoForgeClimateTerms Climate;
+
+    /** Weather field at publish; null = WeatherAlpha01 everywhere. */
+    TSharedPtr<const FThermoForgeWeatherField, ESPMode::ThreadSafe> Weather;
+
+    /** Project climate, used outside fields with climate overrides. */
+    FThermoForgeClimate DefaultClimate;
+
+    /** Loaded chunks first, then volumes with a baked field. */
+    TArray<FThermoForgeSnapshotVolume> Volumes;
+    TArray<FThermoForgeSourceState>    Sources;
+
+    /** Same preference as QueryNearestBakedGridPoint: containing chunk, nearest containing volume, nearest overall. */
+    bool FindNearestCell(const FVector& WorldPos, FThermoForgeSnapshotSample& Out) const;
+
+    FThermoForgeWeatherSample SampleWeatherAt(const FVector& WorldPos) const;
+
+    /**
+     * Composed °C at the snapshot's time. Source occlusion is traced through TraceContext (one per thread, see
+     * MakeTraceContext); without one, sources are attenuated by the local wall permeability only.
+     */
+    float ComputeTemperatureAt(const FVector& WorldPos, FThermoForgeTraceContext* TraceContext = nullptr) const;
+
+    /** Trace context bound to the snapshot's world, settings and shared density cache. */
+    FThermoForgeTraceContext MakeTraceContext() const;
+
+private:
+    friend class UThermoForgeSubsystem;
+
+    const UWorld* World = nullptr;
+    const UThermoForgeProjectSettings* Settings = nullptr;
+    TSharedPtr<FThermoForgeDensityCache, ESPMode::ThreadSafe> DensityCache;
+};
@@ -19,6 +19,30 @@ enum class EThermoSourceFalloff : uint8
     InverseSquare UMETA(DisplayName="Inverse Square (1 / (1 + (d/R)^2))")
 };
 
+/**
+ * Plain-data copy of a source taken on the game thread.
+ * Owner scale is already folded into RadiusCm / BoxExtent, so it can be evaluated off the game thread.
+ */
+struct THERMOFORGE_API FThermoForgeSourceState
+{
+    EThermoSourceShape   Shape   = EThermoSourceShape::Point;
+    EThermoSourceFalloff Falloff = EThermoSourceFalloff::Linear;
+    float      IntensityCelsius  = 0.f;
+    float      RadiusCm          = 0.f;
+    FVector    BoxExtent         = FVector::ZeroVector;
+    FTransform Transform         = FTransform::Identity;
+
+    FORCEINLINE FVector GetLocation() const { return Transform.GetLocation(); }
+
+    /** Signed °C delta at P (0 outside the source). */
+    float SampleAt(const FVector& P) const;
+
+    /** SampleAt plus its gradient (°C per cm) from the closed-form falloff derivative; box sources are flat inside. */
+    float SampleAt(const FVector& P, FVector& OutGradient) const;
+
+    FBox GetBoundsWS() const;
+};
+
 UCLASS(ClassGroup=(ThermoForge), BlueprintType, Blueprintable, meta=(BlueprintSpawnableComponent))
 class THERMOFORGE_API UThermoForgeSourceComponent : public UActorComponent
 {
@@ -61,6 +85,9 @@ public:
     UFUNCTION(BlueprintPure, Category="Thermo Source")
     FVector GetOwnerLocationSafe() const;
 
+    /** Snapshot of the current source parameters and owner transform. */
+    FThermoForgeSourceState MakeState() const;
+
 protected:
     virtual void OnRegister() override;
     virtual void OnUnregister() override;
@@ -0,0 +1,142 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ThermoForgeSourceComponent.h"
+#include "ThermoForgeStateReplicator.generated.h"
+
+class AThermoForgeStateReplicator;
+
+/**
+ * One source on the wire: the component's own parameters plus the owner pose. Values are quantized on the server
+ * and the item is only re-sent when a quantized value changes: intensity in 0.1 °C, radius in 1 cm (capped at
+ * 655 m), location / extent in 1 cm, rotation in 16-bit axes, owner scale in 1/100.
+ */
+USTRUCT()
+struct FThermoForgeReplicatedSource : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    /** Server-assigned, stable for the lifetime of the source. */
+    UPROPERTY()
+    int32 SourceId = INDEX_NONE;
+
+    /** Resolves on clients for net-addressable components (placed in the level or part of a replicated actor). */
+    UPROPERTY()
+    TObjectPtr<UThermoForgeSourceComponent> Source = nullptr;
+
+    UPROPERTY()
+    bool bEnabled = true;
+
+    UPROPERTY()
+    EThermoSourceShape Shape = EThermoSourceShape::Point;
+
+    UPROPERTY()
+    EThermoSourceFalloff Falloff = EThermoSourceFalloff::Linear;
+
+    UPROPERTY()
+    int16 IntensityDeciC = 0;
+
+    UPROPERTY()
+    uint16 RadiusCm = 0;
+
+    UPROPERTY()
+    FVector_NetQuantize BoxExtent = FVector::ZeroVector;
+
+    UPROPERTY()
+    FVector_NetQuantize Location = FVector::ZeroVector;
+
+    UPROPERTY()
+    uint16 Pitch = 0;
+
+    UPROPERTY()
+    uint16 Yaw = 0;
+
+    UPROPERTY()
+    uint16 Roll = 0;
+
+    UPROPERTY()
+    bool bAffectByOwnerScale = false;
+
+    UPROPERTY()
+    FVector_NetQuantize100 OwnerScale = FVector::OneVector;
+
+    /** Quantize the server-side component; true if anything on the wire changed. */
+    bool SetFromSource(const UThermoForgeSourceComponent& InSource);
+
+    /** Dequantized state, as MakeState would have produced it on the server. */
+    FThermoForgeSourceState ToState() const;
+
+    /** Write the replicated parameters into a client-side component (its pose comes from actor replication). */
+    void ApplyTo(UThermoForgeSourceComponent& Target) const;
+
+    void PostReplicatedAdd(const struct FThermoForgeReplicatedSourceArray& InArraySerializer);
+    void PostReplicatedChange(const struct FThermoForgeReplicatedSourceArray& InArraySerializer);
+    void PreReplicatedRemove(const struct FThermoForgeReplicatedSourceArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FThermoForgeReplicatedSourceArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FThermoForgeReplicatedSource> Items;
+
+    /** Receives the client-side callbacks. */
+    UPROPERTY(NotReplicated)
+    TObjectPtr<AThermoForgeStateReplicator> Owner = nullptr;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FThermoForgeReplicatedSource, FThermoForgeReplicatedSourceArray>(Items, DeltaParms, *this);
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FThermoForgeReplicatedSourceArray> : public TStructOpsTypeTraitsBase2<FThermoForgeReplicatedSourceArray>
+{
+    enum { WithNetDeltaSerializer = true };
+};
+
+/**
+ * Server-authoritative thermal state for multiplayer. Spawned by the subsystem on servers
+ * (Runtime|Replication in project settings); always relevant.
+ *
+ * The server diffs the source registry at ReplicationRateHz and replicates it as a fast array, so only sources
+ * whose quantized state changed cost bandwidth. Clients write the replicated parameters into the matching
+ * local component, or, when the component does not exist on the client, feed the state to the subsystem as a
+ * proxy source. Client temperatures then compose from the same baked field and the server's sources.
+ */
+UCLASS(NotPlaceable, Transient)
+class THERMOFORGE_API AThermoForgeStateReplicator : public AInfo
+{
+    GENERATED_BODY()
+
+public:
+    AThermoForgeStateReplicator();
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void PostInitializeComponents() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void Tick(float DeltaSeconds) override;
+
+    /** Server: bring the replicated table in line with the source registry. */
+    void SyncFromSubsystem();
+
+    // client callbacks from the fast array
+    void ApplyReplicatedSource(const FThermoForgeReplicatedSource& Item);
+    void RemoveReplicatedSource(const FThermoForgeReplicatedSource& Item);
+
+    UFUNCTION(BlueprintPure, Category="Thermo Forge")
+    int32 GetReplicatedSourceCount() const { return Sources.Items.Num(); }
+
+private:
+    UPROPERTY(Replicated)
+    FThermoForgeReplicatedSourceArray Sources;
+
+    /** Server: id per registered component. */
+    TMap<TWeakObjectPtr<UThermoForgeSourceComponent>, int32> SourceIds;
+    int32 NextSourceId = 0;
+};
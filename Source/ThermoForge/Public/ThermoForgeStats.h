@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+THERMOFORGE_API DECLARE_LOG_CATEGORY_EXTERN(LogThermoForge, Log, All);
+
+// `stat ThermoForge` in the console; cycle stats and the TRACE_CPUPROFILER scopes also show in Insights.
+DECLARE_STATS_GROUP(TEXT("ThermoForge"), STATGROUP_ThermoForge, STATCAT_Advanced);
+
+// Per frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Queries"),              STAT_ThermoForge_Queries,           STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Source Evaluations"),   STAT_ThermoForge_SourceEvals,       STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Occlusion Traces"),     STAT_ThermoForge_OcclusionTraces,   STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Density Cache Hits"),   STAT_ThermoForge_DensityCacheHits,  STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Density Cache Misses"), STAT_ThermoForge_DensityCacheMisses, STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Composed Cells"),       STAT_ThermoForge_ComposedCells,     STATGROUP_ThermoForge, THERMOFORGE_API);
+
+// Persistent
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last Bake Cells/sec"), STAT_ThermoForge_BakeCellsPerSec, STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Loaded Field Chunks"), STAT_ThermoForge_LoadedChunks,    STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Watches"),             STAT_ThermoForge_Watches,         STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Field Memory"),                   STAT_ThermoForge_FieldMemory,     STATGROUP_ThermoForge, THERMOFORGE_API);
+
+// Timings
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bake"),        STAT_ThermoForge_Bake,        STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Query"),       STAT_ThermoForge_Query,       STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Composition"), STAT_ThermoForge_Composition, STATGROUP_ThermoForge, THERMOFORGE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Preview"),     STAT_ThermoForge_Preview,     STATGROUP_ThermoForge, THERMOFORGE_API);
@@ -2,12 +2,29 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "CollisionQueryParams.h"
+#include "Engine/HitResult.h"
+#include "Engine/OverlapResult.h"
+#include "UObject/ObjectKey.h"
+#include "HAL/CriticalSection.h"
+#include "ThermoForgeSourceComponent.h"
+#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeClimateProfile.h"
+#include "ThermoForgeWeatherField.h"
 #include "ThermoForgeSubsystem.generated.h"
 
-class UThermoForgeSourceComponent;
 class AThermoForgeVolume;
+class AThermoForgeFieldChunk;
 class UThermoForgeFieldAsset;
 class UThermoForgeProjectSettings;
+class UPrimitiveComponent;
+class UPhysicalMaterial;
+class FThermoForgeWorldSnapshot;
+class UThermoForgeWatchComponent;
+class AThermoForgeStateReplicator;
+class AThermoForgeWeatherActor;
+struct FThermoForgeFieldSnapshot;
 
 // ---------- RESULT STRUCT ----------
 USTRUCT(BlueprintType)
@@ -18,9 +35,14 @@ struct FThermoForgeGridHit
     UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
     bool bFound = false;
 
+    /** Volume the cell was baked from; null for streamed chunks whose volume is not loaded. */
     UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
     TObjectPtr<AThermoForgeVolume> Volume = nullptr;
 
+    /** Field holding the cell (the volume's BakedField or a streamed chunk's); LinearIndex indexes into it. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    TObjectPtr<UThermoForgeFieldAsset> Field = nullptr;
+
     UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
     FIntVector GridIndex = FIntVector::ZeroValue;
 
@@ -44,16 +66,302 @@ struct FThermoForgeGridHit
     float CurrentTempC = 0.f;
 };
 
+/** Temperature and its spatial derivative at one point (SampleTemperatureGradient). */
+USTRUCT(BlueprintType)
+struct FThermoForgeTemperatureGradient
+{
+    GENERATED_BODY()
+
+    /** False if no baked field was found (ambient and sources only). */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    bool bInField = false;
+
+    /** Composed temperature (°C) from trilinear-filtered field channels. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float TemperatureC = 0.f;
+
+    /** °C per cm in world space; points toward warmer air. Heat flows along the negated vector. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    FVector GradientCPerCm = FVector::ZeroVector;
+
+    /** Normalized gradient (zero where the field is flat): steer along it toward heat, against it toward cold. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    FVector DirectionToWarmth = FVector::ZeroVector;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FThermoSourcesChanged);
 
+/** Loaded chunks of one partitioned volume, keyed by chunk coordinate for O(1) point lookup. */
+struct FThermoForgeChunkLayer
+{
+    FTransform InvFrame  = FTransform::Identity;
+    float      CellSizeCm = 100.f;
+    int32      ChunkCells = 256;
+    TMap<FIntPoint, TWeakObjectPtr<AThermoForgeFieldChunk>> Chunks;
+};
+
+/**
+ * Composed current-temperature channel of one volume (time-sliced mode).
+ * Cells follow the baked field layout; bricks are refreshed independently.
+ */
+struct FThermoForgeComposedChannel
+{
+    TWeakObjectPtr<const AThermoForgeVolume>      Volume;
+    TWeakObjectPtr<const UThermoForgeFieldAsset>  Field;
+
+    FIntVector Dim      = FIntVector::ZeroValue;
+    FIntVector BrickDim = FIntVector::ZeroValue;
+    int32      BrickSize = 8;
+
+    /** Composed °C per cell. */
+    TArray<float>  TempC;
+
+    /** World time of each brick's last refresh; negative = never composed. */
+    TArray<double> BrickRefreshedAt;
+
+    FORCEINLINE int32 BrickIndex(int32 bx, int32 by, int32 bz) const { return (bz * BrickDim.Y + by) * BrickDim.X + bx; }
+    FORCEINLINE int32 BrickOfCell(int32 x, int32 y, int32 z) const { return BrickIndex(x / BrickSize, y / BrickSize, z / BrickSize); }
+};
+
+/** Clock-derived climate terms for one UTC instant: everything in ambient except the altitude lapse. */
+struct THERMOFORGE_API FThermoForgeClimateTerms
+{
+    FDateTime TimeUTC       = FDateTime(0);
+    float     TimeHours     = 0.f;
+    float     SeasonAlpha01 = 0.f; // 0 deep winter … 1 peak summer
+    float     DiurnalWave   = 0.f; // -1 at 00:00 … 1 at 12:00
+    float     AmbientSeaC   = 0.f; // project climate at sea level
+    FVector   SunDirection  = FVector::UpVector; // world space, toward the sun
+
+    /** Unit vector toward the sun for a local solar time and season (declination ±23.44°, Climate|Sun settings). */
+    static FVector ComputeSunDirection(const UThermoForgeProjectSettings* S, float TimeHours, float SeasonAlpha01);
+
+    /** Seasonal blend, 00:00 trough / 12:00 peak. */
+    static FThermoForgeClimateTerms Compute(const UThermoForgeProjectSettings* S, const FDateTime& TimeUTC);
+
+    /** Ambient (°C) at a world height, project climate. */
+    float AmbientAt(const UThermoForgeProjectSettings* S, float WorldZcm) const;
+
+    /** Ambient (°C) at a world height for a (volume-overridden) climate. */
+    FORCEINLINE float AmbientAt(const FThermoForgeClimate& Climate, float WorldZcm) const
+    {
+        return Climate.AdjustForAltitude(Climate.SeaLevelAmbient(SeasonAlpha01, DiurnalWave), WorldZcm);
+    }
+};
+
+DECLARE_DELEGATE_RetVal(FDateTime, FThermoForgeClockProvider);
+
+/** Which volumes to bake and what to do with the result. */
+struct FThermoForgeBakeOptions
+{
+    /** Volume names or labels; empty = every volume in the world. */
+    TArray<FString> VolumeNames;
+
+    /** Write field assets and assign them to the volumes (editor only). */
+    bool bSaveAssets = true;
+
+    /** Rebuild the heat preview after assigning (skip for headless bakes). */
+    bool bBuildPreview = true;
+
+    /** Spread the bake over the task graph (ANDed with the project's bParallelBake). */
+    bool bParallel = true;
+
+    /**
+     * Bake only z-slab ShardIndex of NumShards per volume. With NumShards > 1 nothing is saved to assets;
+     * each volume's slab is written to ShardDir and MergeBakeShards stitches them back together.
+     */
+    int32   NumShards  = 1;
+    int32   ShardIndex = 0;
+    FString ShardDir;
+};
+
+/** Per-volume bake numbers (for logs and build-farm reports). */
+struct FThermoForgeBakeVolumeStats
+{
+    FString    VolumeName;
+    FString    AssetPath;
+    FIntVector Dim = FIntVector::ZeroValue;
+    int64      NumCells  = 0;
+    int64      NumTraces = 0;
+    int32      OpenBricks  = 0;
+    int32      SolidBricks = 0;
+    double     Seconds = 0.0;
+};
+
+struct FThermoForgeBakeReport
+{
+    FString MapName;
+    TArray<FThermoForgeBakeVolumeStats> Volumes;
+    int64  TotalCells  = 0;
+    int64  TotalTraces = 0;
+    double TotalSeconds = 0.0;
+};
+
+/** Baked channels of one volume before they are written into a field asset. */
+struct FThermoForgeBakedField
+{
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 100.f;
+    FVector    OriginWS = FVector::ZeroVector;
+    FRotator   GridRotation = FRotator::ZeroRotator;
+
+    /** Z-slices [SliceBegin, SliceEnd) held by the channel arrays; a full bake covers [0, Dim.Z). */
+    int32 SliceBegin = 0;
+    int32 SliceEnd   = 0;
+
+    TArray<float> SkyView01;
+    TArray<float> WallPermeability01;
+    TArray<float> Indoorness01;
+    TArray<FVector4f> SunVisibilityL1; // empty without bBakeSunVisibility
+
+    bool IsComplete() const { return SliceBegin == 0 && SliceEnd == Dim.Z; }
+
+    /** Shard file layout (versioned; see SaveBakeShard / LoadBakeShard). */
+    friend FArchive& operator<<(FArchive& Ar, FThermoForgeBakedField& F)
+    {
+        Ar << F.Dim << F.CellSizeCm << F.OriginWS << F.GridRotation << F.SliceBegin << F.SliceEnd;
+        Ar << F.SkyView01 << F.WallPermeability01 << F.Indoorness01 << F.SunVisibilityL1;
+        return Ar;
+    }
+};
+
+/**
+ * Hit density per (component, face material), shared by all trace contexts of a world.
+ * Filled lazily; cleared when physmats, collision setups or the override table are edited.
+ */
+struct THERMOFORGE_API FThermoForgeDensityCache
+{
+    using FKey = TPair<FObjectKey, FObjectKey>;
+
+    bool  Find(const FKey& Key, float& OutDensityKgM3) const;
+    void  Add(const FKey& Key, float DensityKgM3);
+    void  Reset();
+    int32 Num() const;
+
+private:
+    mutable FRWLock Lock;
+    TMap<FKey, float> Map;
+};
+
+/**
+ * Scene-query state reused across many traces on one thread (bake workers, composition).
+ * World, settings, channel and query params are resolved once; the hit result is reused.
+ */
+struct THERMOFORGE_API FThermoForgeTraceContext
+{
+    FThermoForgeTraceContext() = default;
+    FThermoForgeTraceContext(const UWorld* InWorld, const UThermoForgeProjectSettings* InSettings);
+
+    bool IsValid() const { return World && Settings; }
+
+    /** Permeability (0..1) of the first hit along Dir; 1 if nothing within MaxLen. */
+    float AmbientRay01(const FVector& P, const FVector& Dir, float MaxLen);
+
+    /** Occlusion between two points (0..1, 1=open) using physmat density + Beer–Lambert. */
+    float OcclusionBetween(const FVector& A, const FVector& B, float InCellSizeCm);
+
+    /**
+     * Optical depth summed over every solid crossed between A and B (multi-hit mode).
+     * A scene multi-trace only reports the entry hit of each shape, so it supplies entries and densities; exits come
+     * from traces against each entered component alone (forward from inside for meshes, back from B or the next
+     * entry for simple shapes), and further walls of the same mesh are found the same way. Each crossing adds
+     * (exit - entry) in ThicknessRefCm cells; a crossing that never exits runs to B, a face with no measurable
+     * thickness counts one face. At most MaxOcclusionCrossings solids are integrated (per component, in order of
+     * first entry) and integration stops once transmittance falls below TransmittanceEpsilon.
+     */
+    float OpticalDepthBetween(const FVector& A, const FVector& B, float ThicknessRefCm);
+
+    /** Density for a hit, cached per (component, face material) for the lifetime of the context. */
+    float HitDensityKgM3(const FHitResult& InHit);
+
+    /** True if blocking geometry on the trace channel overlaps the (oriented) box. */
+    bool OverlapsBlocking(const FVector& Center, const FQuat& Rot, const FVector& HalfExtent);
+
+    /** True if blocking geometry on the trace channel touches the (oriented) box swept from Start to End. */
+    bool SweepBlocking(const FVector& Start, const FVector& End, const FQuat& Rot, const FVector& HalfExtent);
+
+    /**
+     * True if every point lies inside one simple-collision element of one blocking component overlapping the box.
+     * OutSolid receives that component.
+     */
+    bool PointsInsideOneSolid(TConstArrayView<FVector> Points, const FVector& Center, const FQuat& Rot, const FVector& HalfExtent,
+                              const UPrimitiveComponent** OutSolid = nullptr);
+
+    const UWorld* World = nullptr;
+    const UThermoForgeProjectSettings* Settings = nullptr;
+    ECollisionChannel Channel = ECC_Visibility;
+    FCollisionQueryParams Params;
+    FHitResult Hit;
+    TArray<FOverlapResult> Overlaps;
+
+    /** Thickness reference for ambient rays in multi-hit mode (bake cell size). */
+    float CellSizeCm = 100.f;
+
+    /** Multi-hit entry pass: every blocking response is demoted to overlap so each shape along the ray reports its entry. */
+    FCollisionResponseParams CrossingResponse = FCollisionResponseParams(ECR_Overlap);
+    TArray<FHitResult> CrossingHits;
+
+    /** Context-local densities in front of the world's shared cache. */
+    TMap<TPair<const UPrimitiveComponent*, const UPhysicalMaterial*>, float> DensityCache;
+    TSharedPtr<FThermoForgeDensityCache, ESPMode::ThreadSafe> SharedDensityCache;
+
+    /** Traces / overlap queries issued through this context. */
+    int64 NumTraces   = 0;
+    int64 NumOverlaps = 0;
+
+    /** Density lookups served by either cache / resolved from the physmat. */
+    int64 NumCacheHits   = 0;
+    int64 NumCacheMisses = 0;
+
+    /** Add the counts above to the ThermoForge stat group (once per query or bake, not per ray). */
+    void EmitStats() const;
+};
+
+/**
+ * One refresh pass handed to the background task; field and source inputs are copied so the task never touches UObjects.
+ * The exception is Trace: source occlusion still traces the world from the task, as the synchronous path does.
+ * Scene queries are read-only and lock the physics scene per query, and the subsystem waits for the task before
+ * its world goes away. Trace is invalid (field-only, WallPerm alone) without sources or in deterministic mode.
+ */
+struct FThermoForgeCompositionJob
+{
+    struct FBrick
+    {
+        int32 Channel = INDEX_NONE;
+        int32 Brick   = INDEX_NONE;
+        TArray<int32>   Cells;   // linear cell indices in the channel
+        TArray<FVector> Centers; // world-space cell centers
+        TArray<float>   Sky;
+        TArray<float>   Wall;
+        TArray<FThermoForgeClimate> Climate; // per cell; empty = DefaultClimate
+        TArray<float>   OutTempC;
+        bool bDone = false;
+    };
+
+    TArray<FBrick> Bricks;                        // in priority order
+    TArray<FThermoForgeSourceState> Sources;
+    FThermoForgeClimateTerms Climate;
+    FThermoForgeClimate DefaultClimate;
+    FThermoForgeTraceContext Trace;
+    TSharedPtr<const FThermoForgeWeatherField, ESPMode::ThreadSafe> Weather; // sampled per cell; null = WeatherAlpha01
+    float     WeatherAlpha01 = 0.f;
+    double    WorldTime = 0.0;
+    double    BudgetSeconds = 0.0;
+};
+
 UCLASS()
-class THERMOFORGE_API UThermoForgeSubsystem : public UWorldSubsystem
+class THERMOFORGE_API UThermoForgeSubsystem : public UTickableWorldSubsystem
 {
     GENERATED_BODY()
 public:
     // lifecycle
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
     virtual void Deinitialize() override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    // tick (time-sliced composition)
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
 
     // sources
     void RegisterSource(UThermoForgeSourceComponent* Source);
@@ -62,28 +370,205 @@ public:
     int32 GetSourceCount() const;
     void GetAllSources(TArray<UThermoForgeSourceComponent*>& OutSources) const;
 
+    /** Plain-data copies of all enabled sources, plus replicated proxies on clients (game thread). */
+    void GatherSourceStates(TArray<FThermoForgeSourceState>& OutStates) const;
+
+    // replicated proxies: server sources whose component does not exist on this client
+    void SetReplicatedSource(int32 SourceId, const FThermoForgeSourceState& State);
+    void RemoveReplicatedSource(int32 SourceId);
+
+    /** Server-authoritative state actor (servers spawn it on BeginPlay, clients receive it). */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge")
+    AThermoForgeStateReplicator* GetStateReplicator() const { return StateReplicator.Get(); }
+
+    void SetStateReplicator(AThermoForgeStateReplicator* Replicator) { StateReplicator = Replicator; }
+
     UPROPERTY(BlueprintAssignable, Category="Thermo Forge")
     FThermoSourcesChanged OnSourcesChanged;
 
+    // temperature watches (batched threshold notifications)
+    void RegisterWatch(UThermoForgeWatchComponent* Watch);
+    void UnregisterWatch(UThermoForgeWatchComponent* Watch);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge")
+    int32 GetWatchCount() const { return Watches.Num(); }
+
+    // weather field (AThermoForgeWeatherActor)
+    void RegisterWeather(AThermoForgeWeatherActor* Weather);
+    void UnregisterWeather(AThermoForgeWeatherActor* Weather);
+
+    /** Current weather at a point: the advected field, or DefaultWeatherAlpha01 as cloud cover without a weather actor. */
+    FThermoForgeWeatherSample SampleWeatherAt(const FVector& WorldPos) const;
+
+    /** Solar dimming (0 clear … 1 overcast) at a point, as the "now" queries, snapshots and time-sliced composition see it. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Weather")
+    float GetWeatherAlphaAt(const FVector& WorldPos) const { return SampleWeatherAt(WorldPos).GetWeatherAlpha01(); }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Weather")
+    void GetWeatherAt(const FVector& WorldPos, float& OutCloudCover01, float& OutPrecipitation01) const;
+
+    /** Latest published field (immutable, readable from any thread); null without a weather actor. */
+    TSharedPtr<const FThermoForgeWeatherField, ESPMode::ThreadSafe> GetWeatherField() const { return WeatherField; }
+
+    // streamed field chunks (World Partition)
+    void RegisterFieldChunk(AThermoForgeFieldChunk* Chunk);
+    void UnregisterFieldChunk(AThermoForgeFieldChunk* Chunk);
+
+    /** Loaded chunk whose cells contain the point, or null. */
+    const AThermoForgeFieldChunk* FindFieldChunkAt(const FVector& WorldPos) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Query")
+    int32 GetLoadedFieldChunkCount() const;
+
     // --------- Geometry-only bake ----------
     UFUNCTION(BlueprintCallable, Category="Thermo Forge")
     void KickstartSamplingFromVolumes();
 
+    /** Bake the selected volumes of this world (editor button, Blueprint and the bake commandlet all end up here). */
+    void RunBake(const FThermoForgeBakeOptions& Options, FThermoForgeBakeReport& OutReport);
+
+    /**
+     * Bake one volume's channels (the options' shard slab only) without touching assets.
+     * False if the volume or the slab has no cells.
+     */
+    bool BakeVolume(AThermoForgeVolume* Volume, const FThermoForgeBakeOptions& Options, FThermoForgeBakedField& OutField,
+                    FThermoForgeBakeVolumeStats& OutStats) const;
+
+    /**
+     * Stitch the shard files in Options.ShardDir back into full fields and save them like RunBake does.
+     * Slabs are placed by their slice range, never by file order, so the result matches a single-process bake.
+     * Volumes whose shards are missing, overlapping or from a different grid are skipped with an error.
+     * Returns the number of volumes merged.
+     */
+    int32 MergeBakeShards(const FThermoForgeBakeOptions& Options, FThermoForgeBakeReport& OutReport);
+
+    /** Shard files: <Dir>/<Volume>.<Index>of<Num>.tfshard */
+    static FString GetBakeShardPath(const FString& Dir, const FString& VolumeName, int32 ShardIndex, int32 NumShards);
+    static bool SaveBakeShard(const FString& Path, const FString& VolumeName, FThermoForgeBakedField& Field, FThermoForgeBakeVolumeStats& Stats);
+    static bool LoadBakeShard(const FString& Path, const FString& VolumeName, FThermoForgeBakedField& OutField, FThermoForgeBakeVolumeStats& OutStats);
+
     /** Occlusion between two points (0..1, 1=open) using physmat density + Beer–Lambert. */
     float OcclusionBetween(const FVector& A, const FVector& B, float CellSizeCm) const;
 
+    /** Trace context bound to this world and the project settings; one per thread. */
+    FThermoForgeTraceContext MakeTraceContext() const;
+
+    /** Density (kg/m^3) of a component's simple-collision physmat, with the same fallbacks as a trace hit. */
+    static float GetComponentDensityKgM3(const UPrimitiveComponent* Component, const UThermoForgeProjectSettings* S);
+
+    /** Drop cached hit densities (done automatically on physmat / settings edits in the editor). */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge")
+    void ClearDensityCache();
+
     // --------- Queries / Composition ----------
     /** Compose current temperature (°C) at world position using baked geometry + runtime climate + dynamic sources. */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Query")
     float ComputeCurrentTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const;
 
-    /** Find nearest baked grid point; also fills CurrentTempC using default preview knobs. */
+    /** Find nearest baked grid point; also fills CurrentTempC with the current weather field at the cell. */
     UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
     FThermoForgeGridHit QueryNearestBakedGridPoint(const FVector& WorldLocation, const FDateTime& QueryTimeUTC) const;
 
+    /**
+     * Temperature plus gradient in one pass: field channels are differentiated through the trilinear filter,
+     * point sources through their falloff in closed form and the ambient through the altitude lapse.
+     * Source occlusion is taken as constant around the point. Values are trilinear, so they can differ slightly
+     * from ComputeCurrentTemperatureAt, which reads the nearest cell.
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Query")
+    FThermoForgeTemperatureGradient SampleTemperatureGradient(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const;
+
+    /** "Now" is the thermal clock (GetQueryTimeUTC), sampled once per tick (see GetQueryTimeUTC for worlds that do not tick). */
     UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
     FThermoForgeGridHit QueryNearestBakedGridPointNow(const FVector& WorldLocation) const;
 
+    // thermal clock (Runtime|Clock in project settings)
+    /** Jump the clock (any mode; Real Time resumes from the wall clock at the next tick or query unless deterministic). */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Clock")
+    void SetSimulationTimeUTC(const FDateTime& TimeUTC);
+
+    /** Advance the clock by a fixed step (whole milliseconds, so repeated steps do not drift). */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Clock")
+    void AdvanceSimulationTime(float Seconds);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Clock")
+    FDateTime GetSimulationTimeUTC() const { return GetClimateTerms().TimeUTC; }
+
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Clock")
+    void SetClockMode(EThermoClockMode InMode, float InTimeScale = 1.f);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Clock")
+    EThermoClockMode GetClockMode() const { return ClockMode; }
+
+    /** Hours since midnight and season (0 winter … 1 summer) of the clock this tick. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Clock")
+    void GetClockClimate(float& OutTimeHours, float& OutSeasonAlpha01) const { OutTimeHours = GetClimateTerms().TimeHours; OutSeasonAlpha01 = GetClimateTerms().SeasonAlpha01; }
+
+    /** External mode: polled once per tick when bound (e.g. the server's replicated world time). */
+    FThermoForgeClockProvider ClockProvider;
+
+    /**
+     * Instant used by the "now" queries, snapshots and time-sliced composition. In non-deterministic Real Time mode
+     * the wall clock is re-read when the cached terms are a second or more behind it, so worlds that do not tick
+     * (editor worlds outside PIE) still follow the wall clock.
+     */
+    FDateTime GetQueryTimeUTC() const { return GetClimateTerms().TimeUTC; }
+
+    /** Terms cached for this tick's clock (refreshed as for GetQueryTimeUTC). Game thread. */
+    const FThermoForgeClimateTerms& GetClimateTerms() const;
+
+    /**
+     * Read the composed channel (time-sliced mode only).
+     * Returns false if the mode is off, no volume contains the point, or its brick has not been composed yet.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
+    bool SampleComposedTemperatureAt(const FVector& WorldPos, float& OutTempC) const;
+
+    /**
+     * Batched composition for the first Count cells of a field (linear order), evaluated in parallel.
+     * Reads the field directly instead of searching volumes per cell.
+     */
+    void ComputeFieldTemperatures(const UThermoForgeFieldAsset* Field, int32 Count, bool bWinter, float TimeHours,
+                                  float WeatherAlpha01, TArray<float>& OutTempC) const;
+
+    /** Same for a subset of cells (linear indices); OutTempC follows Cells. */
+    void ComputeFieldCellTemperatures(const UThermoForgeFieldAsset* Field, TConstArrayView<int32> Cells, bool bWinter, float TimeHours,
+                                      float WeatherAlpha01, TArray<float>& OutTempC) const;
+
+    /** Batched composition at arbitrary points with pre-sampled field values, evaluated in parallel (project climate). */
+    void ComputeTemperaturesAt(TConstArrayView<FVector> Points, TConstArrayView<float> Sky, TConstArrayView<float> WallPerm,
+                               bool bWinter, float TimeHours, float WeatherAlpha01, TArray<float>& OutTempC) const;
+
+    /** Ambient (°C) for a UTC instant: seasonal blend, 00:00 trough / 12:00 peak, altitude adjusted. The member reuses the tick's cached terms at the clock's instant. */
+    float ComputeAmbientForUTC(const FDateTime& TimeUTC, float WorldZcm) const;
+    static float ComputeAmbientForUTC(const UThermoForgeProjectSettings* S, const FDateTime& TimeUTC, float WorldZcm);
+
+    /** Ambient + solar + attenuated sources for already-sampled field values. Safe off the game thread. */
+    float ComposeTemperature(const FVector& WorldPos, float Sky, float WallPerm, float AmbientC, float WeatherAlpha01,
+                             TConstArrayView<FThermoForgeSourceState> Sources, const FThermoForgeClimate* Climate = nullptr) const;
+
+    /**
+     * Same, with source occlusion traced through TraceContext; null skips the traces (wall permeability only).
+     * Climate is the cell's (volume-overridden) climate for the solar term; null = project settings.
+     */
+    static float ComposeTemperature(const UThermoForgeProjectSettings* S, FThermoForgeTraceContext* TraceContext, const FVector& WorldPos,
+                                    float Sky, float WallPerm, float AmbientC, float WeatherAlpha01,
+                                    TConstArrayView<FThermoForgeSourceState> Sources, const FThermoForgeClimate* Climate = nullptr);
+
+    // --------- Thread-safe query snapshot ----------
+    /**
+     * Latest published snapshot; callable from any thread (a shared read lock around one pointer copy). The returned
+     * pointer keeps that snapshot alive, so take a fresh one per task instead of holding it across frames. Null before the first tick or
+     * with bPublishQuerySnapshot off.
+     */
+    TSharedPtr<const FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> AcquireSnapshot() const;
+
+    /** Build and publish a snapshot now (game thread); Tick does this every frame. */
+    void PublishSnapshot();
+
+    /** Build a snapshot of the current state without publishing it (game thread). */
+    TSharedRef<FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> BuildSnapshot();
+
 private:
     // helpers
     float TraceAmbientRay01(const FVector& P, const FVector& Dir, float MaxLen) const;
@@ -93,16 +578,129 @@ private:
         const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01);
 
     bool ComputeNearestInVolume(const AThermoForgeVolume* Vol, const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const;
+    static bool ComputeNearestInField(const UThermoForgeFieldAsset* Field, const FVector& WorldLocation, FThermoForgeGridHit& OutHit);
     bool VolumeContainsPoint(const AThermoForgeVolume* Vol, const FVector& WorldLocation) const;
 
+    /** Nearest baked cell, preferring volumes that contain the point. No composition. */
+    bool FindNearestBakedGridPoint(const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const;
+
+    /** One field cell composed with its baked climate; shared by the batched field passes. */
+    float ComposeFieldCell(const UThermoForgeFieldAsset* Field, int32 Linear, bool bWinter, float TimeHours, const FVector& SunDir,
+                           float WeatherAlpha01, TConstArrayView<FThermoForgeSourceState> Sources) const;
+
+    /**
+     * Bake pre-pass over BakeBrickSize bricks. Bricks with no blocking geometry within one cell get Wall=1,
+     * and Sky=1 if the brick swept SkyReachCm along every sky direction hits nothing either; bricks buried in a
+     * single solid take that solid's one-cell transmittance for both channels.
+     * Sky, Wall and OutCellFlags cover slices [SliceBegin, SliceEnd) only; resolved cells are flagged in OutCellFlags.
+     * Returns the number of fully open / solid bricks.
+     */
+    void ClassifyBakeBricks(const FTransform& Frame, const FIntVector& CellMin, const FIntVector& Dim, float Cell,
+                            TConstArrayView<FVector> SkyDirs, float SkyReachCm, int32 SliceBegin, int32 SliceEnd, bool bParallel,
+                            TArray<float>& Sky, TArray<float>& Wall, TArray<uint8>& OutCellFlags, int32& OutOpen, int32& OutSolid) const;
+
+    /** Volume filter shared by RunBake and MergeBakeShards. */
+    static bool IsVolumeSelected(const AThermoForgeVolume* Volume, const FThermoForgeBakeOptions& Options);
+
+#if WITH_EDITOR
+    /** Save a complete field to its asset and point the volume at it (or split it into chunks, see bStreamWithWorldPartition). */
+    void ApplyBakedField(AThermoForgeVolume* Volume, const FThermoForgeBakedField& Field, const FThermoForgeBakeOptions& Options,
+                         FThermoForgeBakeVolumeStats& Stats) const;
+
+    /** Write one field asset + AThermoForgeFieldChunk per FieldChunkSizeCm column; replaces the volume's loaded chunks. */
+    void WriteFieldChunks(AThermoForgeVolume* Volume, const FThermoForgeBakedField& Field, const TArray<uint32>& ClimateBlend,
+                          const TArray<TObjectPtr<UThermoForgeClimateProfile>>& ClimatePalette, FThermoForgeBakeVolumeStats& Stats) const;
+
+    /**
+     * Per-cell climate blend of a field against every volume with a ClimateProfile: the two strongest of
+     * {project climate, overlapping profiles}, packed with FThermoForgeClimate::PackBlend. Empty if nothing overlaps.
+     */
+    void ComputeClimateBlend(const FThermoForgeBakedField& Field, TArray<uint32>& OutBlend,
+                             TArray<TObjectPtr<UThermoForgeClimateProfile>>& OutPalette) const;
+#endif
+
+    // time-sliced composition
+    void SyncComposedChannels();
+    void ApplyCompletedComposition();
+    void ScheduleComposition();
+    static void RunCompositionJob(const UThermoForgeSubsystem* Self, FThermoForgeCompositionJob& Job);
+    bool ReadComposedCell(const FVector& WorldPos, FThermoForgeGridHit& OutHit) const;
+
+    // weather: advect the published field in a task, publish the result next tick
+    void UpdateWeather(float DeltaTime, const UThermoForgeProjectSettings* S);
+
+    // watches: gather on the game thread, evaluate against a snapshot in a task, fire delegates next tick
+    void UpdateWatches(float DeltaTime, const UThermoForgeProjectSettings* S);
+
+    // query snapshot
+    struct FCachedFieldSnapshot;
+    /** Cached channel copy of a field (rebuilt on a new data revision); entries used this publish move to InUse. */
+    TSharedPtr<const FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> GetFieldSnapshot(const UThermoForgeFieldAsset* Field,
+                                                                                   TMap<FObjectKey, FCachedFieldSnapshot>& InUse);
+
 #if WITH_EDITOR
-    UThermoForgeFieldAsset* CreateAndSaveFieldAsset(AThermoForgeVolume* Volume, const FIntVector& Dim, float Cell, const FVector& FieldOriginWS, const FRotator& GridRotation,
-                                                    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01) const;
+    UThermoForgeFieldAsset* CreateAndSaveFieldAsset(const FString& PackageName, const FIntVector& Dim, float Cell, const FVector& FieldOriginWS, const FRotator& GridRotation,
+                                                    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01,
+                                                    const TArray<FVector4f>& SunVisibilityL1, const TArray<uint32>& ClimateBlend, const TArray<TObjectPtr<UThermoForgeClimateProfile>>& ClimatePalette) const;
 #endif
 
     void CompactSources();
     const UThermoForgeProjectSettings* GetSettings() const;
 
+#if WITH_EDITOR
+    void HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event);
+    FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+
     // data
     TSet<TWeakObjectPtr<UThermoForgeSourceComponent>> SourceSet;
+
+    TMap<int32, FThermoForgeSourceState> ReplicatedSources;
+
+    // thermal clock
+    void AdvanceClock(float DeltaTime, const UThermoForgeProjectSettings* S);
+    EThermoClockMode ClockMode = EThermoClockMode::RealTime;
+    float ClockTimeScale = 1.f;
+    mutable FThermoForgeClimateTerms ClockTerms;
+    TWeakObjectPtr<AThermoForgeStateReplicator> StateReplicator;
+
+    TMap<FName, FThermoForgeChunkLayer> ChunkLayers;
+
+    TSharedPtr<FThermoForgeDensityCache, ESPMode::ThreadSafe> DensityCache;
+
+    TArray<FThermoForgeComposedChannel> ComposedChannels;
+    TSharedPtr<FThermoForgeCompositionJob, ESPMode::ThreadSafe> PendingComposition;
+    UE::Tasks::FTask PendingCompositionTask;
+
+    /** Readers copy PublishedSnapshot under a read lock; the copy is their pin, so a replaced snapshot lives until its last reader lets go. */
+    mutable FRWLock SnapshotLock;
+    TSharedPtr<const FThermoForgeWorldSnapshot, ESPMode::ThreadSafe> PublishedSnapshot;
+
+    /** Channel copies per field asset, reused while the asset's data revision is unchanged. */
+    struct FCachedFieldSnapshot
+    {
+        uint32 Revision = 0;
+        TSharedPtr<const FThermoForgeFieldSnapshot, ESPMode::ThreadSafe> Snapshot;
+    };
+    TMap<FObjectKey, FCachedFieldSnapshot> FieldSnapshots;
+
+    struct FWatchPass
+    {
+        TArray<TWeakObjectPtr<UThermoForgeWatchComponent>> Watches;
+        TArray<FVector> Points;
+        TArray<float>   TempC;
+    };
+    TArray<TWeakObjectPtr<UThermoForgeWatchComponent>> Watches;
+    TSharedPtr<FWatchPass, ESPMode::ThreadSafe> PendingWatchPass;
+    UE::Tasks::FTask PendingWatchTask;
+    float WatchAccumulator = 0.f;
+
+    TWeakObjectPtr<AThermoForgeWeatherActor> WeatherActor;
+    TSharedPtr<const FThermoForgeWeatherField, ESPMode::ThreadSafe> WeatherField;
+    TSharedPtr<FThermoForgeWeatherField, ESPMode::ThreadSafe> PendingWeather;
+    UE::Tasks::FTask PendingWeatherTask;
+    float WeatherAccumulator = 0.f;
+
+    /** Deterministic mode: thermal-clock instant the weather field has been stepped to. */
+    FDateTime WeatherClockUTC;
 };
@@ -3,14 +3,17 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Volume.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Materials/MaterialInterface.h" 
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Components/BoxComponent.h"
 #include "Engine/World.h"
+#include "ThermoForgeFieldAsset.h"
 
 #include "ThermoForgeVolume.generated.h"
 
-class UThermoForgeFieldAsset;
+class UVolumeTexture;
+struct FThermoPreviewCell;
 
 UENUM(BlueprintType)
 enum class EThermoGridOriginMode : uint8
@@ -27,6 +30,22 @@ enum class EThermoGridOrientationMode : uint8
     ActorRotation UMETA(DisplayName="Actor Rotation")
 };
 
+UENUM(BlueprintType)
+enum class EThermoPreviewCulling : uint8
+{
+    AllCells     UMETA(DisplayName="All Cells"),
+    CameraRadius UMETA(DisplayName="Near Camera"),
+    SlicePlane   UMETA(DisplayName="Slice Plane")
+};
+
+UENUM(BlueprintType)
+enum class EThermoPreviewSliceAxis : uint8
+{
+    X UMETA(DisplayName="Grid X"),
+    Y UMETA(DisplayName="Grid Y"),
+    Z UMETA(DisplayName="Grid Z")
+};
+
 UCLASS(HideCategories=(Collision, Input, HLOD, Cooking, Replication, Rendering, Actor, LOD))
 class THERMOFORGE_API AThermoForgeVolume : public AVolume
 {
@@ -37,6 +56,8 @@ public:
 
     virtual void BeginPlay() override;
     virtual void OnConstruction(const FTransform& Transform) override;
+    virtual void Tick(float DeltaSeconds) override;
+    virtual bool ShouldTickIfViewportsOnly() const override;
 
     UPROPERTY(EditAnywhere, Blueprintable, Category="A Thermo Forge Volume|Field")
     TSoftObjectPtr<UThermoForgeFieldAsset> BakedFieldRef;
@@ -91,9 +112,61 @@ public:
     UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview")
     UMaterialInterface* GridPreviewMaterial = nullptr;
 
+    /** Which cells the heat preview emits. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview")
+    EThermoPreviewCulling PreviewCulling = EThermoPreviewCulling::AllCells;
+
+    /** Cells farther than this from the editor camera are skipped. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview", meta=(EditCondition="PreviewCulling==EThermoPreviewCulling::CameraRadius", ClampMin="100.0", Units="cm"))
+    float PreviewCameraRadiusCm = 10000.f;
+
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview", meta=(EditCondition="PreviewCulling==EThermoPreviewCulling::SlicePlane"))
+    EThermoPreviewSliceAxis PreviewSliceAxis = EThermoPreviewSliceAxis::Z;
+
+    /** Slice position along the axis, relative to the volume center (grid space). */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview", meta=(EditCondition="PreviewCulling==EThermoPreviewCulling::SlicePlane", Units="cm"))
+    float PreviewSliceOffsetCm = 0.f;
+
+    /** Coarsen distant cells using the field's mip chain. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview")
+    bool bPreviewUseLOD = false;
+
+    /** Full resolution within this camera distance; every doubling beyond it coarsens one level. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview", meta=(EditCondition="bPreviewUseLOD", ClampMin="100.0", Units="cm"))
+    float PreviewLODDistanceCm = 3000.f;
+
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview", meta=(EditCondition="bPreviewUseLOD", ClampMin="1", ClampMax="8"))
+    int32 PreviewMaxLOD = 4;
+
+    /** Render the preview through a hierarchical ISM (per-cluster culling) instead of a flat ISM. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview")
+    bool bUseHierarchicalPreview = false;
+
+    /**
+     * Render the heat preview as one box whose material samples volume textures, instead of one instance per cell.
+     * The material composes field-only heat from TF_SkyView and TF_Climate (no sources, no CPU composition).
+     * Needs VolumeTexturePreviewMaterial; the plugin ships none, so without one the instanced preview is used.
+     */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview")
+    bool bUseVolumeTexturePreview = false;
+
+    /** Material for the volume-texture preview; receives the parameters listed on ApplyFieldTextureParameters. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview", meta=(EditCondition="bUseVolumeTexturePreview"))
+    UMaterialInterface* VolumeTexturePreviewMaterial = nullptr;
+
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Preview")
+    EThermoFieldTextureFormat FieldTextureFormat = EThermoFieldTextureFormat::R8;
+
+    /** Composed temperature, normalized to the preview range (-100..100 °C), one texel per cell. */
+    UPROPERTY(Transient, BlueprintReadOnly, Category="A Thermo Forge Volume|Preview")
+    UVolumeTexture* HeatVolumeTexture = nullptr;
+
     UPROPERTY(Transient)
     UInstancedStaticMeshComponent* GridPreviewISM = nullptr;
 
+    UPROPERTY(Transient)
+    UHierarchicalInstancedStaticMeshComponent* GridPreviewHISM = nullptr;
+
     UPROPERTY(Transient)
     UMaterialInstanceDynamic* HeatPreviewMID = nullptr;
 
@@ -101,6 +174,36 @@ public:
     UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Field")
     UThermoForgeFieldAsset* BakedField = nullptr;
 
+    /**
+     * In World Partition maps, bake into AThermoForgeFieldChunk actors (one field asset per chunk) instead of
+     * one field asset, so only the loaded area is resident. Meant for bUnbounded / very large volumes.
+     */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Field")
+    bool bStreamWithWorldPartition = false;
+
+    /** Chunk edge length; match (or divide) the runtime grid's cell size so each chunk lands in one cell. */
+    UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume|Field", meta=(EditCondition="bStreamWithWorldPartition", ClampMin="1000.0", Units="cm"))
+    float FieldChunkSizeCm = 25600.f;
+
+    // -------- Climate --------
+    /**
+     * Climate inside this box instead of the project climate. Baked into every overlapping field as per-cell blend
+     * weights, so rebake the fields this volume overlaps after changing it.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="A Thermo Forge Volume|Climate")
+    TObjectPtr<UThermoForgeClimateProfile> ClimateProfile = nullptr;
+
+    /** Transition band inside the side faces: the override ramps from 0 at the face to full weight this far in. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="A Thermo Forge Volume|Climate", meta=(ClampMin="0.0", Units="cm"))
+    float ClimateBlendDistanceCm = 1000.f;
+
+    /** Also fade at the top and bottom faces; off keeps full weight over the whole height (the altitude lapse already varies with Z). */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="A Thermo Forge Volume|Climate")
+    bool bClimateBlendVertical = false;
+
+    /** Override weight at a world point (0 outside, 1 deeper than ClimateBlendDistanceCm); 0 without a profile. */
+    float GetClimateWeightAt(const FVector& WorldPos) const;
+
     // -------- Runtime helpers --------
     FBox        GetWorldBounds() const;
     float       GetEffectiveCellSize() const;
@@ -117,6 +220,31 @@ public:
     UFUNCTION(BlueprintCallable, Category="A Thermo Forge Volume|Preview")
     void BuildHeatPreviewFromField();
 
+    /** Shows/hides the active preview component; the inactive one is always hidden. */
+    UFUNCTION(BlueprintCallable, Category="A Thermo Forge Volume|Preview")
+    void SetPreviewVisibility(bool bVisible);
+
+    /**
+     * Compose the whole field with the preview knobs (sources and occlusion traces included, on the CPU) and upload it
+     * into HeatVolumeTexture. Not used by the volume-texture preview; for materials that want the full composition.
+     */
+    UFUNCTION(BlueprintCallable, Category="A Thermo Forge Volume|Preview")
+    void BuildFieldTextures();
+
+    /**
+     * Bind field textures and the grid frame to a material (preview, heat haze, thermal vision post-process).
+     * Textures: TF_Heat (only after BuildFieldTextures; TF_HasHeat = 1), TF_SkyView, TF_WallPerm, TF_Indoor.
+     * Vectors:  TF_GridOrigin, TF_GridAxisX/Y/Z (world axes of the grid), TF_GridInvSize (1 / extent in cm), TF_TempRange (min, max °C),
+     *           TF_Climate (sea-level ambient °C, lapse °C per cm, solar °C at SkyView 1, sea level Z) for the preview knobs.
+     * UVW = dot(WorldPos - TF_GridOrigin, TF_GridAxisN) * TF_GridInvSize.N
+     * Field-only heat = TF_Climate.x + TF_Climate.y * (WorldPos.z - TF_Climate.w) + TF_Climate.z * SkyView
+     */
+    UFUNCTION(BlueprintCallable, Category="A Thermo Forge Volume|Preview")
+    void ApplyFieldTextureParameters(UMaterialInstanceDynamic* MID);
+
+    /** ISM or HISM, depending on bUseHierarchicalPreview. */
+    UInstancedStaticMeshComponent* GetPreviewComponent() const;
+
 #if WITH_EDITOR
     virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
@@ -129,4 +257,12 @@ private:
     void        ApplyBasePreviewMaterialIfNeeded();
     void        ApplyHeatMaterialIfPossible();
     static float ClampVisualGap(float Cell, float Gap);
+
+    void        BuildVolumeTexturePreview();
+    bool        UsesVolumeTexturePreview() const;
+    bool        UsesViewDependentPreview() const;
+    FVector     GetPreviewViewLocation() const;
+    void        GatherHeatPreviewCells(const FVector& ViewLocation, TArray<FThermoPreviewCell>& OutCells) const;
+
+    FVector     LastPreviewViewLocation = FVector(TNumericLimits<float>::Max());
 };
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ThermoForgeWatchComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class EThermoWatchZone : uint8
+{
+    Normal UMETA(DisplayName="Normal"),
+    Hot    UMETA(DisplayName="Overheating"),
+    Cold   UMETA(DisplayName="Freezing")
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FThermoWatchZoneChanged, EThermoWatchZone, NewZone, EThermoWatchZone, OldZone, float, TemperatureC);
+
+/**
+ * Temperature watch: the subsystem samples every registered watch in one batched pass
+ * (Runtime|Watches rate in project settings) and fires OnZoneChanged only when a threshold is crossed.
+ * Replaces per-tick polling of QueryNearestBakedGridPointNow.
+ *
+ * Hot is entered at HotThresholdC and left below HotThresholdC - HysteresisC; Cold is entered at
+ * ColdThresholdC and left above ColdThresholdC + HysteresisC. Watches register on BeginPlay.
+ */
+UCLASS(ClassGroup=(ThermoForge), BlueprintType, Blueprintable, meta=(BlueprintSpawnableComponent))
+class THERMOFORGE_API UThermoForgeWatchComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeWatchComponent();
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Watch")
+    bool bWatchEnabled = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Watch")
+    float HotThresholdC = 40.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Watch")
+    float ColdThresholdC = 0.f;
+
+    /** Band that must be crossed back before a zone is left again (prevents flicker at the edge). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Watch", meta=(ClampMin="0.0"))
+    float HysteresisC = 1.f;
+
+    /** Sample point relative to the owner (in owner space). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Watch")
+    FVector LocationOffset = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintAssignable, Category="Thermo Watch")
+    FThermoWatchZoneChanged OnZoneChanged;
+
+    UFUNCTION(BlueprintPure, Category="Thermo Watch")
+    EThermoWatchZone GetZone() const { return Zone; }
+
+    /** Temperature from the last batched pass (°C). */
+    UFUNCTION(BlueprintPure, Category="Thermo Watch")
+    float GetLastTemperatureC() const { return LastTemperatureC; }
+
+    /** Position provider; override for sockets, feet, or anything that is not the owner's location. */
+    virtual FVector GetWatchLocation() const;
+
+    /** Feed one batched sample; fires OnZoneChanged on a crossing (subsystem, game thread). */
+    void ApplyTemperature(float TemperatureC);
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    EThermoWatchZone Zone = EThermoWatchZone::Normal;
+    float LastTemperatureC = 0.f;
+};
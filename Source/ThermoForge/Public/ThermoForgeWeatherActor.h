@@ -0,0 +1,90 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "GameFramework/Actor.h"
+#include "ThermoForgeWeatherField.h"
+#include "ThermoForgeWeatherActor.generated.h"
+
+/** A cloud bank or storm cell, placed relative to the weather actor. Also the row type of FrontTable. */
+USTRUCT(BlueprintType)
+struct FThermoForgeWeatherFront : public FTableRowBase
+{
+    GENERATED_BODY()
+
+    /** Center relative to the weather actor (world XY, cm). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Weather Front")
+    FVector2D OffsetCm = FVector2D::ZeroVector;
+
+    /** Full strength inside half the radius, fading out at the radius. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Weather Front", meta=(ClampMin="100", Units="cm"))
+    float RadiusCm = 200000.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Weather Front", meta=(ClampMin="0", ClampMax="1"))
+    float CloudCover01 = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Weather Front", meta=(ClampMin="0", ClampMax="1"))
+    float Precipitation01 = 0.5f;
+};
+
+/**
+ * Drives the subsystem's weather field: a Resolution grid of CellSizeCm cells centered on the actor, seeded with
+ * Fronts and FrontTable rows on BeginPlay and advected by WindCmPerSec on a worker (Runtime|Weather rate in
+ * project settings). Composition samples it per query instead of one WeatherAlpha01 for the whole world.
+ * One per world; a second one replaces the first.
+ */
+UCLASS(HideCategories=(Collision, Input, HLOD, Cooking, Replication, Rendering, LOD))
+class THERMOFORGE_API AThermoForgeWeatherActor : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AThermoForgeWeatherActor();
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Forge Weather", meta=(ClampMin="2", ClampMax="512"))
+    FIntPoint Resolution = FIntPoint(64, 64);
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Forge Weather", meta=(ClampMin="100", Units="cm"))
+    float CellSizeCm = 10000.f;
+
+    /** Weather outside the grid, blown in from upwind and relaxed toward everywhere. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Forge Weather", meta=(ClampMin="0", ClampMax="1"))
+    float BackgroundCloudCover01 = 0.3f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Forge Weather", meta=(ClampMin="0", ClampMax="1"))
+    float BackgroundPrecipitation01 = 0.f;
+
+    /** World XY wind; read at every advection step. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Forge Weather")
+    FVector2D WindCmPerSec = FVector2D(500.f, 0.f);
+
+    /** E-folding time for fronts to dissolve into the background (0 = they only leave by wind). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Thermo Forge Weather", meta=(ClampMin="0", Units="Minutes"))
+    float RelaxationMinutes = 60.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Forge Weather")
+    TArray<FThermoForgeWeatherFront> Fronts;
+
+    /** Extra initial fronts (row struct FThermoForgeWeatherFront). */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Thermo Forge Weather", meta=(RequiredAssetDataTags="RowStructure=/Script/ThermoForge.ThermoForgeWeatherFront"))
+    TObjectPtr<UDataTable> FrontTable = nullptr;
+
+    /** Blend a front into the field at the next advection step. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge Weather")
+    void AddFront(const FThermoForgeWeatherFront& Front);
+
+    /** Grid at the actor's location with Fronts and FrontTable stamped in. */
+    FThermoForgeWeatherField MakeInitialField() const;
+
+    /** Fronts added since the last step, in world space (subsystem, game thread). */
+    void TakePendingStamps(TArray<FThermoForgeWeatherStamp>& OutStamps);
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    FThermoForgeWeatherStamp ToStamp(const FThermoForgeWeatherFront& Front) const;
+
+    TArray<FThermoForgeWeatherFront> PendingFronts;
+};
@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/** Weather at one point. */
+struct FThermoForgeWeatherSample
+{
+    float CloudCover01    = 0.f;
+    float Precipitation01 = 0.f;
+
+    /** Solar dimming fed to composition as WeatherAlpha01; rain implies an overcast sky. */
+    FORCEINLINE float GetWeatherAlpha01() const { return FMath::Max(CloudCover01, Precipitation01); }
+
+    /** Ambient shift (°C) from evaporative cooling under precipitation. */
+    FORCEINLINE float GetAmbientOffsetC(float PrecipitationCoolingC) const { return -PrecipitationCoolingC * Precipitation01; }
+};
+
+/** A front to blend into the field: full Value inside half the radius, smooth falloff to the edge. */
+struct FThermoForgeWeatherStamp
+{
+    FVector2D                 CenterXY = FVector2D::ZeroVector;
+    float                     RadiusCm = 0.f;
+    FThermoForgeWeatherSample Value;
+};
+
+/**
+ * Low-resolution 2D weather over world XY (cloud cover, precipitation), fixed in the world.
+ * Published immutable by the subsystem and replaced by each advection step, so any thread can sample it.
+ * Outside the grid, and as upwind inflow, the weather is Background.
+ */
+struct THERMOFORGE_API FThermoForgeWeatherField
+{
+    FVector2D Origin     = FVector2D::ZeroVector; // world XY of the grid's min corner
+    float     CellSizeCm = 10000.f;
+    FIntPoint Dim        = FIntPoint::ZeroValue;
+    FThermoForgeWeatherSample Background;
+
+    TArray<float> CloudCover01;
+    TArray<float> Precipitation01;
+
+    void Init(const FVector2D& InOrigin, const FIntPoint& InDim, float InCellSizeCm, const FThermoForgeWeatherSample& InBackground);
+
+    bool IsValid() const
+    {
+        return Dim.X > 0 && Dim.Y > 0 && CellSizeCm > 0.f && CloudCover01.Num() == Dim.X * Dim.Y && Precipitation01.Num() == Dim.X * Dim.Y;
+    }
+
+    /** Bilinear between cell centers; cells past the edge read as Background. */
+    FThermoForgeWeatherSample Sample(const FVector2D& WorldXY) const;
+    FORCEINLINE FThermoForgeWeatherSample Sample(const FVector& WorldPos) const { return Sample(FVector2D(WorldPos)); }
+
+    void Stamp(const FThermoForgeWeatherStamp& Front);
+
+    /**
+     * One semi-Lagrangian step: every cell pulls the weather from upwind (Wind * Dt back), then relaxes toward
+     * Background by RelaxAlpha01. Out takes In's layout.
+     */
+    static void Advect(const FThermoForgeWeatherField& In, const FVector2D& WindCmPerSec, float DtSeconds, float RelaxAlpha01,
+                       FThermoForgeWeatherField& Out);
+
+private:
+    FORCEINLINE FThermoForgeWeatherSample Fetch(int32 x, int32 y) const
+    {
+        if (x < 0 || y < 0 || x >= Dim.X || y >= Dim.Y) return Background;
+        const int32 i = y * Dim.X + x;
+        return { CloudCover01[i], Precipitation01[i] };
+    }
+};
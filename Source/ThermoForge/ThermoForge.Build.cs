@@ -28,6 +28,8 @@ public class ThermoForge : ModuleRules
 				"Core",
 				"CoreUObject",
 				"Engine",
+				"NavigationSystem",
+				"NetCore",
 			}
 
 			);
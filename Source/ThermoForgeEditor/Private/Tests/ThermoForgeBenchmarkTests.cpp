@@ -0,0 +1,72 @@
+﻿#include "ThermoForgeBenchmarkCommandlet.h"
+
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Automation front end of the ThermoForgeBenchmark suite (headless with -nullrhi):
+ *
+ *   UnrealEditor-Cmd <Project>.uproject -ExecCmds="Automation RunTests ThermoForge.Benchmark; Quit" -nullrhi -unattended
+ *       [-Cells= -Sources= -Queries= -BakeCells= -Obstacles= -Seed=] [-Label=<commit>]
+ *
+ * Each test writes Saved/ThermoForge/BenchmarkTest.<Name>.json next to the commandlet's output.
+ */
+namespace ThermoForgeBenchmarkTests
+{
+    using FBenchmark = UThermoForgeBenchmarkCommandlet;
+
+    static bool RunAndReport(FAutomationTestBase& Test, const FString& Name, const FBenchmark::FConfig& Config)
+    {
+        TArray<FBenchmark::FResult> Results;
+        if (!FBenchmark::RunSuite(Config, Results))
+        {
+            Test.AddError(TEXT("Could not create the benchmark world"));
+            return false;
+        }
+
+        for (const FBenchmark::FResult& R : Results)
+        {
+            Test.TestTrue(FString::Printf(TEXT("%s did work"), *R.Name), R.Iterations > 0);
+            Test.AddInfo(FString::Printf(TEXT("%-28s %10lld ops %9.2f ms %10.1f ns/op"),
+                                         *R.Name, R.Iterations, R.Seconds * 1000.0, R.NsPerOp()));
+        }
+
+        FString Label;
+        if (!FParse::Value(FCommandLine::Get(), TEXT("Label="), Label))
+            Label = TEXT("automation");
+
+        const FString Path = FPaths::ProjectSavedDir() / FString::Printf(TEXT("ThermoForge/BenchmarkTest.%s.json"), *Name);
+        return Test.TestTrue(TEXT("Results written"), FBenchmark::WriteResults(Path, Label, Config, Results));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeBenchmarkQueriesTest, "ThermoForge.Benchmark.Queries",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FThermoForgeBenchmarkQueriesTest::RunTest(const FString& Parameters)
+{
+    ThermoForgeBenchmarkTests::FBenchmark::FConfig Config;
+    Config.Parse(FCommandLine::Get());
+    Config.BakeCells = 0;
+    Config.NumQueries = FMath::Max(1, Config.NumQueries);
+
+    return ThermoForgeBenchmarkTests::RunAndReport(*this, TEXT("Queries"), Config);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeBenchmarkBakeTest, "ThermoForge.Benchmark.Bake",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FThermoForgeBenchmarkBakeTest::RunTest(const FString& Parameters)
+{
+    ThermoForgeBenchmarkTests::FBenchmark::FConfig Config;
+    Config.Parse(FCommandLine::Get());
+    Config.NumQueries = 0;
+    Config.BakeCells  = FMath::Max(2, Config.BakeCells);
+
+    return ThermoForgeBenchmarkTests::RunAndReport(*this, TEXT("Bake"), Config);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
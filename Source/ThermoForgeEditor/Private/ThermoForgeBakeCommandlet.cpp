@@ -0,0 +1,285 @@
+﻿#include "ThermoForgeBakeCommandlet.h"
+
+#include "ThermoForgeSubsystem.h"
+#include "ThermoForgeStats.h"
+
+#include "Editor.h"
+#include "Engine/World.h"
+#include "FileHelpers.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+UThermoForgeBakeCommandlet::UThermoForgeBakeCommandlet()
+{
+    IsClient        = false;
+    IsServer        = false;
+    IsEditor        = true;
+    LogToConsole    = true;
+    ShowErrorCount  = true;
+}
+
+int32 UThermoForgeBakeCommandlet::Main(const FString& Params)
+{
+    FString MapList, VolumeList, ReportPath, ShardRoot;
+    FParse::Value(*Params, TEXT("Maps="), MapList, /*bShouldStopOnSeparator*/false);
+    FParse::Value(*Params, TEXT("Volumes="), VolumeList, false);
+    if (!FParse::Value(*Params, TEXT("Report="), ReportPath))
+        ReportPath = FPaths::ProjectSavedDir() / TEXT("ThermoForge/BakeReport.json");
+    if (!FParse::Value(*Params, TEXT("ShardDir="), ShardRoot))
+        ShardRoot = FPaths::ProjectSavedDir() / TEXT("ThermoForge/Shards");
+    bool bSaveMap = !FParse::Param(*Params, TEXT("NoSaveMap"));
+
+    TArray<FString> Maps;
+    MapList.ParseIntoArray(Maps, TEXT(","), /*CullEmpty*/true);
+    if (Maps.Num() == 0)
+    {
+        UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBake: no maps given (-Maps=/Game/Maps/A,/Game/Maps/B)"));
+        return 1;
+    }
+
+    FThermoForgeBakeOptions Options;
+    VolumeList.ParseIntoArray(Options.VolumeNames, TEXT(","), true);
+    Options.bSaveAssets   = true;
+    Options.bBuildPreview = false; // nothing to look at, and -nullrhi has no renderer
+    Options.bParallel     = !FParse::Param(*Params, TEXT("NoParallelBake"));
+
+    // Sharding: -Shards=N with -ShardIndex=i bakes one slab, -Merge stitches, -SpawnWorkers does both locally
+    int32 NumShards = 1, ShardIndex = -1;
+    FParse::Value(*Params, TEXT("Shards="), NumShards);
+    FParse::Value(*Params, TEXT("ShardIndex="), ShardIndex);
+    NumShards = FMath::Max(1, NumShards);
+
+    const bool bSpawn = NumShards > 1 && FParse::Param(*Params, TEXT("SpawnWorkers"));
+    const bool bMerge = FParse::Param(*Params, TEXT("Merge"));
+    const bool bWorker = NumShards > 1 && !bSpawn && !bMerge;
+    if (bWorker && (ShardIndex < 0 || ShardIndex >= NumShards))
+    {
+        UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBake: -Shards=%d needs -ShardIndex=0..%d, -Merge or -SpawnWorkers"), NumShards, NumShards - 1);
+        return 1;
+    }
+    if (bWorker)
+    {
+        Options.NumShards  = NumShards;
+        Options.ShardIndex = ShardIndex;
+        bSaveMap = false; // workers only write shard files
+    }
+
+    int32 Failures = 0;
+    TArray<FThermoForgeBakeReport> Reports;
+    for (const FString& Map : Maps)
+    {
+        Options.ShardDir = ShardRoot / FPackageName::GetShortName(Map);
+
+        // Workers bake against their own copy of the map; the coordinator only loads it afterwards to merge
+        if (bSpawn && !RunShardWorkers(Map, Options, NumShards, Params))
+        {
+            ++Failures;
+            continue;
+        }
+
+        UWorld* World = LoadWorld(Map);
+        if (!World)
+        {
+            UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBake: failed to load %s"), *Map);
+            ++Failures;
+            continue;
+        }
+
+        {
+            // World Partition: the bake traces against everything in reach (and a merge needs every volume), so load all actors
+            TUniquePtr<FLoaderAdapterShape> Loader;
+            if (UWorldPartition* WP = World->GetWorldPartition())
+            {
+                Loader = MakeUnique<FLoaderAdapterShape>(World, WP->GetEditorWorldBounds(), TEXT("ThermoForge Bake"));
+                Loader->Load();
+            }
+
+            FThermoForgeBakeReport& Report = Reports.AddDefaulted_GetRef();
+            if (UThermoForgeSubsystem* Sub = World->GetSubsystem<UThermoForgeSubsystem>())
+            {
+                if (bSpawn || bMerge)
+                    Sub->MergeBakeShards(Options, Report);
+                else
+                    Sub->RunBake(Options, Report);
+            }
+            Report.MapName = Map;
+
+            if (bSaveMap)
+                SaveBakedVolumes(World);
+        }
+
+        UnloadWorld(World);
+    }
+
+    if (!WriteReport(ReportPath, Reports))
+        ++Failures;
+
+    return Failures > 0 ? 1 : 0;
+}
+
+bool UThermoForgeBakeCommandlet::RunShardWorkers(const FString& Map, const FThermoForgeBakeOptions& Options, int32 NumShards,
+    const FString& Params) const
+{
+    // Start from an empty shard folder so a merge never picks up slabs from an older grid
+    IFileManager::Get().DeleteDirectory(*Options.ShardDir, /*RequireExists*/false, /*Tree*/true);
+    IFileManager::Get().MakeDirectory(*Options.ShardDir, true);
+
+    // More workers than cores: one bake thread each, the processes already fill the machine
+    const bool bSingleThreaded = NumShards >= FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+
+    FString Volumes;
+    if (Options.VolumeNames.Num() > 0)
+        Volumes = FString::Printf(TEXT(" -Volumes=\"%s\""), *FString::Join(Options.VolumeNames, TEXT(",")));
+
+    const FString Exe = FPlatformProcess::ExecutablePath();
+    const FString Project = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+
+    TArray<FProcHandle> Workers;
+    for (int32 i = 0; i < NumShards; ++i)
+    {
+        const FString Args = FString::Printf(
+            TEXT("\"%s\" -run=ThermoForgeBake -Maps=\"%s\"%s -Shards=%d -ShardIndex=%d -ShardDir=\"%s\" -Report=\"%s\"%s -nullrhi -unattended -nosplash -nop4 -stdout"),
+            *Project, *Map, *Volumes, NumShards, i, *FPaths::GetPath(Options.ShardDir),
+            *(Options.ShardDir / FString::Printf(TEXT("Report.%d.json"), i)),
+            bSingleThreaded || FParse::Param(*Params, TEXT("NoParallelBake")) ? TEXT(" -NoParallelBake") : TEXT(""));
+
+        FProcHandle Proc = FPlatformProcess::CreateProc(*Exe, *Args, /*bLaunchDetached*/false, /*bLaunchHidden*/true,
+                                                        /*bLaunchReallyHidden*/true, nullptr, 0, nullptr, nullptr);
+        if (!Proc.IsValid())
+        {
+            UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBake: could not start shard worker %d for %s"), i, *Map);
+            for (FProcHandle& W : Workers) { FPlatformProcess::TerminateProc(W); FPlatformProcess::CloseProc(W); }
+            return false;
+        }
+        Workers.Add(Proc);
+    }
+
+    UE_LOG(LogThermoForge, Display, TEXT("ThermoForgeBake: %s running on %d worker processes"), *Map, NumShards);
+
+    bool bOk = true;
+    for (int32 i = 0; i < Workers.Num(); ++i)
+    {
+        FPlatformProcess::WaitForProc(Workers[i]);
+        int32 Code = 0;
+        FPlatformProcess::GetProcReturnCode(Workers[i], &Code);
+        FPlatformProcess::CloseProc(Workers[i]);
+        if (Code != 0)
+        {
+            UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBake: shard worker %d for %s exited with %d"), i, *Map, Code);
+            bOk = false;
+        }
+    }
+    return bOk;
+}
+
+UWorld* UThermoForgeBakeCommandlet::LoadWorld(const FString& MapName)
+{
+    FString PackageName = MapName;
+    if (!FPackageName::IsValidLongPackageName(PackageName) &&
+        !FPackageName::SearchForPackageOnDisk(MapName, &PackageName))
+    {
+        return nullptr;
+    }
+
+    UPackage* Pkg = LoadPackage(nullptr, *PackageName, LOAD_None);
+    UWorld* World = Pkg ? UWorld::FindWorldInPackage(Pkg) : nullptr;
+    if (!World) return nullptr;
+
+    World->WorldType = EWorldType::Editor;
+    World->AddToRoot();
+    if (!World->bIsWorldInitialized)
+    {
+        UWorld::InitializationValues IVS;
+        IVS.RequiresHitProxies(false)
+           .ShouldSimulatePhysics(false)
+           .EnableTraceCollision(true)
+           .CreateNavigation(false)
+           .CreateAISystem(false)
+           .AllowAudioPlayback(false)
+           .CreatePhysicsScene(true);
+        World->InitWorld(IVS);
+    }
+    World->PersistentLevel->UpdateModelComponents();
+    World->UpdateWorldComponents(/*bRerunConstructionScripts*/true, /*bCurrentLevelOnly*/false);
+
+    if (GEditor)
+        GEditor->GetEditorWorldContext().SetCurrentWorld(World);
+    GWorld = World;
+    return World;
+}
+
+void UThermoForgeBakeCommandlet::UnloadWorld(UWorld* World)
+{
+    if (!World) return;
+
+    if (GEditor)
+        GEditor->GetEditorWorldContext().SetCurrentWorld(nullptr);
+    GWorld = nullptr;
+
+    World->ClearWorldComponents();
+    World->CleanupWorld();
+    World->RemoveFromRoot();
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void UThermoForgeBakeCommandlet::SaveBakedVolumes(UWorld* World)
+{
+    // Volumes now reference new field assets and streamed volumes spawned / removed chunk actors. With World Partition
+    // each actor lives in its own package (deleted ones included), so save every dirty map package of this world.
+    if (!UEditorLoadingAndSavingUtils::SaveDirtyPackages(/*bSaveMapPackages*/true, /*bSaveContentPackages*/false))
+        UE_LOG(LogThermoForge, Warning, TEXT("ThermoForgeBake: some map packages of %s failed to save"), *World->GetName());
+}
+
+bool UThermoForgeBakeCommandlet::WriteReport(const FString& Path, const TArray<FThermoForgeBakeReport>& Reports) const
+{
+    TArray<TSharedPtr<FJsonValue>> MapValues;
+    for (const FThermoForgeBakeReport& R : Reports)
+    {
+        TArray<TSharedPtr<FJsonValue>> VolumeValues;
+        for (const FThermoForgeBakeVolumeStats& V : R.Volumes)
+        {
+            TSharedRef<FJsonObject> Vol = MakeShared<FJsonObject>();
+            Vol->SetStringField(TEXT("volume"), V.VolumeName);
+            Vol->SetStringField(TEXT("asset"),  V.AssetPath);
+            TArray<TSharedPtr<FJsonValue>> Dim;
+            Dim.Add(MakeShared<FJsonValueNumber>(V.Dim.X));
+            Dim.Add(MakeShared<FJsonValueNumber>(V.Dim.Y));
+            Dim.Add(MakeShared<FJsonValueNumber>(V.Dim.Z));
+            Vol->SetArrayField (TEXT("dim"), Dim);
+            Vol->SetNumberField(TEXT("cells"),        (double)V.NumCells);
+            Vol->SetNumberField(TEXT("traces"),       (double)V.NumTraces);
+            Vol->SetNumberField(TEXT("open_bricks"),  V.OpenBricks);
+            Vol->SetNumberField(TEXT("solid_bricks"), V.SolidBricks);
+            Vol->SetNumberField(TEXT("seconds"),      V.Seconds);
+            VolumeValues.Add(MakeShared<FJsonValueObject>(Vol));
+        }
+
+        TSharedRef<FJsonObject> Map = MakeShared<FJsonObject>();
+        Map->SetStringField(TEXT("map"),     R.MapName);
+        Map->SetNumberField(TEXT("cells"),   (double)R.TotalCells);
+        Map->SetNumberField(TEXT("traces"),  (double)R.TotalTraces);
+        Map->SetNumberField(TEXT("seconds"), R.TotalSeconds);
+        Map->SetArrayField (TEXT("volumes"), VolumeValues);
+        MapValues.Add(MakeShared<FJsonValueObject>(Map));
+    }
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetArrayField(TEXT("maps"), MapValues);
+
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    FJsonSerializer::Serialize(Root, Writer);
+
+    const bool bOk = FFileHelper::SaveStringToFile(Json, *Path);
+    UE_LOG(LogThermoForge, Log, TEXT("ThermoForgeBake report %s : %s"), *Path, bOk ? TEXT("Saved") : TEXT("FAILED"));
+    return bOk;
+}
@@ -0,0 +1,298 @@
+﻿#include "ThermoForgeBenchmarkCommandlet.h"
+
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeSourceComponent.h"
+#include "ThermoForgeStats.h"
+#include "ThermoForgeSubsystem.h"
+#include "ThermoForgeVolume.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+UThermoForgeBenchmarkCommandlet::UThermoForgeBenchmarkCommandlet()
+{
+    IsClient        = false;
+    IsServer        = false;
+    IsEditor        = true;
+    LogToConsole    = true;
+    ShowErrorCount  = true;
+}
+
+void UThermoForgeBenchmarkCommandlet::FConfig::Parse(const TCHAR* Params)
+{
+    FParse::Value(Params, TEXT("Cells="),     Cells);
+    FParse::Value(Params, TEXT("Sources="),   NumSources);
+    FParse::Value(Params, TEXT("Queries="),   NumQueries);
+    FParse::Value(Params, TEXT("BakeCells="), BakeCells);
+    FParse::Value(Params, TEXT("Obstacles="), NumObstacles);
+    FParse::Value(Params, TEXT("Seed="),      Seed);
+    Cells        = FMath::Clamp(Cells, 2, 512);
+    BakeCells    = FMath::Clamp(BakeCells, 0, 256);
+    NumSources   = FMath::Max(0, NumSources);
+    NumQueries   = FMath::Max(0, NumQueries);
+    NumObstacles = FMath::Max(0, NumObstacles);
+}
+
+int32 UThermoForgeBenchmarkCommandlet::Main(const FString& Params)
+{
+    FConfig Config;
+    Config.Parse(*Params);
+
+    FString Label, OutPath;
+    if (!FParse::Value(*Params, TEXT("Label="), Label))
+        Label = TEXT("local");
+    if (!FParse::Value(*Params, TEXT("Out="), OutPath))
+        OutPath = FPaths::ProjectSavedDir() / TEXT("ThermoForge/Benchmark.json");
+
+    TArray<FResult> Results;
+    if (!RunSuite(Config, Results))
+        return 1;
+
+    for (const FResult& R : Results)
+    {
+        UE_LOG(LogThermoForge, Display, TEXT("ThermoForgeBenchmark: %-28s %10lld ops %9.2f ms %10.1f ns/op %12.0f ops/s"),
+               *R.Name, R.Iterations, R.Seconds * 1000.0, R.NsPerOp(), R.OpsPerSec());
+    }
+
+    return WriteResults(OutPath, Label, Config, Results) ? 0 : 1;
+}
+
+bool UThermoForgeBenchmarkCommandlet::RunSuite(const FConfig& Config, TArray<FResult>& OutResults)
+{
+    OutResults.Reset();
+
+    UWorld* World = UWorld::CreateWorld(EWorldType::Editor, /*bInformEngineOfWorld*/true, TEXT("ThermoForgeBenchmark"));
+    UThermoForgeSubsystem* Sub = World ? World->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!Sub)
+    {
+        UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBenchmark: could not create the benchmark world"));
+        return false;
+    }
+
+    UThermoForgeFieldAsset* Field = BuildScene(World, Config);
+
+    // Same points for every benchmark and every run
+    const float HalfCm = Config.Cells * 50.f;
+    FRandomStream Rand(Config.Seed + 1);
+    TArray<FVector> Points;
+    Points.SetNumUninitialized(Config.NumQueries);
+    for (FVector& P : Points)
+        P = FVector(Rand.FRandRange(-HalfCm, HalfCm), Rand.FRandRange(-HalfCm, HalfCm), Rand.FRandRange(-HalfCm, HalfCm));
+
+    double Sink = 0.0; // keeps the optimizer from dropping the timed calls
+
+    auto Time = [&OutResults](const TCHAR* Name, int64 Iterations, TFunctionRef<void()> Body)
+    {
+        const double Start = FPlatformTime::Seconds();
+        Body();
+        FResult& R = OutResults.AddDefaulted_GetRef();
+        R.Name       = Name;
+        R.Iterations = Iterations;
+        R.Seconds    = FPlatformTime::Seconds() - Start;
+    };
+
+    if (Points.Num() > 0)
+    {
+        Time(TEXT("ComputeCurrentTemperatureAt"), Points.Num(), [&]()
+        {
+            for (const FVector& P : Points)
+                Sink += Sub->ComputeCurrentTemperatureAt(P, /*bWinter*/false, 12.f, 0.3f);
+        });
+
+        const FDateTime QueryTime(2025, 6, 21, 12, 0, 0);
+        Time(TEXT("QueryNearestBakedGridPoint"), Points.Num(), [&]()
+        {
+            for (const FVector& P : Points)
+                Sink += Sub->QueryNearestBakedGridPoint(P, QueryTime).CurrentTempC;
+        });
+
+        Time(TEXT("SampleSkyView01"), Points.Num(), [&]()
+        {
+            for (const FVector& P : Points)
+                Sink += Field->SampleSkyView01(P);
+        });
+    }
+
+    // Bake: a separate BakeCells^3 volume through the obstacles, current project settings
+    if (Config.BakeCells > 0)
+    {
+        AThermoForgeVolume* BakeVol = World->SpawnActorDeferred<AThermoForgeVolume>(AThermoForgeVolume::StaticClass(), FTransform::Identity);
+        BakeVol->bUseGlobalGrid = false;
+        BakeVol->GridCellSize   = 100.f;
+        BakeVol->GridOriginMode = EThermoGridOriginMode::ActorOrigin;
+        BakeVol->BoxExtent      = FVector(Config.BakeCells * 50.f);
+        BakeVol->FinishSpawning(FTransform::Identity);
+
+        FThermoForgeBakeOptions Options;
+        Options.bSaveAssets   = false;
+        Options.bBuildPreview = false;
+
+        FThermoForgeBakedField Baked;
+        FThermoForgeBakeVolumeStats BakeStats;
+        bool bBaked = false;
+        Time(TEXT("BakeCells"), 0, [&]() { bBaked = Sub->BakeVolume(BakeVol, Options, Baked, BakeStats); });
+        if (bBaked)
+        {
+            OutResults.Last().Iterations = BakeStats.NumCells;
+
+            FResult& Traces = OutResults.AddDefaulted_GetRef();
+            Traces.Name       = TEXT("BakeTraces");
+            Traces.Iterations = BakeStats.NumTraces;
+            Traces.Seconds    = OutResults[OutResults.Num() - 2].Seconds;
+        }
+        else
+        {
+            UE_LOG(LogThermoForge, Warning, TEXT("ThermoForgeBenchmark: bake volume produced no cells"));
+        }
+    }
+    UE_LOG(LogThermoForge, Verbose, TEXT("ThermoForgeBenchmark: checksum %f"), Sink);
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(/*bInformEngineOfWorld*/false);
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    return true;
+}
+
+UThermoForgeFieldAsset* UThermoForgeBenchmarkCommandlet::BuildScene(UWorld* World, const FConfig& Config)
+{
+    const int32 Cells = Config.Cells;
+    FRandomStream Rand(Config.Seed);
+    const float HalfCm = Cells * 50.f;
+
+    // Box obstacles (engine cube, 100 cm) so bake traces hit real geometry
+    UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+    for (int32 i = 0; i < Config.NumObstacles && Cube; ++i)
+    {
+        const FVector Loc(Rand.FRandRange(-HalfCm, HalfCm), Rand.FRandRange(-HalfCm, HalfCm), Rand.FRandRange(-HalfCm, HalfCm));
+        AStaticMeshActor* Obstacle = World->SpawnActor<AStaticMeshActor>(Loc, FRotator(0.f, Rand.FRandRange(0.f, 90.f), 0.f));
+        UStaticMeshComponent* Mesh = Obstacle->GetStaticMeshComponent();
+        Mesh->SetMobility(EComponentMobility::Movable);
+        Mesh->SetStaticMesh(Cube);
+        Obstacle->SetActorScale3D(FVector(Rand.FRandRange(1.f, 8.f), Rand.FRandRange(1.f, 8.f), Rand.FRandRange(1.f, 4.f)));
+    }
+
+    // Point sources; OnRegister hands them to the subsystem
+    for (int32 i = 0; i < Config.NumSources; ++i)
+    {
+        const FVector Loc(Rand.FRandRange(-HalfCm, HalfCm), Rand.FRandRange(-HalfCm, HalfCm), Rand.FRandRange(-HalfCm, HalfCm));
+        AActor* Owner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Loc));
+
+        USceneComponent* Root = NewObject<USceneComponent>(Owner, TEXT("Root"));
+        Owner->SetRootComponent(Root);
+        Root->RegisterComponent();
+        Owner->SetActorLocation(Loc);
+
+        UThermoForgeSourceComponent* Source = NewObject<UThermoForgeSourceComponent>(Owner, TEXT("ThermoSource"));
+        Source->IntensityCelsius = Rand.FRandRange(-40.f, 80.f);
+        Source->RadiusCm         = Rand.FRandRange(300.f, 1500.f);
+        Source->SetupAttachment(Root);
+        Source->RegisterComponent();
+    }
+
+    // Query volume with a seeded synthetic field, so queries do not depend on bake quality
+    AThermoForgeVolume* QueryVol = World->SpawnActorDeferred<AThermoForgeVolume>(AThermoForgeVolume::StaticClass(), FTransform::Identity);
+    QueryVol->bUseGlobalGrid = false;
+    QueryVol->GridCellSize   = 100.f;
+    QueryVol->GridOriginMode = EThermoGridOriginMode::ActorOrigin;
+    QueryVol->BoxExtent      = FVector(HalfCm);
+    QueryVol->FinishSpawning(FTransform::Identity);
+
+    UThermoForgeFieldAsset* Field = NewObject<UThermoForgeFieldAsset>(GetTransientPackage());
+    Field->Dim        = FIntVector(Cells);
+    Field->CellSizeCm = 100.f;
+    Field->OriginWS   = FVector(-HalfCm);
+
+    const int32 N = Cells * Cells * Cells;
+    Field->SkyView01.SetNumUninitialized(N);
+    Field->WallPermeability01.SetNumUninitialized(N);
+    Field->Indoorness01.SetNumUninitialized(N);
+    for (int32 i = 0; i < N; ++i)
+    {
+        const float Sky  = Rand.FRand();
+        const float Wall = Rand.FRand();
+        Field->SkyView01[i]          = Sky;
+        Field->WallPermeability01[i] = Wall;
+        Field->Indoorness01[i]       = (1.f - Sky) * (1.f - Wall);
+    }
+    Field->InvalidateDerivedData();
+
+    QueryVol->BakedField = Field;
+    return Field;
+}
+
+bool UThermoForgeBenchmarkCommandlet::WriteResults(const FString& Path, const FString& Label, const FConfig& Config,
+    const TArray<FResult>& Results)
+{
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+
+    bool bOk = false;
+    if (FPaths::GetExtension(Path).Equals(TEXT("csv"), ESearchCase::IgnoreCase))
+    {
+        // Append so successive runs (commits, platforms) build one table
+        const FString Timestamp = FDateTime::UtcNow().ToIso8601();
+        FString Rows;
+        if (!IFileManager::Get().FileExists(*Path))
+            Rows += TEXT("label,timestamp,platform,benchmark,iterations,total_ms,ns_per_op,ops_per_sec\n");
+        for (const FResult& R : Results)
+        {
+            Rows += FString::Printf(TEXT("%s,%s,%s,%s,%lld,%.3f,%.2f,%.1f\n"), *Label, *Timestamp,
+                                    ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()), *R.Name, R.Iterations,
+                                    R.Seconds * 1000.0, R.NsPerOp(), R.OpsPerSec());
+        }
+        bOk = FFileHelper::SaveStringToFile(Rows, *Path, FFileHelper::EEncodingOptions::AutoDetect,
+                                            &IFileManager::Get(), FILEWRITE_Append);
+    }
+    else
+    {
+        TSharedRef<FJsonObject> ConfigObj = MakeShared<FJsonObject>();
+        ConfigObj->SetNumberField(TEXT("cells"),      Config.Cells);
+        ConfigObj->SetNumberField(TEXT("sources"),    Config.NumSources);
+        ConfigObj->SetNumberField(TEXT("queries"),    Config.NumQueries);
+        ConfigObj->SetNumberField(TEXT("bake_cells"), Config.BakeCells);
+        ConfigObj->SetNumberField(TEXT("obstacles"),  Config.NumObstacles);
+        ConfigObj->SetNumberField(TEXT("seed"),       Config.Seed);
+
+        TArray<TSharedPtr<FJsonValue>> ResultValues;
+        for (const FResult& R : Results)
+        {
+            TSharedRef<FJsonObject> Obj = MakeShared<FJsonObject>();
+            Obj->SetStringField(TEXT("name"),        R.Name);
+            Obj->SetNumberField(TEXT("iterations"),  (double)R.Iterations);
+            Obj->SetNumberField(TEXT("total_ms"),    R.Seconds * 1000.0);
+            Obj->SetNumberField(TEXT("ns_per_op"),   R.NsPerOp());
+            Obj->SetNumberField(TEXT("ops_per_sec"), R.OpsPerSec());
+            ResultValues.Add(MakeShared<FJsonValueObject>(Obj));
+        }
+
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("label"),     Label);
+        Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+        Root->SetStringField(TEXT("platform"),  ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+        Root->SetNumberField(TEXT("cores"),     FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+        Root->SetObjectField(TEXT("config"),    ConfigObj);
+        Root->SetArrayField (TEXT("results"),   ResultValues);
+
+        FString Json;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+        FJsonSerializer::Serialize(Root, Writer);
+        bOk = FFileHelper::SaveStringToFile(Json, *Path);
+    }
+
+    if (bOk)
+        UE_LOG(LogThermoForge, Display, TEXT("ThermoForgeBenchmark: results written to %s"), *Path);
+    else
+        UE_LOG(LogThermoForge, Error, TEXT("ThermoForgeBenchmark: could not write %s"), *Path);
+    return bOk;
+}
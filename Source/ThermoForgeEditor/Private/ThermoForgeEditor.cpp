@@ -25,6 +25,7 @@
 #include "ThermoForgeVolume.h"
 #include "ThermoForgeSourceComponent.h"
 #include "ThermoForgeSubsystem.h"
+#include "ThermoForgeStats.h"
 #include "ThermoForgeVolumeCustomization.h"
 
 #include "Components/StaticMeshComponent.h"
@@ -253,7 +254,7 @@ void FThermoForgeEditorModule::RegisterMenus()
 
 FReply FThermoForgeEditorModule::OnSpawnThermalVolumeClicked()
 {
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Spawn Thermal Volume"));
+    UE_LOG(LogThermoForge, Log, TEXT("Spawn Thermal Volume"));
     SpawnThermalVolume();
     return FReply::Handled();
 }
@@ -309,7 +310,7 @@ FReply FThermoForgeEditorModule::OnAddHeatSourceClicked()
     USelection* Sel = GEditor->GetSelectedActors();
     if (!Sel || Sel->Num() == 0)
     {
-        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] No actor selected."));
+        UE_LOG(LogThermoForge, Warning, TEXT("No actor selected."));
         return FReply::Handled();
     }
 
@@ -341,7 +342,7 @@ FReply FThermoForgeEditorModule::OnAddHeatSourceClicked()
         ++AddedCount;
     }
 
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Added ThermoForgeSourceComponent to %d actor(s)."), AddedCount);
+    UE_LOG(LogThermoForge, Log, TEXT("Added ThermoForgeSourceComponent to %d actor(s)."), AddedCount);
     GEditor->NoteSelectionChange();
 
     return FReply::Handled();
@@ -354,18 +355,18 @@ FReply FThermoForgeEditorModule::OnKickstartSamplingClicked()
     UWorld* World = GEditor->GetEditorWorldContext().World();
     if (!World)
     {
-        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] No editor world available."));
+        UE_LOG(LogThermoForge, Warning, TEXT("No editor world available."));
         return FReply::Handled();
     }
 
     if (UThermoForgeSubsystem* Sub = World->GetSubsystem<UThermoForgeSubsystem>())
     {
         Sub->KickstartSamplingFromVolumes(); // stub for now
-        UE_LOG(LogTemp, Log, TEXT("[ThermoForge] KickstartSamplingFromVolumes() called."));
+        UE_LOG(LogThermoForge, Log, TEXT("KickstartSamplingFromVolumes() called."));
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] ThermoForgeSubsystem not found on this world."));
+        UE_LOG(LogThermoForge, Warning, TEXT("ThermoForgeSubsystem not found on this world."));
     }
 
     return FReply::Handled();
@@ -385,14 +386,12 @@ FReply FThermoForgeEditorModule::OnShowAllPreviewsClicked()
         AThermoForgeVolume* Vol = *It;
         if (Vol)
         {
-#if WITH_EDITORONLY_DATA
-            Vol->GridPreviewISM->SetVisibility(true);
-#endif
+            Vol->SetPreviewVisibility(true);
             ++Hidden;
         }
     }
 
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] HideAllPreviews: %d volumes updated."), Hidden);
+    UE_LOG(LogThermoForge, Log, TEXT("HideAllPreviews: %d volumes updated."), Hidden);
     return FReply::Handled();
 }
 
@@ -409,14 +408,12 @@ FReply FThermoForgeEditorModule::OnHideAllPreviewsClicked()
         AThermoForgeVolume* Vol = *It;
         if (Vol)
         {
-        #if WITH_EDITORONLY_DATA
-            Vol->GridPreviewISM->SetVisibility(false);
-        #endif
+            Vol->SetPreviewVisibility(false);
             ++Hidden;
         }
     }
 
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] HideAllPreviews: %d volumes updated."), Hidden);
+    UE_LOG(LogThermoForge, Log, TEXT("HideAllPreviews: %d volumes updated."), Hidden);
     return FReply::Handled();
 }
 
@@ -434,7 +431,7 @@ FReply FThermoForgeEditorModule::OnSetMeshInsulatedClicked()
 
     if (!PhysMat)
     {
-        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Failed to load ThermoForgeInsulator_M physical material."));
+        UE_LOG(LogThermoForge, Warning, TEXT("Failed to load ThermoForgeInsulator_M physical material."));
         return FReply::Handled();
     }
 
@@ -456,7 +453,7 @@ FReply FThermoForgeEditorModule::OnSetMeshInsulatedClicked()
         }
     }
 
-    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] SetMeshInsulated applied to %d mesh components."), Count);
+    UE_LOG(LogThermoForge, Log, TEXT("SetMeshInsulated applied to %d mesh components."), Count);
     return FReply::Handled();
 }
 FReply FThermoForgeEditorModule::OnOpenSettingsClicked()
@@ -83,9 +83,7 @@ void FThermoForgeVolumeCustomization::CustomizeDetails(IDetailLayoutBuilder& Det
                 {
                     if (AThermoForgeVolume* Vol = Cast<AThermoForgeVolume>(Obj.Get()))
                     {
-                    #if WITH_EDITORONLY_DATA
-                        Vol->GridPreviewISM->SetVisibility(true);
-                    #endif
+                        Vol->SetPreviewVisibility(true);
                         Vol->BuildHeatPreviewFromField();
                     }
                 }
@@ -175,6 +173,25 @@ void FThermoForgeVolumeCustomization::CustomizeDetails(IDetailLayoutBuilder& Det
     GridCat.AddProperty(Gap);
     GridCat.AddProperty(MaxI);
 
+    // Field streaming (World Partition chunks)
+    auto StreamWP  = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bStreamWithWorldPartition));
+    auto ChunkSize = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, FieldChunkSizeCm));
+    GridCat.AddProperty(StreamWP);
+    GridCat.AddProperty(ChunkSize);
+
+    // --- Climate Override ---
+    IDetailCategoryBuilder& ClimateCat = Detail.EditCategory(
+        TEXT("Thermo Forge Climate"),
+        LOCTEXT("ThermoForgeClimateCat","Thermo Forge - Climate"),
+        ECategoryPriority::Default
+    );
+    auto Profile   = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, ClimateProfile));
+    auto BlendDist = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, ClimateBlendDistanceCm));
+    auto BlendVert = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bClimateBlendVertical));
+    ClimateCat.AddProperty(Profile);
+    ClimateCat.AddProperty(BlendDist);
+    ClimateCat.AddProperty(BlendVert);
+
 #if WITH_EDITORONLY_DATA
     // --- Preview Settings ---
     IDetailCategoryBuilder& PrevCat = Detail.EditCategory(
@@ -184,8 +201,30 @@ void FThermoForgeVolumeCustomization::CustomizeDetails(IDetailLayoutBuilder& Det
     );
     auto AutoPrev  = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bAutoRebuildPreview));
     auto Mat       = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, GridPreviewMaterial));
+    auto Culling   = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewCulling));
+    auto CamRadius = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewCameraRadiusCm));
+    auto SliceAxis = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewSliceAxis));
+    auto SliceOff  = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewSliceOffsetCm));
+    auto UseLOD    = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bPreviewUseLOD));
+    auto LODDist   = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewLODDistanceCm));
+    auto MaxLOD    = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, PreviewMaxLOD));
+    auto UseHISM   = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUseHierarchicalPreview));
+    auto UseTex    = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, bUseVolumeTexturePreview));
+    auto TexMat    = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, VolumeTexturePreviewMaterial));
+    auto TexFmt    = Detail.GetProperty(GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, FieldTextureFormat));
     PrevCat.AddProperty(AutoPrev);
     PrevCat.AddProperty(Mat);
+    PrevCat.AddProperty(Culling);
+    PrevCat.AddProperty(CamRadius);
+    PrevCat.AddProperty(SliceAxis);
+    PrevCat.AddProperty(SliceOff);
+    PrevCat.AddProperty(UseLOD);
+    PrevCat.AddProperty(LODDist);
+    PrevCat.AddProperty(MaxLOD);
+    PrevCat.AddProperty(UseHISM);
+    PrevCat.AddProperty(UseTex);
+    PrevCat.AddProperty(TexMat);
+    PrevCat.AddProperty(TexFmt);
 #endif
 }
 
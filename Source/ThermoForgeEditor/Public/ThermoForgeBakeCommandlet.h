@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ThermoForgeBakeCommandlet.generated.h"
+
+class UWorld;
+struct FThermoForgeBakeOptions;
+struct FThermoForgeBakeReport;
+
+/**
+ * Headless bake for build machines.
+ *
+ *   UnrealEditor-Cmd <Project>.uproject -run=ThermoForgeBake -Maps=/Game/Maps/A,/Game/Maps/B
+ *       [-Volumes=NameOrLabel,...] [-Report=<path.json>] [-NoSaveMap] -nullrhi -unattended
+ *
+ * Loads each map (all World Partition actors inside the editor world bounds), runs the bake,
+ * saves the field assets plus the volumes that reference them, and writes a JSON report with
+ * per-volume cell count, trace count and time. Returns non-zero if a map fails to load.
+ *
+ * Sharding splits every volume into N z-slabs baked by separate processes:
+ *   -Shards=N -ShardIndex=i   bake slab i only and write it to -ShardDir=<dir> (default Saved/ThermoForge/Shards)
+ *   -Shards=N -Merge          stitch the slabs into field assets
+ *   -Shards=N -SpawnWorkers   start N local workers, wait, then merge
+ * -NoParallelBake keeps each process on one bake thread.
+ */
+UCLASS()
+class THERMOFORGEEDITOR_API UThermoForgeBakeCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeBakeCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    UWorld* LoadWorld(const FString& MapName);
+    void    UnloadWorld(UWorld* World);
+    bool    RunShardWorkers(const FString& Map, const FThermoForgeBakeOptions& Options, int32 NumShards, const FString& Params) const;
+    void    SaveBakedVolumes(UWorld* World);
+    bool    WriteReport(const FString& Path, const TArray<FThermoForgeBakeReport>& Reports) const;
+};
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ThermoForgeBenchmarkCommandlet.generated.h"
+
+class UWorld;
+class UThermoForgeFieldAsset;
+
+/**
+ * Synthetic performance benchmark, headless (-nullrhi) on any platform.
+ *
+ *   UnrealEditor-Cmd <Project>.uproject -run=ThermoForgeBenchmark -nullrhi -unattended
+ *       [-Cells=64] [-Sources=16] [-Queries=20000] [-BakeCells=24] [-Obstacles=48] [-Seed=1337]
+ *       [-Label=<commit>] [-Out=<path.json|path.csv>]
+ *
+ * Builds a transient world with a Cells^3 synthetic field, N heat sources and random box obstacles, then times
+ * ComputeCurrentTemperatureAt, QueryNearestBakedGridPoint, SampleSkyView01 and a BakeCells^3 bake with the current
+ * project settings. Inputs are seeded, so runs on different commits measure the same work.
+ * JSON is written per run; CSV appends one row per benchmark so runs accumulate into one table.
+ * The same suite runs as automation tests (ThermoForge.Benchmark.*), sized by the same command-line switches.
+ */
+UCLASS()
+class THERMOFORGEEDITOR_API UThermoForgeBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UThermoForgeBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+    /** Scene size and workload. NumQueries = 0 skips the query benchmarks, BakeCells = 0 the bake. */
+    struct FConfig
+    {
+        int32 Cells        = 64;
+        int32 NumSources   = 16;
+        int32 NumQueries   = 20000;
+        int32 BakeCells    = 24;
+        int32 NumObstacles = 48;
+        int32 Seed         = 1337;
+
+        /** Reads -Cells= -Sources= -Queries= -BakeCells= -Obstacles= -Seed= over the defaults. */
+        void Parse(const TCHAR* Params);
+    };
+
+    struct FResult
+    {
+        FString Name;
+        int64   Iterations = 0;
+        double  Seconds = 0.0;
+        double  NsPerOp() const   { return Iterations > 0 ? Seconds * 1e9 / Iterations : 0.0; }
+        double  OpsPerSec() const { return Seconds > 0.0 ? Iterations / Seconds : 0.0; }
+    };
+
+    /** Times the suite in a fresh transient world and destroys it again. False if the world could not be created. */
+    static bool RunSuite(const FConfig& Config, TArray<FResult>& OutResults);
+
+    /** JSON (one run) or CSV (appended rows) by extension. */
+    static bool WriteResults(const FString& Path, const FString& Label, const FConfig& Config, const TArray<FResult>& Results);
+
+private:
+    /** Obstacles, sources and a query volume holding a seeded Cells^3 field; returns that field. */
+    static UThermoForgeFieldAsset* BuildScene(UWorld* World, const FConfig& Config);
+};
@@ -31,6 +31,7 @@ public class ThermoForgeEditor : ModuleRules
                 "UMG",
                 "UMGEditor", 
                 "BSPUtils",
+                "Json",
                 "ThermoForge"
             }
         );